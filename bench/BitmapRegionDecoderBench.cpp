@@ -13,12 +13,13 @@
 #include "src/core/SkOSFile.h"
 
 BitmapRegionDecoderBench::BitmapRegionDecoderBench(const char* baseName, SkData* encoded,
-        SkColorType colorType, uint32_t sampleSize, const SkIRect& subset)
+        SkColorType colorType, uint32_t sampleSize, const SkIRect& subset, bool indexed)
     : fBRD(nullptr)
     , fData(SkRef(encoded))
     , fColorType(colorType)
     , fSampleSize(sampleSize)
     , fSubset(subset)
+    , fIndexed(indexed)
 {
     // Choose a useful name for the color type
     const char* colorName = color_type_to_str(colorType);
@@ -27,6 +28,9 @@ BitmapRegionDecoderBench::BitmapRegionDecoderBench(const char* baseName, SkData*
     if (1 != sampleSize) {
         fName.appendf("_%.3f", 1.0f / (float) sampleSize);
     }
+    if (indexed) {
+        fName.append("_indexed");
+    }
 }
 
 const char* BitmapRegionDecoderBench::onGetName() {
@@ -39,6 +43,9 @@ bool BitmapRegionDecoderBench::isSuitableFor(Backend backend) {
 
 void BitmapRegionDecoderBench::onDelayedSetup() {
     fBRD = android::skia::BitmapRegionDecoder::Make(fData);
+    if (fIndexed) {
+        SkAssertResult(fBRD->buildRegionIndex());
+    }
 }
 
 void BitmapRegionDecoderBench::onDraw(int n, SkCanvas* canvas) {
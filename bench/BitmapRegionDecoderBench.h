@@ -23,6 +23,7 @@ class BitmapRegionDecoder;
 
 /**
  *  Benchmark Android's BitmapRegionDecoder for a particular colorType, sampleSize, and subset.
+ *  If indexed is set, the decoder builds its region index (outside of the timed loop) first.
  *
  *  nanobench.cpp handles creating benchmarks for interesting scaled subsets.  We strive to test
  *  on real use cases.
@@ -31,7 +32,7 @@ class BitmapRegionDecoderBench : public Benchmark {
 public:
     // Calls encoded->ref()
     BitmapRegionDecoderBench(const char* basename, SkData* encoded, SkColorType colorType,
-            uint32_t sampleSize, const SkIRect& subset);
+            uint32_t sampleSize, const SkIRect& subset, bool indexed = false);
 
 protected:
     const char* onGetName() override;
@@ -46,6 +47,7 @@ private:
     const SkColorType                                   fColorType;
     const uint32_t                                      fSampleSize;
     const SkIRect                                       fSubset;
+    const bool                                          fIndexed;
     using INHERITED = Benchmark;
 };
 #endif // SK_ENABLE_ANDROID_UTILS
@@ -6,8 +6,14 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkStream.h"
+#include "include/encode/SkJpegEncoder.h"
 #include "modules/skottie/include/Skottie.h"
 #include "tools/Resources.h"
 
@@ -94,6 +100,68 @@ private:
     using INHERITED = DecodeBench;
 };
 
+#if defined(SK_CODEC_DECODES_JPEG) && defined(SK_ENCODE_JPEG)
+// Decodes a 12 megapixel JPEG with restart markers, either serially or in bands on a thread pool.
+class JpegBandDecodeBench final : public Benchmark {
+public:
+    explicit JpegBandDecodeBench(int threads)
+        : fName(threads ? SkStringPrintf("decode_jpeg_restart_%dthreads", threads)
+                        : SkString("decode_jpeg_restart"))
+        , fThreads(threads) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(4000, 3000, /*isOpaque=*/true);
+        bitmap.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        for (int i = 0; i < 100; ++i) {
+            paint.setColor(SkColorSetRGB(17 * i, 255 - 5 * i, 31 * i));
+            canvas.drawCircle(40.0f * i, 30.0f * i, 20.0f + 10 * i, paint);
+        }
+
+        // Encoding on an executor separates bands of the image with restart markers.
+        std::unique_ptr<SkExecutor> encodeExecutor = SkExecutor::MakeFIFOThreadPool(4);
+        SkJpegEncoder::Options options;
+        options.fQuality = 90;
+        options.fExecutor = encodeExecutor.get();
+        SkDynamicMemoryWStream stream;
+        SkAssertResult(SkJpegEncoder::Encode(&stream, bitmap.pixmap(), options));
+        fData = stream.detachAsData();
+
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+        fPixels.allocPixels(SkCodec::MakeFromData(fData)->getInfo());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCodec::Options options;
+        options.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            auto codec = SkCodec::MakeFromData(fData);
+            SkAssertResult(SkCodec::kSuccess == codec->getPixels(fPixels.info(),
+                                                                 fPixels.getPixels(),
+                                                                 fPixels.rowBytes(), &options));
+        }
+    }
+
+private:
+    const SkString              fName;
+    const int                   fThreads;
+    sk_sp<SkData>               fData;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkBitmap                    fPixels;
+};
+
+DEF_BENCH(return new JpegBandDecodeBench(0));
+DEF_BENCH(return new JpegBandDecodeBench(4));
+#endif
+
 DEF_BENCH(return new SkottieDecodeBench("skottie_large",  // 426593
                                         "skottie/skottie-text-scale-to-fit-minmax.json"));
 DEF_BENCH(return new SkottieDecodeBench("skottie_medium", //  10947
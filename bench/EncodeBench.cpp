@@ -7,6 +7,7 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
@@ -58,6 +59,14 @@ static bool encode_jpeg(SkWStream* dst, const SkPixmap& src) {
     return SkJpegEncoder::Encode(dst, src, opts);
 }
 
+static bool encode_jpeg_threaded(SkWStream* dst, const SkPixmap& src) {
+    static std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkJpegEncoder::Options opts;
+    opts.fQuality = 90;
+    opts.fExecutor = executor.get();
+    return SkJpegEncoder::Encode(dst, src, opts);
+}
+
 static bool encode_webp_lossy(SkWStream* dst, const SkPixmap& src) {
     SkWebpEncoder::Options opts;
     opts.fCompression = SkWebpEncoder::Compression::kLossy;
@@ -82,6 +91,13 @@ static bool encode_png(SkWStream* dst,
     return SkPngEncoder::Encode(dst, src, opts);
 }
 
+static bool encode_png_threaded(SkWStream* dst, const SkPixmap& src) {
+    static std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkPngEncoder::Options opts;
+    opts.fExecutor = executor.get();
+    return SkPngEncoder::Encode(dst, src, opts);
+}
+
 #define PNG(FLAG, ZLIBLEVEL) [](SkWStream* d, const SkPixmap& s) { \
            return encode_png(d, s, SkPngEncoder::FilterFlag::FLAG, ZLIBLEVEL); }
 
@@ -90,6 +106,7 @@ static const char* srcs[2] = {"images/mandrill_512.png", "images/color_wheel.jpg
 // The Android Photos app uses a quality of 90 on JPEG encodes
 DEF_BENCH(return new EncodeBench(srcs[0], &encode_jpeg, "JPEG"));
 DEF_BENCH(return new EncodeBench(srcs[1], &encode_jpeg, "JPEG"));
+DEF_BENCH(return new EncodeBench(srcs[0], encode_jpeg_threaded, "JPEG_4threads"));
 
 // TODO: What is the appropriate quality to use to benchmark WEBP encodes?
 DEF_BENCH(return new EncodeBench(srcs[0], encode_webp_lossy, "WEBP"));
@@ -99,6 +116,7 @@ DEF_BENCH(return new EncodeBench(srcs[0], encode_webp_lossless, "WEBP_LL"));
 DEF_BENCH(return new EncodeBench(srcs[1], encode_webp_lossless, "WEBP_LL"));
 
 DEF_BENCH(return new EncodeBench(srcs[0], PNG(kAll, 6), "PNG"));
+DEF_BENCH(return new EncodeBench(srcs[0], encode_png_threaded, "PNG_4threads"));
 DEF_BENCH(return new EncodeBench(srcs[0], PNG(kAll, 3), "PNG_3"));
 DEF_BENCH(return new EncodeBench(srcs[0], PNG(kAll, 1), "PNG_1"));
 
@@ -6,7 +6,12 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
+#include "include/private/base/SkMutex.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <memory>
 
 namespace {
 static void* gGlobalAddress;
@@ -14,8 +19,8 @@ class TestKey : public SkResourceCache::Key {
 public:
     intptr_t fValue;
 
-    TestKey(intptr_t value) : fValue(value) {
-        this->init(&gGlobalAddress, 0, sizeof(fValue));
+    TestKey(intptr_t value, uint64_t sharedID = 0) : fValue(value) {
+        this->init(&gGlobalAddress, sharedID, sizeof(fValue));
     }
 };
 struct TestRec : public SkResourceCache::Rec {
@@ -72,6 +77,90 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Each of N threads makes the same lookups at once, so ideally the time stays flat as N grows.
+// kSingleLock guards one SkResourceCache with one mutex, as the global cache used to be;
+// kGlobal goes through the sharded global cache.
+class ImageCacheThreadedBench : public Benchmark {
+public:
+    enum Mode { kSingleLock, kGlobal };
+
+    ImageCacheThreadedBench(Mode mode, int threads)
+            : fMode(mode)
+            , fThreads(threads)
+            , fCache(CACHE_COUNT * 100) {
+        fName.printf("imagecache_%s_threads_%d",
+                     mode == kGlobal ? "global" : "single_lock", threads);
+    }
+
+    ~ImageCacheThreadedBench() override {
+        if (fPopulated && fMode == kGlobal) {
+            SkResourceCache::PostPurgeSharedID(kSharedID);
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        for (int i = 0; i < CACHE_COUNT; ++i) {
+            auto rec = new TestRec(TestKey(i, kSharedID), i);
+            if (fMode == kGlobal) {
+                SkResourceCache::Add(rec);
+            } else {
+                fCache.add(rec);
+            }
+        }
+        fPopulated = true;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup(*fExecutor).batch(fThreads, [&](int thread) {
+            for (int i = 0; i < loops; ++i) {
+                // Mostly hits, spread over all the keys, with each thread starting elsewhere.
+                TestKey key((i * 7 + thread * 31) % CACHE_COUNT, kSharedID);
+                if (fMode == kGlobal) {
+                    SkResourceCache::Find(key, TestRec::Visitor, nullptr);
+                } else {
+                    SkAutoMutexExclusive lock(fMutex);
+                    fCache.find(key, TestRec::Visitor, nullptr);
+                }
+            }
+        });
+    }
+
+private:
+    enum {
+        CACHE_COUNT = 500
+    };
+    static constexpr uint64_t kSharedID = 0x1ca4eca4e;
+
+    Mode                        fMode;
+    int                         fThreads;
+    SkString                    fName;
+    SkMutex                     fMutex;
+    SkResourceCache             fCache;
+    std::unique_ptr<SkExecutor> fExecutor;
+    bool                        fPopulated = false;
+
+    using INHERITED = Benchmark;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+
+DEF_BENCH( return new ImageCacheThreadedBench(ImageCacheThreadedBench::kSingleLock, 1); )
+DEF_BENCH( return new ImageCacheThreadedBench(ImageCacheThreadedBench::kSingleLock, 2); )
+DEF_BENCH( return new ImageCacheThreadedBench(ImageCacheThreadedBench::kSingleLock, 4); )
+DEF_BENCH( return new ImageCacheThreadedBench(ImageCacheThreadedBench::kSingleLock, 8); )
+DEF_BENCH( return new ImageCacheThreadedBench(ImageCacheThreadedBench::kGlobal, 1); )
+DEF_BENCH( return new ImageCacheThreadedBench(ImageCacheThreadedBench::kGlobal, 2); )
+DEF_BENCH( return new ImageCacheThreadedBench(ImageCacheThreadedBench::kGlobal, 4); )
+DEF_BENCH( return new ImageCacheThreadedBench(ImageCacheThreadedBench::kGlobal, 8); )
@@ -6,11 +6,15 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/gpu/GrRecordingContext.h"
+#include "src/core/SkImageFilter_Base.h"
+#include "src/core/SkSpecialImage.h"
 #include "tools/Resources.h"
 
 // Exercise a blur filter connected to 5 inputs of the same merge filter.
@@ -164,7 +168,61 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Filters a large raster image with a blur and morphology DAG, either serially or in tiles on
+// an executor with the given number of threads. No cache is used, so every loop does all the work.
+class ImageFilterTiledBench : public Benchmark {
+public:
+    explicit ImageFilterTiledBench(int threads) : fThreads(threads) {
+        fName.printf("image_filter_tiled_%dthreads", threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kSize, kSize);
+        SkCanvas canvas(bitmap);
+        canvas.clear(SK_ColorTRANSPARENT);
+        SkPaint paint;
+        for (int i = 0; i < 64; i++) {
+            paint.setColor(0xFF000000 | (i * 0x050A0F));
+            canvas.drawCircle((i * 97) % kSize, (i * 61) % kSize, 40, paint);
+        }
+        fSource = SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kSize, kSize), bitmap,
+                                                 SkSurfaceProps());
+        fFilter = SkImageFilters::Dilate(3, 3, SkImageFilters::Blur(8, 8, nullptr));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                                        kN32_SkColorType, nullptr, fSource.get());
+        ctx = ctx.withExecutor(fExecutor.get());
+        for (int j = 0; j < loops; j++) {
+            (void)as_IFB(fFilter)->filterImage(ctx);
+        }
+    }
+
+private:
+    static constexpr int kSize = 2048;
+
+    const int fThreads;
+    SkString fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    sk_sp<SkSpecialImage> fSource;
+    sk_sp<SkImageFilter> fFilter;
+};
+
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
+DEF_BENCH(return new ImageFilterTiledBench(0);)
+DEF_BENCH(return new ImageFilterTiledBench(2);)
+DEF_BENCH(return new ImageFilterTiledBench(4);)
+DEF_BENCH(return new ImageFilterTiledBench(8);)
@@ -8,22 +8,30 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkExecutor.h"
 #include "src/core/SkMipmap.h"
 
+#include <memory>
+
 class MipmapBench: public Benchmark {
     SkBitmap fBitmap;
     SkString fName;
     const int fW, fH;
     bool fHalfFoat;
+    const int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
 
 public:
-    MipmapBench(int w, int h, bool halfFloat = false)
-        : fW(w), fH(h), fHalfFoat(halfFloat)
+    MipmapBench(int w, int h, bool halfFloat = false, int threads = 0)
+        : fW(w), fH(h), fHalfFoat(halfFloat), fThreads(threads)
     {
         fName.printf("mipmap_build_%dx%d", w, h);
         if (halfFloat) {
             fName.append("_f16");
         }
+        if (threads) {
+            fName.appendf("_%dthreads", threads);
+        }
     }
 
 protected:
@@ -39,11 +47,16 @@ protected:
                                              SkColorSpace::MakeSRGB());
         fBitmap.allocPixels(info);
         fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
     }
 
     void onDraw(int loops, SkCanvas*) override {
+        SkMipmap::BuildOptions options;
+        options.fExecutor = fExecutor.get();
         for (int i = 0; i < loops * 4; i++) {
-            SkMipmap::Build(fBitmap, nullptr)->unref();
+            SkMipmap::Build(fBitmap, nullptr, options)->unref();
         }
     }
 
@@ -66,3 +79,47 @@ DEF_BENCH( return new MipmapBench(2048, 2048); )
 DEF_BENCH( return new MipmapBench(2047, 2047); )
 DEF_BENCH( return new MipmapBench(2048, 2047); )
 DEF_BENCH( return new MipmapBench(2047, 2048); )
+
+DEF_BENCH( return new MipmapBench(4096, 4096, false, 4); )
+DEF_BENCH( return new MipmapBench(4095, 4095, false, 4); )
+DEF_BENCH( return new MipmapBench(4096, 4096, true, 4); )
+
+// Builds a mipmap lazily and asks for one level, as a draw that samples only that level would.
+class LazyMipmapBench : public Benchmark {
+    SkBitmap fBitmap;
+    SkString fName;
+    const int fW, fH, fLevel;
+
+public:
+    LazyMipmapBench(int w, int h, int level) : fW(w), fH(h), fLevel(level) {
+        fName.printf("mipmap_build_lazy_%dx%d_level%d", w, h, level);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fBitmap.allocN32Pixels(fW, fH);
+        fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkMipmap::BuildOptions options;
+        options.fLazy = true;
+        for (int i = 0; i < loops * 4; i++) {
+            sk_sp<SkMipmap> mipmap(SkMipmap::Build(fBitmap, nullptr, options));
+            SkMipmap::Level level;
+            mipmap->getLevel(fLevel, &level);
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new LazyMipmapBench(2048, 2048, 0); )
+DEF_BENCH( return new LazyMipmapBench(2048, 2048, 2); )
@@ -7,12 +7,15 @@
 
 #include "bench/Benchmark.h"
 
+#include "include/core/SkAnnotation.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkString.h"
 #include "include/effects/SkGradientShader.h"
 #include "include/private/base/SkTo.h"
 #include "include/utils/SkRandom.h"
@@ -303,6 +306,47 @@ struct PDFClipPathBenchmark : public Benchmark {
     }
 };
 
+// A document with many small objects: pages of text with a link on each line. Compare the
+// speed of writing it with and without object streams; each prints its size the first time.
+struct PDFTextDocBench : public Benchmark {
+    bool fObjectStreams;
+    size_t fBytes = 0;
+    PDFTextDocBench(bool objectStreams) : fObjectStreams(objectStreams) {}
+    const char* onGetName() override {
+        return fObjectStreams ? "PDFTextDoc_objectStreams" : "PDFTextDoc";
+    }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.fObjectStreams = fObjectStreams;
+            auto doc = SkPDF::MakeDocument(&wStream, metadata);
+            SkFont font;
+            sk_sp<SkData> url = SkData::MakeWithCString("https://skia.org/");
+            for (int page = 0; page < 20; ++page) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                for (int line = 0; line < 50; ++line) {
+                    float y = 36 + 14 * line;
+                    SkString text;
+                    text.printf("Page %d, line %d: the quick brown fox jumps over the lazy dog.",
+                                page, line);
+                    canvas->drawString(text, 36, y, font, SkPaint());
+                    SkAnnotateRectWithURL(canvas, SkRect::MakeLTRB(36, y - 12, 300, y), url.get());
+                }
+                doc->endPage();
+            }
+            doc->close();
+            if (fBytes == 0) {
+                fBytes = wStream.bytesWritten();
+                SkDebugf("%s: %zu bytes\n", this->onGetName(), fBytes);
+            }
+        }
+    }
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
@@ -311,6 +355,8 @@ DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
 DEF_BENCH(return new PDFClipPathBenchmark;)
+DEF_BENCH(return new PDFTextDocBench(false);)
+DEF_BENCH(return new PDFTextDocBench(true);)
 
 #ifdef SK_PDF_ENABLE_SLOW_TESTS
 #include "include/core/SkExecutor.h"
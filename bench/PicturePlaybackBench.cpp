@@ -13,9 +13,14 @@
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPoint.h"
+#include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkString.h"
 #include "include/utils/SkRandom.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecordOpts.h"
+#include "src/core/SkRecorder.h"
 
 // This is designed to emulate about 4 screens of textual content
 
@@ -97,3 +102,57 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+// Recorded UI often stacks opaque fills: a window background, then panels, then cards, each
+// covering much of what was drawn before.  This measures playing such a record back with and
+// without SkRecordOptimize() having removed the hidden draws first.
+class OverdrawPlaybackBench : public Benchmark {
+public:
+    explicit OverdrawPlaybackBench(bool optimize)
+        : fOptimize(optimize)
+        , fName(optimize ? "overdraw_playback_optimized" : "overdraw_playback") {}
+
+    const char* onGetName() override { return fName.c_str(); }
+    SkIPoint onGetSize() override { return SkIPoint::Make(1024,1024); }
+
+    void onDelayedSetup() override {
+        SkRecorder recorder(&fRecord, 1024, 1024);
+        SkRandom rand;
+        for (int frame = 0; frame < 10; frame++) {
+            // Each frame repaints the window background and its panels from scratch.
+            SkPaint paint;
+            paint.setColor(0xFFF0F0F0);
+            recorder.drawRect(SkRect::MakeWH(1024, 1024), paint);
+            for (int panel = 0; panel < 4; panel++) {
+                const SkRect bounds = SkRect::MakeXYWH((panel % 2) * 512, (panel / 2) * 512,
+                                                       512, 512);
+                paint.setColor(rand.nextU() | 0xFF000000);
+                recorder.drawRect(bounds, paint);
+                for (int card = 0; card < 8; card++) {
+                    paint.setColor(rand.nextU() | 0xFF000000);
+                    const SkRect cardBounds = SkRect::MakeXYWH(bounds.fLeft + 8,
+                                                               bounds.fTop + 8 + card * 62,
+                                                               496, 56);
+                    recorder.drawRRect(SkRRect::MakeRectXY(cardBounds, 4, 4), paint);
+                }
+            }
+        }
+        if (fOptimize) {
+            SkRecordOptimize(&fRecord);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            SkRecordDraw(fRecord, canvas, nullptr, nullptr, 0, nullptr, nullptr);
+        }
+    }
+
+private:
+    bool     fOptimize;
+    SkString fName;
+    SkRecord fRecord;
+};
+
+DEF_BENCH( return new OverdrawPlaybackBench(false); )
+DEF_BENCH( return new OverdrawPlaybackBench(true ); )
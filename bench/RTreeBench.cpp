@@ -12,6 +12,9 @@
 #include "include/utils/SkRandom.h"
 #include "src/core/SkRTree.h"
 
+#include <algorithm>
+#include <vector>
+
 // confine rectangles to a smallish area, so queries generally hit something, and overlap occurs:
 static const SkScalar GENERATE_EXTENTS = 1000.0f;
 static const int NUM_BUILD_RECTS = 500;
@@ -96,6 +99,55 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Time the same queries as RTreeQueryBench, made kBatchSize at a time with the batched search().
+class RTreeBatchQueryBench : public Benchmark {
+public:
+    RTreeBatchQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
+        fName.printf("rtree_%s_query_batch", name);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+    void onDelayedSetup() override {
+        SkRandom rand;
+        SkAutoTMalloc<SkRect> rects(NUM_QUERY_RECTS);
+        for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
+            rects[i] = fProc(rand, i, NUM_QUERY_RECTS);
+        }
+        fTree.insert(rects.get(), NUM_QUERY_RECTS);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkRandom rand;
+        SkRect queries[kBatchSize];
+        std::vector<int> hits[kBatchSize];
+        for (int i = 0; i < loops; i += kBatchSize) {
+            const int count = std::min(kBatchSize, loops - i);
+            for (int j = 0; j < count; ++j) {
+                SkRect& query = queries[j];
+                query.fLeft   = rand.nextRangeF(0, GENERATE_EXTENTS);
+                query.fTop    = rand.nextRangeF(0, GENERATE_EXTENTS);
+                query.fRight  = query.fLeft + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
+                query.fBottom = query.fTop  + 1 + rand.nextRangeF(0, GENERATE_EXTENTS/2);
+                hits[j].clear();
+            }
+            fTree.search(queries, count, hits);
+        }
+    }
+private:
+    static constexpr int kBatchSize = 16;
+
+    SkRTree fTree;
+    MakeRectProc fProc;
+    SkString fName;
+    using INHERITED = Benchmark;
+};
+
 static inline SkRect make_XYordered_rects(SkRandom& rand, int index, int numRects) {
     SkRect out;
     out.fLeft   = SkIntToScalar(index % GRID_WIDTH);
@@ -137,3 +189,8 @@ DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
 DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
 DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
 DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeBatchQueryBench("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeBatchQueryBench("YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeBatchQueryBench("random", &make_random_rects));
+DEF_BENCH(return new RTreeBatchQueryBench("concentric", &make_concentric_rects));
@@ -10,6 +10,9 @@
 #include "include/core/SkBBHFactory.h"
 #include "include/core/SkData.h"
 #include "include/core/SkPictureRecorder.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordOpts.h"
+#include "src/core/SkRecorder.h"
 
 PictureCentricBench::PictureCentricBench(const char* name, const SkPicture* pic) : fName(name) {
     // Flatten the source picture in case it's trivially nested (useless for timing).
@@ -48,6 +51,28 @@ void RecordingBench::onDraw(int loops, SkCanvas*) {
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+RecordOptimizeBench::RecordOptimizeBench(const char* name, const SkPicture* pic, bool optimize2)
+    : INHERITED(name, pic)
+    , fOptimize2(optimize2)
+{
+    fName.append(optimize2 ? "_optimize2" : "_optimize");
+}
+
+void RecordOptimizeBench::onDraw(int loops, SkCanvas*) {
+    while (loops --> 0) {
+        SkRecord record;
+        SkRecorder recorder(&record, fSrc->cullRect());
+        fSrc->playback(&recorder);
+        if (fOptimize2) {
+            SkRecordOptimize2(&record);
+        } else {
+            SkRecordOptimize(&record);
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #include "include/core/SkSerialProcs.h"
 
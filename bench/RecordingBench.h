@@ -40,6 +40,21 @@ private:
     using INHERITED = PictureCentricBench;
 };
 
+// Times re-recording the picture and running SkRecordOptimize() (or SkRecordOptimize2()) over it,
+// without building an SkPicture.  Compare with RecordingBench to see what the passes cost.
+class RecordOptimizeBench : public PictureCentricBench {
+public:
+    RecordOptimizeBench(const char* name, const SkPicture*, bool optimize2);
+
+protected:
+    void onDraw(int loops, SkCanvas*) override;
+
+private:
+    bool fOptimize2;
+
+    using INHERITED = PictureCentricBench;
+};
+
 class DeserializePictureBench : public Benchmark {
 public:
     DeserializePictureBench(const char* name, sk_sp<SkData> encodedPicture);
@@ -10,6 +10,7 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkGraphics.h"
 #include "include/core/SkTypeface.h"
 #include "include/private/chromium/SkChromeRemoteGlyphCache.h"
@@ -113,10 +114,63 @@ private:
     SkString fName;
 };
 
+// Many threads looking up the same, already cached, glyphs in one strike. Each thread does the
+// same amount of work, so with no contention the time stays flat as threads are added.
+class SkGlyphCacheThreaded : public Benchmark {
+public:
+    explicit SkGlyphCacheThreaded(int threads) : fThreads(threads) {
+        fName.printf("SkGlyphCacheThreaded_%dthreads", threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        fFont.setEdging(SkFont::Edging::kAntiAlias);
+        fFont.setSubpixel(true);
+        fFont.setSize(24);
+        fFont.setTypeface(ToolUtils::create_portable_typeface("serif", SkFontStyle::Italic()));
+        for (int c = ' '; c < 'z'; c++) {
+            fGlyphs.push_back(SkPackedGlyphID{fFont.unicharToGlyph(c)});
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkStrikeSpec strikeSpec = SkStrikeSpec::MakeMask(
+                fFont, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                SkScalerContextFlags::kNone, SkMatrix::I());
+        // Make every glyph image before timing only lookups.
+        (void)SkBulkGlyphMetricsAndImages{strikeSpec}.glyphs(fGlyphs);
+
+        SkTaskGroup(*fExecutor).batch(fThreads, [&](int) {
+            SkBulkGlyphMetricsAndImages images{strikeSpec};
+            for (int i = 0; i < loops * 100; i++) {
+                (void)images.glyphs(fGlyphs);
+            }
+        });
+    }
+
+private:
+    const int fThreads;
+    SkString fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkFont fFont;
+    std::vector<SkPackedGlyphID> fGlyphs;
+};
+
 DEF_BENCH( return new SkGlyphCacheBasic(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheThreaded(1); )
+DEF_BENCH( return new SkGlyphCacheThreaded(2); )
+DEF_BENCH( return new SkGlyphCacheThreaded(4); )
+DEF_BENCH( return new SkGlyphCacheThreaded(8); )
 
 namespace {
 class DiscardableManager : public SkStrikeServer::DiscardableHandleManager,
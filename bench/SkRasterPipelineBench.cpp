@@ -0,0 +1,149 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkString.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkRasterPipeline.h"
+
+#include <vector>
+
+extern bool gForceHighPrecisionRasterPipeline;
+
+// These benchmarks run the raster pipelines behind the most common raster blits directly, without
+// a canvas or blitter in the way, so they measure only the stages themselves. kWidth isn't a
+// multiple of any pipeline stride, so each row also runs one tail.
+static constexpr int kWidth  = 1021,
+                     kHeight = 16;
+
+class RasterPipelineBench : public Benchmark {
+public:
+    RasterPipelineBench(const char* name, bool highp) : fHighp(highp) {
+        fName.printf("raster_pipeline_%s_%s_stride%zu",
+                     name, highp ? "highp" : "lowp",
+                     highp ? SkOpts::raster_pipeline_highp_stride
+                           : SkOpts::raster_pipeline_lowp_stride);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fSrc.resize(kWidth * kHeight);
+        fDst.resize(kWidth * kHeight);
+        for (int i = 0; i < kWidth * kHeight; i++) {
+            // A mix of opaque, translucent and transparent premultiplied colors.
+            uint32_t a = (i * 37) & 0xff;
+            fSrc[i] = (a << 24) | ((a * 3 / 4) << 16) | ((a / 2) << 8) | (a / 4);
+            fDst[i] = 0xff204080;
+        }
+        fSrcCtx = {fSrc.data(), kWidth};
+        fDstCtx = {fDst.data(), kWidth};
+
+        this->appendStages(&fPipeline);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        // Compile once, outside the timed loop, picking lowp or highp as requested.
+        const bool wasForced = gForceHighPrecisionRasterPipeline;
+        gForceHighPrecisionRasterPipeline = fHighp;
+        auto run = fPipeline.compile();
+        gForceHighPrecisionRasterPipeline = wasForced;
+
+        while (loops --> 0) {
+            run(0, 0, kWidth, kHeight);
+        }
+    }
+
+    virtual void appendStages(SkRasterPipeline*) = 0;
+
+    SkRasterPipeline_MemoryCtx fSrcCtx, fDstCtx;
+
+private:
+    SkString                 fName;
+    bool                     fHighp;
+    std::vector<uint32_t>    fSrc, fDst;
+    SkRasterPipeline_<256>   fPipeline;
+};
+
+// The fused src-over blend used for 8888 destinations.
+class SrcOver8888Bench final : public RasterPipelineBench {
+public:
+    explicit SrcOver8888Bench(bool highp) : RasterPipelineBench("srcover_rgba_8888", highp) {}
+
+private:
+    void appendStages(SkRasterPipeline* p) override {
+        p->append(SkRasterPipeline::load_8888, &fSrcCtx);
+        p->append(SkRasterPipeline::srcover_rgba_8888, &fDstCtx);
+    }
+};
+
+// An evenly spaced, horizontal, clamped gradient with a handful of stops.
+class Gradient8888Bench final : public RasterPipelineBench {
+public:
+    explicit Gradient8888Bench(bool highp) : RasterPipelineBench("gradient", highp) {}
+
+private:
+    static constexpr int kStops = 8;
+
+    void appendStages(SkRasterPipeline* p) override {
+        for (int i = 0; i < 4; i++) {
+            fFs[i].resize(SkRasterPipeline_kMaxStride_highp, 0.0f);
+            fBs[i].resize(SkRasterPipeline_kMaxStride_highp, 0.0f);
+            for (int stop = 0; stop < kStops; stop++) {
+                fFs[i][stop] = (i + 1) * 0.05f;
+                fBs[i][stop] = stop * (1.0f / kStops);
+            }
+            fGradientCtx.fs[i] = fFs[i].data();
+            fGradientCtx.bs[i] = fBs[i].data();
+        }
+        fGradientCtx.stopCount = kStops;
+        fGradientCtx.ts = nullptr;
+
+        p->append(SkRasterPipeline::seed_shader);
+        p->append(SkRasterPipeline::matrix_scale_translate, fMatrix);
+        p->append(SkRasterPipeline::clamp_x_1);
+        p->append(SkRasterPipeline::evenly_spaced_gradient, &fGradientCtx);
+        p->append(SkRasterPipeline::srcover_rgba_8888, &fDstCtx);
+    }
+
+    // Maps x in [0,kWidth) to t in [0,1); y is ignored.
+    float fMatrix[4] = {1.0f / kWidth, 1.0f, 0.0f, 0.0f};
+    std::vector<float> fFs[4], fBs[4];
+    SkRasterPipeline_GradientCtx fGradientCtx;
+};
+
+// A bilinearly filtered, clamped image draw, scaled up by a non-integer factor.
+class BilerpClamp8888Bench final : public RasterPipelineBench {
+public:
+    explicit BilerpClamp8888Bench(bool highp) : RasterPipelineBench("bilerp_clamp_8888", highp) {}
+
+private:
+    void appendStages(SkRasterPipeline* p) override {
+        fGatherCtx.pixels = fSrcCtx.pixels;
+        fGatherCtx.stride = fSrcCtx.stride;
+        fGatherCtx.width  = kWidth;
+        fGatherCtx.height = kHeight;
+
+        p->append(SkRasterPipeline::seed_shader);
+        p->append(SkRasterPipeline::matrix_scale_translate, fMatrix);
+        p->append(SkRasterPipeline::bilerp_clamp_8888, &fGatherCtx);
+        p->append(SkRasterPipeline::store_8888, &fDstCtx);
+    }
+
+    float fMatrix[4] = {0.7f, 0.7f, 0.25f, 0.25f};
+    SkRasterPipeline_GatherCtx fGatherCtx;
+};
+
+DEF_BENCH( return new SrcOver8888Bench(/*highp=*/false); )
+DEF_BENCH( return new SrcOver8888Bench(/*highp=*/true); )
+DEF_BENCH( return new Gradient8888Bench(/*highp=*/false); )
+DEF_BENCH( return new Gradient8888Bench(/*highp=*/true); )
+DEF_BENCH( return new BilerpClamp8888Bench(/*highp=*/false); )
+DEF_BENCH( return new BilerpClamp8888Bench(/*highp=*/true); )
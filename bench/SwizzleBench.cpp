@@ -13,21 +13,31 @@ public:
 
     SwizzleBench(const char* name, SkOpts::Swizzle_8888_u32 fn) : fName(name), fFn_u32(fn) {}
     SwizzleBench(const char* name, SkOpts::Swizzle_8888_u8  fn) : fName(name), fFn_u8 (fn) {}
+    SwizzleBench(const char* name, SkOpts::Index_to_8888    fn) : fName(name), fFn_index(fn) {}
+    SwizzleBench(const char* name, SkOpts::Bitfields_to_8888 fn,
+                 uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+        : fName(name), fFn_bitfields(fn), fMasks{r, g, b, a} {}
 
     bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
     const char* onGetName() override { return fName; }
     void onDraw(int loops, SkCanvas*) override {
         static const int K = 1023; // Arbitrary, but nice to be a non-power-of-two to trip up SIMD.
-        uint32_t dst[K], src[K];
+        uint32_t dst[K], ctable[256];
+        uint64_t src[K];  // Big enough for 16-bit per component RGBA.
         while (loops --> 0) {
-            if (fFn_u32) { fFn_u32(dst,                 src, K); }
-            if (fFn_u8)  { fFn_u8 (dst, (const uint8_t*)src, K); }
+            if (fFn_u32)       { fFn_u32      (dst, (const uint32_t*)src, K); }
+            if (fFn_u8)        { fFn_u8       (dst, (const uint8_t*) src, K); }
+            if (fFn_index)     { fFn_index    (dst, (const uint8_t*) src, K, ctable); }
+            if (fFn_bitfields) { fFn_bitfields(dst, (const uint8_t*) src, K, fMasks, 0); }
         }
     }
 private:
     const char* fName;
-    SkOpts::Swizzle_8888_u32 fFn_u32 = nullptr;
-    SkOpts::Swizzle_8888_u8  fFn_u8  = nullptr;
+    SkOpts::Swizzle_8888_u32  fFn_u32       = nullptr;
+    SkOpts::Swizzle_8888_u8   fFn_u8        = nullptr;
+    SkOpts::Index_to_8888     fFn_index     = nullptr;
+    SkOpts::Bitfields_to_8888 fFn_bitfields = nullptr;
+    uint32_t                  fMasks[4]     = {0, 0, 0, 0};
 };
 
 
@@ -41,3 +51,16 @@ DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_RGBA", SkOpts::grayA_to_RGBA
 DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_rgbA", SkOpts::grayA_to_rgbA));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_RGB1", SkOpts::inverted_CMYK_to_RGB1));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_BGR1", SkOpts::inverted_CMYK_to_BGR1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_RGB1", SkOpts::RGB16_to_RGB1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_BGR1", SkOpts::RGB16_to_BGR1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_RGBA", SkOpts::RGBA16_to_RGBA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_BGRA", SkOpts::RGBA16_to_BGRA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_rgbA", SkOpts::RGBA16_to_rgbA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_bgrA", SkOpts::RGBA16_to_bgrA));
+DEF_BENCH(return new SwizzleBench("SkOpts::index_to_8888", SkOpts::index_to_8888));
+DEF_BENCH(return new SwizzleBench("SkOpts::bitfields16_to_8888_565", SkOpts::bitfields16_to_8888,
+                                  0xF800, 0x07E0, 0x001F, 0));
+DEF_BENCH(return new SwizzleBench("SkOpts::bitfields16_to_8888_4444", SkOpts::bitfields16_to_8888,
+                                  0x0F00, 0x00F0, 0x000F, 0xF000));
+DEF_BENCH(return new SwizzleBench("SkOpts::bitfields32_to_8888", SkOpts::bitfields32_to_8888,
+                                  0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000));
@@ -741,7 +741,7 @@ static Target* is_enabled(Benchmark* bench, const Config& config) {
 
 #ifdef SK_ENABLE_ANDROID_UTILS
 static bool valid_brd_bench(sk_sp<SkData> encoded, SkColorType colorType, uint32_t sampleSize,
-        uint32_t minOutputSize, int* width, int* height) {
+        uint32_t minOutputSize, int* width, int* height, bool* indexable) {
     auto brd = android::skia::BitmapRegionDecoder::Make(encoded);
     if (nullptr == brd) {
         // This is indicates that subset decoding is not supported for a particular image format.
@@ -758,6 +758,7 @@ static bool valid_brd_bench(sk_sp<SkData> encoded, SkColorType colorType, uint32
     // Set the image width and height.  The calling code will use this to choose subsets to decode.
     *width = brd->width();
     *height = brd->height();
+    *indexable = brd->buildRegionIndex() != nullptr;
     return true;
 }
 #endif
@@ -948,6 +949,22 @@ public:
             return new RecordingBench(name.c_str(), pic.get(), FLAGS_bbh);
         }
 
+        // Then time the SkRecord optimization passes over each .skp.
+        while (fCurrentOptimize < 2 * fSKPs.size()) {
+            const bool optimize2 = fCurrentOptimize >= fSKPs.size();
+            const SkString& path = fSKPs[fCurrentOptimize++ % fSKPs.size()];
+            sk_sp<SkPicture> pic = ReadPicture(path.c_str());
+            if (!pic) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            fSourceType = "skp";
+            fBenchType  = "recording";
+            fSKPBytes = static_cast<double>(pic->approximateBytesUsed());
+            fSKPOps   = pic->approximateOpCount();
+            return new RecordOptimizeBench(name.c_str(), pic.get(), optimize2);
+        }
+
         // Add all .skps as DeserializePictureBenchs.
         while (fCurrentDeserialPicture < fSKPs.size()) {
             const SkString& path = fSKPs[fCurrentDeserialPicture++];
@@ -1175,15 +1192,28 @@ public:
                         sk_sp<SkData> encoded(SkData::MakeFromFileName(path.c_str()));
                         const SkColorType colorType = fColorTypes[fCurrentColorType];
                         uint32_t sampleSize = brdSampleSizes[fCurrentSampleSize];
-                        int currentSubsetType = fCurrentSubsetType++;
+                        int currentSubsetType = fCurrentSubsetType;
+                        const bool indexed = fCurrentBRDIndexed;
 
                         int width = 0;
                         int height = 0;
+                        bool indexable = false;
                         if (!valid_brd_bench(encoded, colorType, sampleSize, minOutputSize,
-                                &width, &height)) {
+                                &width, &height, &indexable)) {
+                            fCurrentSubsetType++;
+                            fCurrentBRDIndexed = false;
                             break;
                         }
 
+                        // Images that can be indexed are benchmarked again with their index, to
+                        // show what it saves on subsets far from the top.
+                        if (indexable && !indexed) {
+                            fCurrentBRDIndexed = true;
+                        } else {
+                            fCurrentSubsetType++;
+                            fCurrentBRDIndexed = false;
+                        }
+
                         SkString basename = SkOSPath::Basename(path.c_str());
                         SkIRect subset;
                         const uint32_t subsetSize = sampleSize * minOutputSize;
@@ -1217,7 +1247,7 @@ public:
                         }
 
                         return new BitmapRegionDecoderBench(basename.c_str(), encoded.get(),
-                                colorType, sampleSize, subset);
+                                colorType, sampleSize, subset, indexed);
                     }
                     fCurrentSubsetType = 0;
                     fCurrentSampleSize++;
@@ -1284,6 +1314,7 @@ private:
     const char* fSourceType;  // What we're benching: bench, GM, SKP, ...
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording = 0;
+    int fCurrentOptimize = 0;
     int fCurrentDeserialPicture = 0;
     int fCurrentMSKP = 0;
     int fCurrentScale = 0;
@@ -1295,6 +1326,7 @@ private:
 #ifdef SK_ENABLE_ANDROID_UTILS
     int fCurrentBRDImage = 0;
     int fCurrentSubsetType = 0;
+    bool fCurrentBRDIndexed = false;
 #endif
     int fCurrentColorType = 0;
     int fCurrentAlphaType = 0;
@@ -10,6 +10,7 @@
 #include "include/codec/SkAndroidCodec.h"
 #include "include/core/SkEncodedImageFormat.h"
 #include "src/codec/SkCodecPriv.h"
+#include "src/codec/SkJpegCodec.h"
 
 namespace android {
 namespace skia {
@@ -46,6 +47,24 @@ int BitmapRegionDecoder::height() const {
     return fCodec->getInfo().height();
 }
 
+sk_sp<SkData> BitmapRegionDecoder::buildRegionIndex() {
+#ifdef SK_CODEC_DECODES_JPEG
+    if (fCodec->getEncodedFormat() == SkEncodedImageFormat::kJPEG) {
+        return static_cast<SkJpegCodec*>(fCodec->codec())->buildMCUIndex();
+    }
+#endif
+    return nullptr;
+}
+
+bool BitmapRegionDecoder::setRegionIndex(const SkData& index) {
+#ifdef SK_CODEC_DECODES_JPEG
+    if (fCodec->getEncodedFormat() == SkEncodedImageFormat::kJPEG) {
+        return static_cast<SkJpegCodec*>(fCodec->codec())->setMCUIndex(index);
+    }
+#endif
+    return false;
+}
+
 bool BitmapRegionDecoder::decodeRegion(SkBitmap* bitmap, BRDAllocator* allocator,
         const SkIRect& desiredSubset, int sampleSize, SkColorType dstColorType,
         bool requireUnpremul, sk_sp<SkColorSpace> dstColorSpace) {
@@ -39,6 +39,22 @@ public:
     int width() const;
     int height() const;
 
+    /*
+     * Builds an index that lets decodeRegion() start decoding near the top of the region,
+     * instead of decoding and discarding every row above it. Returns the index serialized, so
+     * it can be stored with the image and passed to setRegionIndex() by later decoders.
+     *
+     * Only JPEGs with restart markers at MCU row boundaries can be indexed. For anything else
+     * this returns nullptr, and decodeRegion() works as before.
+     */
+    sk_sp<SkData> buildRegionIndex();
+
+    /*
+     * Uses an index returned by buildRegionIndex() for the same encoded data. Returns false if
+     * the index doesn't match this image.
+     */
+    bool setRegionIndex(const SkData& index);
+
 private:
     BitmapRegionDecoder(std::unique_ptr<SkAndroidCodec> codec);
 
@@ -212,6 +212,7 @@ public:
         AndroidOptions()
             : SkCodec::Options()
             , fSampleSize(1)
+            , fBoxFilter(false)
         {}
 
         /**
@@ -222,6 +223,17 @@ public:
          *  The default is 1, representing no downscaling.
          */
         int fSampleSize;
+
+        /**
+         *  When fSampleSize is greater than the codec can scale natively, the codec normally
+         *  keeps one pixel of each fSampleSize x fSampleSize block. If this is true, it
+         *  averages each block instead, as the rows are decoded, so downscaling does not alias
+         *  and does not need a full size buffer. Codecs that can't average while decoding, and
+         *  unpremul or unusual color types, still sample.
+         *
+         *  The default is false.
+         */
+        bool fBoxFilter;
     };
 
     /**
@@ -32,6 +32,8 @@
 #include "include/core/SkEncodedImageFormat.h" // IWYU pragma: keep
 
 class SkAndroidCodec;
+class SkBoxDownsampler;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
@@ -294,6 +296,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -337,6 +340,15 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels may decode independent parts of the image concurrently on
+         *  this executor. It must outlive the call to getPixels.
+         *
+         *  Currently only JPEGs with restart markers are decoded this way; the result is the
+         *  same as decoding without an executor.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -997,6 +1009,14 @@ private:
      */
     virtual SkSampler* getSampler(bool /*createIfNecessary*/) { return nullptr; }
 
+    /**
+     *  Hand every decoded row to downsampler, instead of writing the rows the sampler selects
+     *  to the destination. Returns false if this codec can't.
+     *
+     *  Only valid during incremental decoding, once the sampler is set to sample every pixel.
+     */
+    virtual bool setBoxDownsampler(SkBoxDownsampler*) { return false; }
+
     friend class DM::CodecSrc;  // for fillIncompleteImage
     friend class SkSampledCodec;
     friend class SkIcoCodec;
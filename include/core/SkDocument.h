@@ -10,8 +10,10 @@
 
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkSpan.h"
 
 class SkCanvas;
+class SkPicture;
 class SkWStream;
 struct SkRect;
 
@@ -45,6 +47,16 @@ public:
      */
     void endPage();
 
+    /**
+     *  Adds a page for each picture, the size of its cullRect(), with the picture drawn so that
+     *  the top left of its cullRect() is at the page's origin. Ends the current page first, if
+     *  there is one. Null pictures are skipped.
+     *
+     *  The result is the same as calling beginPage(), drawPicture() and endPage() for each
+     *  picture, but a document may draw several pages at once; see SkPDF::Metadata::fExecutor.
+     */
+    void drawPages(SkSpan<const sk_sp<SkPicture>> pages);
+
     /**
      *  Call close() when all pages have been drawn. This will close the file
      *  or stream holding the document's contents. After close() the document
@@ -68,6 +80,8 @@ protected:
 
     virtual SkCanvas* onBeginPage(SkScalar width, SkScalar height) = 0;
     virtual void onEndPage() = 0;
+    // Draws the pages one at a time with beginPage() and endPage().
+    virtual void onDrawPages(SkSpan<const sk_sp<SkPicture>> pages);
     virtual void onClose(SkWStream*) = 0;
     virtual void onAbort() = 0;
 
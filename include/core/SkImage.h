@@ -40,6 +40,7 @@ class GrYUVABackendTextureInfo;
 class GrYUVABackendTextures;
 class SkCanvas;
 class SkData;
+class SkExecutor;
 class SkImage;
 class SkImageFilter;
 class SkImageGenerator;
@@ -1389,6 +1390,18 @@ public:
     */
     bool isLazyGenerated() const;
 
+    /** If SkImage is lazy generated, starts generating its pixels on executor and adds them to
+        the raster cache. A later draw into a raster canvas, or readPixels() with
+        kAllow_CachingHint, then finds them there instead of generating them itself; one that
+        starts while they are being generated waits for them. Does nothing if SkImage is not
+        lazy generated.
+
+        Cached pixels may be purged, like those cached by drawing, before they are used.
+
+        @param executor  runs the decode; if nullptr, SkExecutor::GetDefault() runs it
+    */
+    void decodeAhead(SkExecutor* executor) const;
+
     /** Creates SkImage in target SkColorSpace.
         Returns nullptr if SkImage could not be created.
 
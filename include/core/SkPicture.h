@@ -18,10 +18,13 @@
 class SkCanvas;
 class SkData;
 struct SkDeserialProcs;
+class SkExecutor;
 class SkImage;
 class SkMatrix;
+class SkPixmap;
 struct SkSerialProcs;
 class SkStream;
+class SkSurfaceProps;
 class SkWStream;
 
 /** \class SkPicture
@@ -130,6 +133,38 @@ public:
     */
     virtual void playback(SkCanvas* canvas, AbortCallback* callback = nullptr) const = 0;
 
+    /** Replays the drawing commands into the pixels of dst, splitting dst into as many as
+        bandCount horizontal bands that are drawn concurrently on executor. Each band is
+        clipped to its rows, so a picture recorded with a bounding box hierarchy only replays
+        the commands that touch that band. Returns once every band has been drawn.
+
+        The result is identical to calling playback() on a canvas that draws into dst. To keep
+        it that way, bands are only split between rows that no path-like draw or clip (paths,
+        ovals, rounded rects, text, strokes, rotated rects) crosses; fills of axis-aligned rects
+        and images may cross them. Pictures that draw into
+        layers (saveLayer, image filters on a paint, or pictures drawn with a paint), pictures
+        that are not recorded, and perspective matrices are played back on the calling thread.
+
+        @param dst        pixels to draw into
+        @param matrix     transforms the picture into dst; may be nullptr
+        @param executor   runs the bands; if nullptr, playback runs on the calling thread
+        @param bandCount  largest number of bands to split dst into
+        @param props      LCD striping orientation and setting for device independent fonts;
+                          may be nullptr
+        @return           true if dst could be drawn into
+    */
+    bool playbackInBands(const SkPixmap& dst, const SkMatrix* matrix, SkExecutor* executor,
+                         int bandCount, const SkSurfaceProps* props = nullptr) const;
+
+    /** Calls SkImage::decodeAhead() on each lazy generated SkImage this picture draws, and on
+        those drawn by the pictures it draws, so that playback finds their pixels already in
+        the raster cache. Images only reached through a shader or image filter on a paint are
+        not decoded ahead.
+
+        @param executor  runs the decodes; if nullptr, SkExecutor::GetDefault() runs them
+    */
+    void decodeImagesAhead(SkExecutor* executor) const;
+
     /** Returns cull SkRect for this picture, passed in when SkPicture was created.
         Returned SkRect does not specify clipping SkRect for SkPicture; cull is hint
         of SkPicture bounds.
@@ -29,6 +29,7 @@
 class SkCanvas;
 class SkCapabilities;
 class SkDeferredDisplayList;
+class SkExecutor;
 class SkPaint;
 class SkSurfaceCharacterization;
 class GrBackendRenderTarget;
@@ -184,6 +185,28 @@ public:
     static sk_sp<SkSurface> MakeRasterN32Premul(int width, int height,
                                                 const SkSurfaceProps* surfaceProps = nullptr);
 
+    /** Allocates raster SkSurface whose SkCanvas records draws and bins them into tiles by
+        their bounds. When the pixels are next needed (snapshot, read, write or draw of the
+        surface) the tiles are rasterized concurrently on executor. The result is identical to
+        drawing into a surface returned by MakeRaster().
+
+        Allocates and zeroes pixel memory. Pixel memory size is imageInfo.height() times
+        imageInfo.minRowBytes(). Pixel memory is deleted when SkSurface is deleted.
+
+        If executor is nullptr, the returned surface draws on the calling thread, like
+        MakeRaster(). The executor must outlive the surface and any surfaces made from it.
+
+        @param imageInfo  width, height, SkColorType, SkAlphaType, SkColorSpace,
+                          of raster surface; width and height must be greater than zero
+        @param executor   runs the tile rasterization; may be nullptr
+        @param props      LCD striping orientation and setting for device independent fonts;
+                          may be nullptr
+        @return           SkSurface if all parameters are valid; otherwise, nullptr
+    */
+    static sk_sp<SkSurface> MakeRasterThreaded(const SkImageInfo& imageInfo,
+                                               SkExecutor* executor,
+                                               const SkSurfaceProps* props = nullptr);
+
     /** Caller data passed to RenderTarget/TextureReleaseProc; may be nullptr. */
     typedef void* ReleaseContext;
 
@@ -134,10 +134,13 @@ struct Metadata {
     /** Executor to handle threaded work within PDF Backend. If this is nullptr,
         then all work will be done serially on the main thread. To have worker
         threads assist with various tasks, set this to a valid SkExecutor
-        instance. Currently used for executing Deflate algorithm in parallel.
+        instance. Currently used for executing Deflate algorithm in parallel,
+        and by SkDocument::drawPages() to draw several pages at once.
 
         If set, the PDF output will be non-reproducible in the order and
-        internal numbering of objects, but should render the same.
+        internal numbering of objects, but should render the same. Drawing
+        pages at once does not change either: the objects and their numbers
+        are those that drawing the pages one at a time makes.
 
         Experimental.
     */
@@ -154,6 +157,24 @@ struct Metadata {
         HighButSlow = 9,
     } fCompressionLevel = CompressionLevel::Default;
 
+    /** If true, write a PDF 1.5 document that packs the objects that are not streams into
+        compressed object streams, and indexes them with a cross-reference stream instead
+        of a table. This makes documents smaller, most of all those with a lot of text, but
+        readers that only support PDF 1.4 cannot open them.
+
+        Experimental.
+    */
+    bool fObjectStreams = false;
+
+    /** If true, images and layers with the same content are written once, even if they are
+        different SkImage objects or come from different pictures. Images are compared by
+        their encoded data or raster pixels, so this costs a hash of each; lazily generated
+        images that are not encoded are compared by their unique IDs, as they always are.
+
+        Experimental.
+    */
+    bool fDeduplicateByContent = false;
+
     /** Preferred Subsetter. Only respected if both are compiled in.
 
         The Sfntly subsetter is deprecated.
@@ -10,6 +10,7 @@
 
 #include "include/encode/SkEncoder.h"
 
+class SkExecutor;
 class SkJpegEncoderMgr;
 class SkWStream;
 struct skcms_ICCProfile;
@@ -72,6 +73,17 @@ public:
          */
         const skcms_ICCProfile* fICCProfile = nullptr;
         const char* fICCProfileDescription = nullptr;
+
+        /**
+         *  If set, Encode() splits the image into bands of MCU rows separated by restart
+         *  markers, and color converts, transforms and entropy codes the bands concurrently on
+         *  this executor.  The bands share libjpeg-turbo's standard Huffman tables rather than
+         *  tables optimized for the image, so the file is usually a little larger, but it
+         *  decodes to exactly the same pixels as a single threaded encode.
+         *
+         *  Encoders created by Make() ignore this and encode rows as they are given.
+         */
+        SkExecutor* fExecutor = nullptr;
     };
 
     /**
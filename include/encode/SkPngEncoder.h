@@ -11,6 +11,7 @@
 #include "include/core/SkDataTable.h"
 #include "include/encode/SkEncoder.h"
 
+class SkExecutor;
 class SkPngEncoderMgr;
 class SkWStream;
 struct skcms_ICCProfile;
@@ -70,6 +71,17 @@ public:
          */
         const skcms_ICCProfile* fICCProfile = nullptr;
         const char* fICCProfileDescription = nullptr;
+
+        /**
+         *  If set, Encode() filters and compresses horizontal strips of the image concurrently
+         *  on this executor.  Each strip is deflated separately, primed with the end of the
+         *  strip above it, and flushed to a byte boundary so the strips join into one zlib
+         *  stream.  The result is still a standard png, usually within a few percent of the
+         *  single threaded size.
+         *
+         *  Encoders created by Make() ignore this and encode rows as they are given.
+         */
+        SkExecutor* fExecutor = nullptr;
     };
 
     /**
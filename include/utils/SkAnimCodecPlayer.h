@@ -56,11 +56,20 @@ private:
     std::unique_ptr<SkCodec>        fCodec;
     SkImageInfo                     fImageInfo;
     std::vector<SkCodec::FrameInfo> fFrameInfos;
-    std::vector<sk_sp<SkImage> >    fImages;
+    // Composited keyframes are shared through SkResourceCache, under fCacheID. A frame is a
+    // keyframe if it is every kKeyframeInterval'th frame along its chain of required frames,
+    // starting with the frame that is independent, so reaching any frame takes at most
+    // kKeyframeInterval decodes while its keyframe stays in the cache.
+    std::vector<bool>               fKeyframes;
+    uint32_t                        fCacheID = 0;
+    // The most recently returned frame.
+    sk_sp<SkImage>                  fImage;
+    int                             fImageIndex = -1;
     int                             fCurrIndex = 0;
     uint32_t                        fTotalDuration;
 
     sk_sp<SkImage> getFrameAt(int index);
+    sk_sp<SkImage> decodeFrame(int index, const sk_sp<SkImage>& requiredImage);
 };
 
 #endif
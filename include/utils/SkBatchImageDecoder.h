@@ -0,0 +1,76 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBatchImageDecoder_DEFINED
+#define SkBatchImageDecoder_DEFINED
+
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkSpan.h"
+#include "include/core/SkTypes.h"
+
+#include <cstddef>
+#include <functional>
+
+class SkData;
+class SkExecutor;
+class SkImage;
+
+/**
+ *  Decodes a batch of encoded images concurrently, keeping the memory held by decoded pixels
+ *  that have not been handed back yet within a budget.
+ */
+namespace SkBatchImageDecoder {
+
+struct Options {
+    /**
+     *  If not empty, each image is scaled to fit within this size, keeping its aspect ratio.
+     *  The image is decoded at the smallest size its codec reaches without a full size
+     *  intermediate that is at least that large: natively, as JPEG and WebP do, or by
+     *  averaging blocks of pixels as rows are decoded. Images are never scaled up.
+     *
+     *  The size applies after the image's EXIF orientation, which is always applied.
+     */
+    SkISize     fTargetSize = {0, 0};
+
+    /**
+     *  The requested color type. A codec may decode to a compatible one instead, e.g. gray
+     *  images to kGray_8_SkColorType when asked for kRGB_565_SkColorType.
+     */
+    SkColorType fColorType = kN32_SkColorType;
+
+    /**
+     *  Decodes start ahead of the callback while the pixels of decodes that are running, or
+     *  finished but not yet passed to the callback, fit in this many bytes. One decode always
+     *  runs, however large it is.
+     */
+    size_t      fByteBudget = 64 * 1024 * 1024;
+};
+
+/**
+ *  Called once for each encoded image, with its index and the decoded image, or nullptr if it
+ *  could not be decoded. Images that are truncated or contain errors are returned with the
+ *  missing pixels filled, as SkCodec does.
+ */
+using Callback = std::function<void(int index, sk_sp<SkImage> image)>;
+
+/**
+ *  Decodes every image in encoded on executor, or on SkExecutor::GetDefault() if it is nullptr,
+ *  and passes each to callback as it finishes. Returns once callback has been called for all of
+ *  them.
+ *
+ *  callback is always called on the calling thread, one image at a time, in the order the
+ *  images finish rather than their order in encoded. Decodes that have started keep running
+ *  while it runs, but no more start until it returns.
+ */
+SK_API void Decode(SkSpan<const sk_sp<SkData>> encoded, SkExecutor* executor,
+                   const Options& options, const Callback& callback);
+
+}  // namespace SkBatchImageDecoder
+
+#endif  // SkBatchImageDecoder_DEFINED
@@ -211,6 +211,7 @@ SKIA_PUBLIC_HDRS = [
     "include/sksl/SkSLVersion.h",
     "include/utils/SkAnimCodecPlayer.h",
     "include/utils/SkBase64.h",
+    "include/utils/SkBatchImageDecoder.h",
     "include/utils/SkCanvasStateUtils.h",
     "include/utils/SkCustomTypeface.h",
     "include/utils/SkEventTracer.h",
@@ -1228,6 +1229,7 @@ BASE_SRCS_ALL = [
     "src/opts/SkBlitMask_opts.h",
     "src/opts/SkBlitRow_opts.h",
     "src/opts/SkChecksum_opts.h",
+    "src/opts/SkMipmap_opts.h",
     "src/opts/SkRasterPipeline_opts.h",
     "src/opts/SkSwizzler_opts.h",
     "src/opts/SkUtils_opts.h",
@@ -1337,6 +1339,8 @@ BASE_SRCS_ALL = [
     "src/pdf/SkPDFUnion.h",
     "src/pdf/SkPDFUtils.cpp",
     "src/pdf/SkPDFUtils.h",
+    "src/pdf/SkPngInfo.cpp",
+    "src/pdf/SkPngInfo.h",
     "src/pdf/SkUUID.h",
     "src/sfnt/SkIBMFamilyClass.h",
     "src/sfnt/SkOTTableTypes.h",
@@ -1624,6 +1628,7 @@ BASE_SRCS_ALL = [
     "src/text/StrikeForGPU.h",
     "src/utils/SkAnimCodecPlayer.cpp",
     "src/utils/SkBase64.cpp",
+    "src/utils/SkBatchImageDecoder.cpp",
     "src/utils/SkBitSet.h",
     "src/utils/SkBlitterTrace.h",
     "src/utils/SkBlitterTraceCommon.h",
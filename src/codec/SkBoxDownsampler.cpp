@@ -0,0 +1,196 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/codec/SkBoxDownsampler.h"
+
+#include "include/core/SkColorType.h"
+#include "include/private/SkVx.h"
+#include "src/codec/SkCodecPriv.h"
+
+#include <algorithm>
+
+// Box i covers [box_start(i), box_start(i + 1)) of the source.
+static int box_start(int i, int srcLength, int dstLength) {
+    return (int)((int64_t)i * srcLength / dstLength);
+}
+
+// The box that source coordinate x falls in.
+static int box_index(int x, int srcLength, int dstLength) {
+    return (int)(((int64_t)(x + 1) * dstLength - 1) / srcLength);
+}
+
+static int channel_count(SkColorType colorType) {
+    switch (colorType) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+        case kRGBA_F16_SkColorType:
+            return 4;
+        case kRGB_565_SkColorType:
+            return 3;
+        case kGray_8_SkColorType:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+std::unique_ptr<SkBoxDownsampler> SkBoxDownsampler::Make(const SkImageInfo& dstInfo, void* dst,
+                                                         size_t rowBytes, SkISize srcSize) {
+    if (!channel_count(dstInfo.colorType()) || dstInfo.alphaType() == kUnpremul_SkAlphaType) {
+        return nullptr;
+    }
+    if (dstInfo.isEmpty() || srcSize.width() < dstInfo.width() ||
+        srcSize.height() < dstInfo.height()) {
+        return nullptr;
+    }
+
+    // The integer sums must not overflow, even for the largest box.
+    const int64_t maxBoxWidth  = (srcSize.width()  + dstInfo.width()  - 1) / dstInfo.width(),
+                  maxBoxHeight = (srcSize.height() + dstInfo.height() - 1) / dstInfo.height();
+    if (maxBoxWidth * maxBoxHeight > (int64_t)(UINT32_MAX / 255)) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<SkBoxDownsampler>(
+            new SkBoxDownsampler(dstInfo, dst, rowBytes, srcSize));
+}
+
+SkBoxDownsampler::SkBoxDownsampler(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                   SkISize srcSize)
+    : fDstInfo(dstInfo)
+    , fDst(dst)
+    , fRowBytes(rowBytes)
+    , fSrcSize(srcSize)
+    , fChannels(channel_count(dstInfo.colorType()))
+    , fSrcRow(dstInfo.bytesPerPixel() * (size_t)srcSize.width())
+    , fColumns(srcSize.width())
+    , fColumnWidths(dstInfo.width())
+{
+    const int dstWidth = dstInfo.width();
+    for (int x = 0; x < srcSize.width(); ++x) {
+        fColumns[x] = box_index(x, srcSize.width(), dstWidth);
+    }
+    for (int x = 0; x < dstWidth; ++x) {
+        fColumnWidths[x] = box_start(x + 1, srcSize.width(), dstWidth) -
+                           box_start(x,     srcSize.width(), dstWidth);
+    }
+
+    if (dstInfo.colorType() == kRGBA_F16_SkColorType) {
+        fFloatSums.resize(fChannels * dstWidth);
+    } else {
+        fSums.resize(fChannels * dstWidth);
+    }
+}
+
+bool SkBoxDownsampler::accumulateRow(int y) {
+    SkASSERT(0 <= y && y < fSrcSize.height());
+    const int width = fSrcSize.width();
+    const int* columns = fColumns.data();
+
+    switch (fDstInfo.colorType()) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType: {
+            const uint8_t* src = fSrcRow.get();
+            for (int x = 0; x < width; ++x) {
+                uint32_t* sum = &fSums[4 * columns[x]];
+                sum[0] += src[0];
+                sum[1] += src[1];
+                sum[2] += src[2];
+                sum[3] += src[3];
+                src += 4;
+            }
+            break;
+        }
+        case kRGB_565_SkColorType: {
+            const uint16_t* src = reinterpret_cast<const uint16_t*>(fSrcRow.get());
+            for (int x = 0; x < width; ++x) {
+                uint32_t* sum = &fSums[3 * columns[x]];
+                sum[0] += (src[x] >> 11);
+                sum[1] += (src[x] >>  5) & 63;
+                sum[2] += (src[x]      ) & 31;
+            }
+            break;
+        }
+        case kGray_8_SkColorType: {
+            const uint8_t* src = fSrcRow.get();
+            for (int x = 0; x < width; ++x) {
+                fSums[columns[x]] += src[x];
+            }
+            break;
+        }
+        case kRGBA_F16_SkColorType: {
+            const uint16_t* src = reinterpret_cast<const uint16_t*>(fSrcRow.get());
+            for (int x = 0; x < width; ++x) {
+                float* sum = &fFloatSums[4 * columns[x]];
+                (skvx::float4::Load(sum) + skvx::from_half(skvx::Vec<4,uint16_t>::Load(src)))
+                        .store(sum);
+                src += 4;
+            }
+            break;
+        }
+        default:
+            SkASSERT(false);
+            break;
+    }
+
+    const int dstY = box_index(y, fSrcSize.height(), fDstInfo.height());
+    const int boxHeight = box_start(dstY + 1, fSrcSize.height(), fDstInfo.height()) -
+                          box_start(dstY,     fSrcSize.height(), fDstInfo.height());
+    if (++fBoxRows < boxHeight) {
+        return false;
+    }
+
+    this->writeRow(dstY, boxHeight);
+    std::fill(fSums.begin(), fSums.end(), 0);
+    std::fill(fFloatSums.begin(), fFloatSums.end(), 0.0f);
+    fBoxRows = 0;
+    fRowsWritten++;
+    return true;
+}
+
+void SkBoxDownsampler::writeRow(int dstY, int boxHeight) {
+    void* dst = SkTAddOffset<void>(fDst, fRowBytes * dstY);
+    const int width = fDstInfo.width();
+
+    if (fDstInfo.colorType() == kRGBA_F16_SkColorType) {
+        uint16_t* d = static_cast<uint16_t*>(dst);
+        for (int x = 0; x < width; ++x) {
+            const float scale = 1.0f / (fColumnWidths[x] * boxHeight);
+            skvx::to_half(skvx::float4::Load(&fFloatSums[4 * x]) * scale).store(d);
+            d += 4;
+        }
+        return;
+    }
+
+    for (int x = 0; x < width; ++x) {
+        const uint32_t area = fColumnWidths[x] * boxHeight;
+        const uint32_t* sum = &fSums[fChannels * x];
+        auto average = [=](int c) { return (sum[c] + area / 2) / area; };
+
+        switch (fDstInfo.colorType()) {
+            case kRGBA_8888_SkColorType:
+            case kBGRA_8888_SkColorType: {
+                uint8_t* d = static_cast<uint8_t*>(dst) + 4 * x;
+                d[0] = (uint8_t)average(0);
+                d[1] = (uint8_t)average(1);
+                d[2] = (uint8_t)average(2);
+                d[3] = (uint8_t)average(3);
+                break;
+            }
+            case kRGB_565_SkColorType:
+                static_cast<uint16_t*>(dst)[x] =
+                        (uint16_t)(average(0) << 11 | average(1) << 5 | average(2));
+                break;
+            case kGray_8_SkColorType:
+                static_cast<uint8_t*>(dst)[x] = (uint8_t)average(0);
+                break;
+            default:
+                SkASSERT(false);
+                break;
+        }
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBoxDownsampler_DEFINED
+#define SkBoxDownsampler_DEFINED
+
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkSize.h"
+#include "include/private/SkTemplates.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ *  Downscales an image by averaging boxes of its pixels, one decoded row at a time.
+ *
+ *  The source is split into dstInfo.width() x dstInfo.height() boxes with integer bounds, so
+ *  every source pixel contributes to exactly one destination pixel. A codec decodes each source
+ *  row into srcRow(), in the destination's color type, and then calls accumulateRow(). Only that
+ *  row and one row of sums are held, no matter how tall the boxes are.
+ */
+class SkBoxDownsampler {
+public:
+    /**
+     *  Returns nullptr if dstInfo can't be averaged: the color type must be one SkSampler::Fill()
+     *  handles, and the alpha type must not be unpremul.
+     */
+    static std::unique_ptr<SkBoxDownsampler> Make(const SkImageInfo& dstInfo, void* dst,
+                                                  size_t rowBytes, SkISize srcSize);
+
+    /**
+     *  Memory for one row of srcSize.width() pixels, for the codec to decode into.
+     */
+    void* srcRow() { return fSrcRow.get(); }
+
+    /**
+     *  Adds srcRow() to the sums as source row y. The rows of each box must arrive together,
+     *  which is true of both top down and bottom up decodes. Returns true if that completed a
+     *  box, and so wrote a destination row.
+     */
+    bool accumulateRow(int y);
+
+    int dstHeight() const { return fDstInfo.height(); }
+    int rowsWritten() const { return fRowsWritten; }
+
+private:
+    SkBoxDownsampler(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, SkISize srcSize);
+
+    void writeRow(int dstY, int boxHeight);
+
+    const SkImageInfo       fDstInfo;
+    void* const             fDst;
+    const size_t            fRowBytes;
+    const SkISize           fSrcSize;
+    const int               fChannels;
+
+    SkAutoTMalloc<uint8_t>  fSrcRow;
+    std::vector<int>        fColumns;       // destination column of each source column
+    std::vector<int>        fColumnWidths;  // source columns in each destination column
+    std::vector<uint32_t>   fSums;          // per channel, for 8 bit and 565 color types
+    std::vector<float>      fFloatSums;     // per channel, for F16
+
+    int                     fBoxRows = 0;   // source rows added to the current box
+    int                     fRowsWritten = 0;
+};
+
+#endif  // SkBoxDownsampler_DEFINED
@@ -25,14 +25,20 @@
 #include "modules/skcms/skcms.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkJpegDecoderMgr.h"
+#include "src/codec/SkJpegMCUIndex.h"
 #include "src/codec/SkJpegPriv.h"
 #include "src/codec/SkParseEncodedOrigin.h"
 #include "src/codec/SkSwizzler.h"
+#include "src/core/SkStreamPriv.h"
+#include "src/core/SkTaskGroup.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <csetjmp>
 #include <cstring>
 #include <utility>
+#include <vector>
 
 class SkSampler;
 
@@ -367,6 +373,8 @@ bool SkJpegCodec::onRewind() {
     }
     SkASSERT(nullptr != decoderMgr);
     fDecoderMgr.reset(decoderMgr);
+    fRestartStream.reset();
+    fRestartRow = 0;
 
     fSwizzler.reset(nullptr);
     fSwizzleSrcRow = nullptr;
@@ -485,8 +493,15 @@ bool SkJpegCodec::onDimensionsSupported(const SkISize& size) {
 
 int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count,
                           const Options& opts) {
+    return this->readRows(fDecoderMgr.get(), fSwizzleSrcRow, fColorXformSrcRow,
+                          dstInfo, dst, rowBytes, count, opts);
+}
+
+int SkJpegCodec::readRows(JpegDecoderMgr* decoderMgr, uint8_t* swizzleSrcRow,
+                          uint32_t* colorXformSrcRow, const SkImageInfo& dstInfo, void* dst,
+                          size_t rowBytes, int count, const Options& opts) const {
     // Set the jump location for libjpeg-turbo errors
-    skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr->errorMgr());
     if (setjmp(jmp)) {
         return 0;
     }
@@ -504,25 +519,25 @@ int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes
     size_t decodeDstRowBytes = rowBytes;
     size_t swizzleDstRowBytes = rowBytes;
     int dstWidth = opts.fSubset ? opts.fSubset->width() : dstInfo.width();
-    if (fSwizzleSrcRow && fColorXformSrcRow) {
-        decodeDst = (JSAMPLE*) fSwizzleSrcRow;
-        swizzleDst = fColorXformSrcRow;
+    if (swizzleSrcRow && colorXformSrcRow) {
+        decodeDst = (JSAMPLE*) swizzleSrcRow;
+        swizzleDst = colorXformSrcRow;
         decodeDstRowBytes = 0;
         swizzleDstRowBytes = 0;
         dstWidth = fSwizzler->swizzleWidth();
-    } else if (fColorXformSrcRow) {
-        decodeDst = (JSAMPLE*) fColorXformSrcRow;
-        swizzleDst = fColorXformSrcRow;
+    } else if (colorXformSrcRow) {
+        decodeDst = (JSAMPLE*) colorXformSrcRow;
+        swizzleDst = colorXformSrcRow;
         decodeDstRowBytes = 0;
         swizzleDstRowBytes = 0;
-    } else if (fSwizzleSrcRow) {
-        decodeDst = (JSAMPLE*) fSwizzleSrcRow;
+    } else if (swizzleSrcRow) {
+        decodeDst = (JSAMPLE*) swizzleSrcRow;
         decodeDstRowBytes = 0;
         dstWidth = fSwizzler->swizzleWidth();
     }
 
     for (int y = 0; y < count; y++) {
-        uint32_t lines = jpeg_read_scanlines(fDecoderMgr->dinfo(), &decodeDst, 1);
+        uint32_t lines = jpeg_read_scanlines(decoderMgr->dinfo(), &decodeDst, 1);
         if (0 == lines) {
             return y;
         }
@@ -581,6 +596,10 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
     }
 
+    if (options.fExecutor && this->decodeBands(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
+    }
+
     if (!jpeg_start_decompress(dinfo)) {
         return fDecoderMgr->returnFailure("startDecompress", kInvalidInput);
     }
@@ -607,14 +626,14 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
-bool SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
+size_t SkJpegCodec::storageBytes(const SkImageInfo& dstInfo, size_t* swizzleBytes) const {
     int dstWidth = dstInfo.width();
 
-    size_t swizzleBytes = 0;
+    *swizzleBytes = 0;
     if (fSwizzler) {
-        swizzleBytes = get_row_bytes(fDecoderMgr->dinfo());
+        *swizzleBytes = get_row_bytes(fDecoderMgr->dinfo());
         dstWidth = fSwizzler->swizzleWidth();
-        SkASSERT(!this->colorXform() || SkIsAlign4(swizzleBytes));
+        SkASSERT(!this->colorXform() || SkIsAlign4(*swizzleBytes));
     }
 
     size_t xformBytes = 0;
@@ -623,18 +642,139 @@ bool SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
         xformBytes = dstWidth * sizeof(uint32_t);
     }
 
-    size_t totalBytes = swizzleBytes + xformBytes;
+    return *swizzleBytes + xformBytes;
+}
+
+bool SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
+    size_t swizzleBytes;
+    size_t totalBytes = this->storageBytes(dstInfo, &swizzleBytes);
     if (totalBytes > 0) {
         if (!fStorage.reset(totalBytes)) {
             return false;
         }
         fSwizzleSrcRow = (swizzleBytes > 0) ? fStorage.get() : nullptr;
-        fColorXformSrcRow = (xformBytes > 0) ?
+        fColorXformSrcRow = (totalBytes > swizzleBytes) ?
                 SkTAddOffset<uint32_t>(fStorage.get(), swizzleBytes) : nullptr;
     }
     return true;
 }
 
+// Bands smaller than this (in pixels) cost more to set up than their parallelism saves.
+static constexpr int kMinBandPixels = 256 * 1024;
+
+bool SkJpegCodec::decodeBands(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                              const Options& options) {
+    // Every band reads the encoded data independently, so it has to be in memory.
+    SkStream* stream = this->stream();
+    const void* memoryBase = stream->getMemoryBase();
+    if (!memoryBase || !stream->hasLength()) {
+        return false;
+    }
+    const size_t length = stream->getLength();
+    if (!fMCUIndex && !fTriedMCUIndex) {
+        fTriedMCUIndex = true;
+        fMCUIndex = SkJpegMCUIndex::Make(memoryBase, length);
+    }
+    if (!fMCUIndex) {
+        return false;
+    }
+
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    jpeg_calc_output_dimensions(dinfo);
+    const int height = (int)dinfo->output_height;
+    SkASSERT(height == dstInfo.height());
+
+    // Each band after the first starts at an indexed row, but like a seek in onSkipScanlines(),
+    // its first MCU row lacks the chroma above it for fancy upsampling. So the band above
+    // writes one MCU row further, and every band decodes (and discards) one MCU row it doesn't
+    // write.
+    const unsigned num = dinfo->scale_num, denom = dinfo->scale_denom;
+    const int mcuRows = (int)(fMCUIndex->mcuHeight() * num / denom);
+    const int minBandRows = std::max(2 * mcuRows, kMinBandPixels / std::max(1, dstInfo.width()));
+    std::vector<const SkJpegMCUIndex::Entry*> bandStarts = {nullptr};
+    std::vector<int> bandRows = {0};
+    for (const SkJpegMCUIndex::Entry& entry : fMCUIndex->entries()) {
+        const int row = (int)((uint64_t)entry.fRow * num / denom);
+        if (row - bandRows.back() >= minBandRows && height - row >= minBandRows) {
+            bandStarts.push_back(&entry);
+            bandRows.push_back(row);
+        }
+    }
+    const int bandCount = SkToInt(bandStarts.size());
+    if (bandCount < 2) {
+        return false;
+    }
+
+    if (needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
+                                            this->getEncodedInfo().profile(), this->colorXform())) {
+        this->initializeSwizzler(dstInfo, options, true);
+    }
+    size_t swizzleBytes;
+    const size_t totalBytes = this->storageBytes(dstInfo, &swizzleBytes);
+
+    std::atomic<bool> failed{false};
+    auto decodeBand = [&](int i) {
+        const int firstRow = bandRows[i];
+        const int writeTop = i == 0 ? 0 : firstRow + mcuRows;
+        const int writeBottom = i + 1 < bandCount ? bandRows[i + 1] + mcuRows : height;
+
+        SkMemoryStream memory(memoryBase, length, /*copyData=*/false);
+        std::unique_ptr<SkStream> restartStream;
+        if (bandStarts[i]) {
+            restartStream = fMCUIndex->makeStream(&memory, *bandStarts[i]);
+            if (!restartStream) {
+                failed = true;
+                return;
+            }
+        }
+        JpegDecoderMgr decoderMgr(restartStream ? restartStream.get() : &memory);
+        SkAutoTMalloc<uint8_t> storage(totalBytes);
+        {
+            skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr.errorMgr());
+            if (setjmp(jmp)) {
+                failed = true;
+                return;
+            }
+
+            decoderMgr.init();
+            jpeg_decompress_struct* bandInfo = decoderMgr.dinfo();
+            if (jpeg_read_header(bandInfo, true) != JPEG_HEADER_OK) {
+                failed = true;
+                return;
+            }
+            bandInfo->out_color_space = dinfo->out_color_space;
+            bandInfo->dither_mode = dinfo->dither_mode;
+            bandInfo->scale_num = num;
+            bandInfo->scale_denom = denom;
+            if (!jpeg_start_decompress(bandInfo)) {
+                failed = true;
+                return;
+            }
+            SkASSERT(bandInfo->output_width == dinfo->output_width);
+            const int skip = writeTop - firstRow;
+            if ((int)jpeg_skip_scanlines(bandInfo, skip) != skip) {
+                failed = true;
+                return;
+            }
+        }
+
+        uint8_t* swizzleSrcRow = swizzleBytes > 0 ? storage.get() : nullptr;
+        uint32_t* colorXformSrcRow = totalBytes > swizzleBytes
+                ? SkTAddOffset<uint32_t>(storage.get(), swizzleBytes) : nullptr;
+        const int count = writeBottom - writeTop;
+        if (this->readRows(&decoderMgr, swizzleSrcRow, colorXformSrcRow, dstInfo,
+                           SkTAddOffset<void>(dst, writeTop * rowBytes), rowBytes, count,
+                           options) != count) {
+            failed = true;
+        }
+    };
+
+    SkTaskGroup tasks(*options.fExecutor);
+    tasks.batch(bandCount, decodeBand);
+    tasks.wait();
+    return !failed;
+}
+
 void SkJpegCodec::initializeSwizzler(const SkImageInfo& dstInfo, const Options& options,
         bool needsCMYKToRGB) {
     Options swizzlerOptions = options;
@@ -775,6 +915,10 @@ int SkJpegCodec::onGetScanlines(void* dst, int count, size_t dstRowBytes) {
 }
 
 bool SkJpegCodec::onSkipScanlines(int count) {
+    if (fMCUIndex) {
+        this->seekWithMCUIndex(&count);
+    }
+
     // Set the jump location for libjpeg errors
     skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
     if (setjmp(jmp)) {
@@ -784,6 +928,115 @@ bool SkJpegCodec::onSkipScanlines(int count) {
     return (uint32_t) count == jpeg_skip_scanlines(fDecoderMgr->dinfo(), count);
 }
 
+sk_sp<SkData> SkJpegCodec::buildMCUIndex() {
+    SkStream* stream = this->stream();
+    if (!stream->hasPosition()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkJpegMCUIndex> index;
+    if (stream->getMemoryBase() && stream->hasLength()) {
+        index = SkJpegMCUIndex::Make(stream->getMemoryBase(), stream->getLength());
+    } else {
+        const size_t position = stream->getPosition();
+        if (!stream->seek(0)) {
+            return nullptr;
+        }
+        sk_sp<SkData> data = SkCopyStreamToData(stream);
+        if (!stream->seek(position)) {
+            return nullptr;
+        }
+        index = SkJpegMCUIndex::Make(data->data(), data->size());
+    }
+    if (!index) {
+        return nullptr;
+    }
+
+    sk_sp<SkData> serialized = index->serialize();
+    fMCUIndex = std::move(index);
+    return serialized;
+}
+
+bool SkJpegCodec::setMCUIndex(const SkData& data) {
+    std::unique_ptr<SkJpegMCUIndex> index = SkJpegMCUIndex::Deserialize(data.data(), data.size());
+    if (!index || !index->matches(this->stream())) {
+        return false;
+    }
+    fMCUIndex = std::move(index);
+    return true;
+}
+
+void SkJpegCodec::seekWithMCUIndex(int* count) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+
+    // libjpeg-turbo scales by num/denom, where denom is 8 and every MCU row is a multiple of 8
+    // rows tall, so an MCU row's first row always maps to a whole output row.
+    const unsigned num = dinfo->scale_num, denom = dinfo->scale_denom;
+    const int currentRow = fRestartRow + (int)dinfo->output_scanline;
+    const int targetRow = currentRow + *count;
+
+    // Fancy upsampling blends chroma with the MCU row above, which a restarted decode doesn't
+    // have, so restart at least one MCU row above the target and skip down to it.
+    const int targetSrcRow = (int)((uint64_t)targetRow * denom / num);
+    const SkJpegMCUIndex::Entry* entry =
+            fMCUIndex->findEntry(targetSrcRow - fMCUIndex->mcuHeight());
+    if (!entry) {
+        return;
+    }
+    const int entryRow = (int)((uint64_t)entry->fRow * num / denom);
+    if (entryRow <= currentRow) {
+        return;
+    }
+
+    // The current decoder reads from the same stream, so put it back if we can't seek.
+    SkStream* stream = this->stream();
+    const size_t position = stream->getPosition();
+    std::unique_ptr<SkStream> restartStream = fMCUIndex->makeStream(stream, *entry);
+    if (!restartStream) {
+        stream->seek(position);
+        return;
+    }
+
+    std::unique_ptr<JpegDecoderMgr> decoderMgr(new JpegDecoderMgr(restartStream.get()));
+    {
+        skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr->errorMgr());
+        if (setjmp(jmp)) {
+            SkCodecPrintf("Failed to seek with the MCU index.\n");
+            stream->seek(position);
+            return;
+        }
+
+        decoderMgr->init();
+        jpeg_decompress_struct* restartInfo = decoderMgr->dinfo();
+        if (jpeg_read_header(restartInfo, true) != JPEG_HEADER_OK) {
+            stream->seek(position);
+            return;
+        }
+
+        // Match the settings made by conversionSupported(), onDimensionsSupported() and
+        // onStartScanlineDecode(), so the rows come out exactly as they would have.
+        restartInfo->out_color_space = dinfo->out_color_space;
+        restartInfo->dither_mode = dinfo->dither_mode;
+        restartInfo->scale_num = num;
+        restartInfo->scale_denom = denom;
+        if (!jpeg_start_decompress(restartInfo)) {
+            stream->seek(position);
+            return;
+        }
+        if (this->options().fSubset) {
+            uint32_t startX = this->options().fSubset->x();
+            uint32_t width = this->options().fSubset->width();
+            jpeg_crop_scanline(restartInfo, &startX, &width);
+        }
+        SkASSERT(restartInfo->output_width == dinfo->output_width);
+    }
+
+    fDecoderMgr = std::move(decoderMgr);
+    fRestartStream = std::move(restartStream);
+    fRestartRow = entryRow;
+    *count = targetRow - entryRow;
+}
+
 static bool is_yuv_supported(const jpeg_decompress_struct* dinfo,
                              const SkJpegCodec& codec,
                              const SkYUVAPixmapInfo::SupportedDataTypes* supportedDataTypes,
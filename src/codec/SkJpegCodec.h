@@ -25,6 +25,7 @@
 
 class JpegDecoderMgr;
 class SkData;
+class SkJpegMCUIndex;
 class SkSampler;
 class SkStream;
 class SkSwizzler;
@@ -47,6 +48,22 @@ public:
      */
     static std::unique_ptr<SkCodec> MakeFromStream(std::unique_ptr<SkStream>, Result*);
 
+    /*
+     * Builds an index of the restart markers at MCU row boundaries, which lets skipScanlines()
+     * start decoding at an indexed row instead of entropy decoding every row above it.
+     *
+     * Returns the index serialized, so it can be stored alongside the image and given to
+     * setMCUIndex() by later codecs for the same data, or nullptr if this jpeg can't be indexed
+     * (e.g. it has no restart markers, or is progressive) or the stream can't seek.
+     */
+    sk_sp<SkData> buildMCUIndex();
+
+    /*
+     * Uses an index returned by buildMCUIndex(). Returns false if it is malformed or was built
+     * from a different image.
+     */
+    bool setMCUIndex(const SkData& index);
+
 protected:
 
     /*
@@ -128,7 +145,20 @@ private:
     void initializeSwizzler(const SkImageInfo& dstInfo, const Options& options,
                             bool needsCMYKToRGB);
     bool SK_WARN_UNUSED_RESULT allocateStorage(const SkImageInfo& dstInfo);
+    // Returns the bytes of scratch rows readRows() needs, the first swizzleBytes of which are for
+    // the swizzler's source row and the rest for the color xform's.
+    size_t storageBytes(const SkImageInfo& dstInfo, size_t* swizzleBytes) const;
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
+    int readRows(JpegDecoderMgr*, uint8_t* swizzleSrcRow, uint32_t* colorXformSrcRow,
+                 const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count,
+                 const Options&) const;
+
+    /*
+     * Decodes the image in bands that start at indexed restart markers, concurrently on
+     * options.fExecutor. Returns false, without having started fDecoderMgr, if the image can't
+     * be split or a band fails; the caller then decodes it serially.
+     */
+    bool decodeBands(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, const Options&);
 
     /*
      * Scanline decoding.
@@ -139,6 +169,20 @@ private:
     int onGetScanlines(void* dst, int count, size_t rowBytes) override;
     bool onSkipScanlines(int count) override;
 
+    /*
+     * If fMCUIndex has a row between the current row and the one count rows below it, restarts
+     * decoding at that row and reduces count to the rows left to skip.
+     */
+    void seekWithMCUIndex(int* count);
+
+    std::unique_ptr<SkJpegMCUIndex>    fMCUIndex;
+    bool                               fTriedMCUIndex = false;
+
+    // After a seek, fDecoderMgr reads the image from fRestartRow on through this stream.
+    // Declared first so it outlives fDecoderMgr.
+    std::unique_ptr<SkStream>          fRestartStream;
+    int                                fRestartRow = 0;  // in output rows
+
     std::unique_ptr<JpegDecoderMgr>    fDecoderMgr;
 
     // We will save the state of the decompress struct after reading the header.
@@ -0,0 +1,298 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/codec/SkJpegMCUIndex.h"
+
+#include "include/core/SkStream.h"
+#include "include/private/base/SkTo.h"
+#include "src/codec/SkCodecPriv.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr uint8_t kMarkerSOI  = 0xD8,
+                  kMarkerSOS  = 0xDA,
+                  kMarkerDRI  = 0xDD,
+                  kMarkerRST0 = 0xD0,
+                  kMarkerSOF0 = 0xC0,  // baseline
+                  kMarkerSOF1 = 0xC1,  // extended sequential, Huffman
+                  kMarkerDHT  = 0xC4,
+                  kMarkerJPG  = 0xC8,
+                  kMarkerDAC  = 0xCC;
+
+bool is_rst(uint8_t marker) { return (marker & 0xF8) == kMarkerRST0; }
+
+// Any start of frame other than SOF0 and SOF1 is progressive, lossless, hierarchical or
+// arithmetic coded.
+bool is_unsupported_sof(uint8_t marker) {
+    return marker >= kMarkerSOF0 && marker <= 0xCF && marker != kMarkerSOF0 &&
+           marker != kMarkerSOF1 && marker != kMarkerDHT && marker != kMarkerJPG &&
+           marker != kMarkerDAC;
+}
+
+uint32_t read_u16(const uint8_t* p) { return (p[0] << 8) | p[1]; }
+
+constexpr uint32_t kSerialMagic   = SkSetFourByteTag('s', 'k', 'j', 'i');
+constexpr uint32_t kSerialVersion = 1;
+
+/*
+ * Presents a header, followed by the data in a stream with its RSTn markers renumbered to
+ * count up from RST0.
+ */
+class RestartStream final : public SkStream {
+public:
+    RestartStream(sk_sp<SkData> header, SkStream* src)
+        : fHeader(std::move(header))
+        , fSrc(src) {}
+
+    size_t read(void* buffer, size_t size) override {
+        size_t bytes = std::min(size, fHeader->size() - fHeaderPos);
+        if (buffer) {
+            memcpy(buffer, fHeader->bytes() + fHeaderPos, bytes);
+        }
+        fHeaderPos += bytes;
+        if (bytes == size) {
+            return bytes;
+        }
+
+        if (!buffer) {
+            // libjpeg only skips within marker segments, never within entropy coded data.
+            return bytes + fSrc->skip(size - bytes);
+        }
+        uint8_t* dst = static_cast<uint8_t*>(buffer) + bytes;
+        const size_t read = fSrc->read(dst, size - bytes);
+        for (size_t i = 0; i < read; ++i) {
+            // A marker may be split across reads, so remember if the last byte was 0xFF.
+            if (fAfterFF && is_rst(dst[i])) {
+                dst[i] = kMarkerRST0 | (fNextRestart++ & 7);
+            }
+            fAfterFF = dst[i] == 0xFF;
+        }
+        return bytes + read;
+    }
+
+    bool isAtEnd() const override {
+        return fHeaderPos == fHeader->size() && fSrc->isAtEnd();
+    }
+
+private:
+    sk_sp<SkData> fHeader;
+    SkStream*     fSrc;
+    size_t        fHeaderPos = 0;
+    bool          fAfterFF = false;
+    uint8_t       fNextRestart = 0;
+};
+
+}  // namespace
+
+std::unique_ptr<SkJpegMCUIndex> SkJpegMCUIndex::Make(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    if (size < 4 || bytes[0] != 0xFF || bytes[1] != kMarkerSOI) {
+        return nullptr;
+    }
+
+    // Walk the marker segments up to the start of scan.
+    uint32_t width = 0, height = 0, heightOffset = 0, restartInterval = 0;
+    int componentCount = 0, maxH = 1, maxV = 1;
+    size_t entropyOffset = 0;
+    for (size_t i = 2; !entropyOffset;) {
+        if (i + 4 > size || bytes[i] != 0xFF) {
+            return nullptr;
+        }
+        const uint8_t marker = bytes[i + 1];
+        if (marker == 0xFF) {
+            i++;    // fill byte
+            continue;
+        }
+        const size_t length = read_u16(bytes + i + 2);
+        if (length < 2 || i + 2 + length > size) {
+            return nullptr;
+        }
+        const uint8_t* segment = bytes + i + 4;
+        const size_t segmentLength = length - 2;
+
+        if (marker == kMarkerSOF0 || marker == kMarkerSOF1) {
+            if (segmentLength < 6) {
+                return nullptr;
+            }
+            heightOffset = SkToU32(i + 5);
+            height = read_u16(segment + 1);
+            width = read_u16(segment + 3);
+            componentCount = segment[5];
+            if (segmentLength < 6 + 3 * (size_t)componentCount) {
+                return nullptr;
+            }
+            for (int c = 0; c < componentCount; ++c) {
+                const uint8_t factors = segment[6 + 3 * c + 1];
+                maxH = std::max(maxH, factors >> 4);
+                maxV = std::max(maxV, factors & 0xF);
+            }
+        } else if (is_unsupported_sof(marker)) {
+            return nullptr;
+        } else if (marker == kMarkerDRI) {
+            if (segmentLength < 2) {
+                return nullptr;
+            }
+            restartInterval = read_u16(segment);
+        } else if (marker == kMarkerSOS) {
+            // Every component must be in this one scan, or there will be more scans to decode.
+            if (segmentLength < 1 || segment[0] != componentCount) {
+                return nullptr;
+            }
+            entropyOffset = i + 2 + length;
+        }
+        i += 2 + length;
+    }
+    // A zero height in the frame header means it is defined by a DNL marker after the scan.
+    if (!width || !height || !componentCount || !restartInterval) {
+        return nullptr;
+    }
+
+    // A scan of one component isn't interleaved, and its MCU is a single block.
+    const uint32_t mcuWidth  = componentCount == 1 ? 8 : 8 * maxH,
+                   mcuHeight = componentCount == 1 ? 8 : 8 * maxV;
+    const uint32_t mcusPerRow = (width + mcuWidth - 1) / mcuWidth;
+
+    std::unique_ptr<SkJpegMCUIndex> index(new SkJpegMCUIndex);
+    uint64_t interval = 1;
+    for (size_t i = entropyOffset; i + 1 < size;) {
+        const uint8_t* ff = static_cast<const uint8_t*>(memchr(bytes + i, 0xFF, size - i - 1));
+        if (!ff) {
+            break;
+        }
+        i = ff - bytes;
+        const uint8_t marker = bytes[i + 1];
+        if (marker == 0x00) {
+            i += 2;     // a stuffed 0xFF data byte
+        } else if (marker == 0xFF) {
+            i += 1;     // fill byte
+        } else if (is_rst(marker)) {
+            const uint64_t mcu = interval * restartInterval;
+            if (mcu % mcusPerRow == 0) {
+                const uint64_t row = mcu / mcusPerRow * mcuHeight;
+                if (row >= height) {
+                    break;
+                }
+                index->fEntries.push_back({SkToU32(row), i + 2});
+            }
+            interval++;
+            i += 2;
+        } else {
+            // EOI, or some other marker we don't expect in the middle of a single scan.
+            break;
+        }
+    }
+    if (index->fEntries.empty()) {
+        return nullptr;
+    }
+
+    index->fHeight = height;
+    index->fMCUHeight = mcuHeight;
+    index->fHeightOffset = heightOffset;
+    index->fHeader = SkData::MakeWithCopy(bytes, entropyOffset);
+    return index;
+}
+
+sk_sp<SkData> SkJpegMCUIndex::serialize() const {
+    SkDynamicMemoryWStream stream;
+    stream.write32(kSerialMagic);
+    stream.write32(kSerialVersion);
+    stream.write32(fHeight);
+    stream.write32(fMCUHeight);
+    stream.write32(fHeightOffset);
+    stream.write32(SkToU32(fHeader->size()));
+    stream.write(fHeader->data(), fHeader->size());
+    stream.write32(SkToU32(fEntries.size()));
+    for (const Entry& entry : fEntries) {
+        stream.write32(entry.fRow);
+        stream.write32((uint32_t)entry.fOffset);
+        stream.write32((uint32_t)(entry.fOffset >> 32));
+    }
+    return stream.detachAsData();
+}
+
+std::unique_ptr<SkJpegMCUIndex> SkJpegMCUIndex::Deserialize(const void* data, size_t size) {
+    SkMemoryStream stream(data, size, /*copyData=*/false);
+    uint32_t magic, version, headerSize;
+    std::unique_ptr<SkJpegMCUIndex> index(new SkJpegMCUIndex);
+    if (!stream.readU32(&magic) || magic != kSerialMagic ||
+        !stream.readU32(&version) || version != kSerialVersion ||
+        !stream.readU32(&index->fHeight) ||
+        !stream.readU32(&index->fMCUHeight) ||
+        (index->fMCUHeight != 8 && index->fMCUHeight != 16 && index->fMCUHeight != 24 &&
+         index->fMCUHeight != 32) ||
+        !stream.readU32(&index->fHeightOffset) ||
+        !stream.readU32(&headerSize) ||
+        headerSize > stream.getLength() - stream.getPosition() ||
+        index->fHeightOffset + 2 > headerSize) {
+        return nullptr;
+    }
+    index->fHeader = SkData::MakeUninitialized(headerSize);
+    uint32_t entryCount;
+    if (stream.read(index->fHeader->writable_data(), headerSize) != headerSize ||
+        !stream.readU32(&entryCount) ||
+        entryCount == 0 ||
+        entryCount > (stream.getLength() - stream.getPosition()) / 12) {
+        return nullptr;
+    }
+
+    index->fEntries.resize(entryCount);
+    uint32_t lastRow = 0;
+    uint64_t lastOffset = headerSize;
+    for (Entry& entry : index->fEntries) {
+        uint32_t lo, hi;
+        if (!stream.readU32(&entry.fRow) || !stream.readU32(&lo) || !stream.readU32(&hi)) {
+            return nullptr;
+        }
+        entry.fOffset = ((uint64_t)hi << 32) | lo;
+        if (entry.fRow <= lastRow || entry.fRow >= index->fHeight ||
+            entry.fRow % index->fMCUHeight != 0 ||
+            entry.fOffset <= lastOffset) {
+            return nullptr;
+        }
+        lastRow = entry.fRow;
+        lastOffset = entry.fOffset;
+    }
+    return index;
+}
+
+bool SkJpegMCUIndex::matches(SkStream* stream) const {
+    if (!stream->hasPosition()) {
+        return false;
+    }
+    const size_t position = stream->getPosition();
+    sk_sp<SkData> header = SkData::MakeUninitialized(fHeader->size());
+    const bool matches = stream->seek(0) &&
+                         stream->read(header->writable_data(), header->size()) == header->size() &&
+                         header->equals(fHeader.get());
+    return stream->seek(position) && matches;
+}
+
+const SkJpegMCUIndex::Entry* SkJpegMCUIndex::findEntry(int row) const {
+    auto it = std::upper_bound(fEntries.begin(), fEntries.end(), row,
+                               [](int r, const Entry& entry) { return (uint32_t)r < entry.fRow; });
+    return it == fEntries.begin() ? nullptr : &*(it - 1);
+}
+
+std::unique_ptr<SkStream> SkJpegMCUIndex::makeStream(SkStream* src, const Entry& entry) const {
+    // The interval must follow a restart marker; otherwise the stream isn't the one we indexed.
+    uint8_t marker[2];
+    if (entry.fOffset > SIZE_MAX || !src->seek(entry.fOffset - 2) ||
+        src->read(marker, 2) != 2 || marker[0] != 0xFF || !is_rst(marker[1])) {
+        SkCodecPrintf("Jpeg MCU index does not match the stream.\n");
+        return nullptr;
+    }
+
+    sk_sp<SkData> header = SkData::MakeWithCopy(fHeader->data(), fHeader->size());
+    const uint32_t height = fHeight - entry.fRow;
+    uint8_t* heightBytes = static_cast<uint8_t*>(header->writable_data()) + fHeightOffset;
+    heightBytes[0] = (uint8_t)(height >> 8);
+    heightBytes[1] = (uint8_t)height;
+    return std::make_unique<RestartStream>(std::move(header), src);
+}
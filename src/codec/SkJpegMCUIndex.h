@@ -0,0 +1,86 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkJpegMCUIndex_DEFINED
+#define SkJpegMCUIndex_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SkStream;
+
+/*
+ * An index into the entropy coded data of a sequential, Huffman coded, single scan jpeg, at the
+ * restart markers that fall on MCU row boundaries.
+ *
+ * A restart marker resets the DC predictors and byte aligns the entropy coded data, so the
+ * Huffman decoder needs no state from the rows above it. Given an indexed row, makeStream()
+ * presents the jpeg as if it started at that row: the original headers with the frame height
+ * shortened, followed by the original entropy coded data from that row on, with its RSTn
+ * markers renumbered to start from RST0. Decoding that stream produces the same rows the whole
+ * image would, without entropy decoding anything above them.
+ *
+ * Jpegs without restart markers, progressive jpegs, and jpegs whose restart intervals never
+ * start an MCU row can't be indexed.
+ */
+class SkJpegMCUIndex {
+public:
+    struct Entry {
+        uint32_t fRow;      // first image row of the restart interval, a multiple of the MCU height
+        uint64_t fOffset;   // stream offset of the interval's entropy coded data
+    };
+
+    /*
+     * Scans a complete encoded jpeg. Returns nullptr if it can't be indexed.
+     */
+    static std::unique_ptr<SkJpegMCUIndex> Make(const void* data, size_t size);
+
+    /*
+     * Reads an index written by serialize(). Returns nullptr if the data is malformed.
+     */
+    static std::unique_ptr<SkJpegMCUIndex> Deserialize(const void* data, size_t size);
+
+    sk_sp<SkData> serialize() const;
+
+    /*
+     * Returns true if the headers at the start of stream are the ones this index was built
+     * from. Restores the stream's position.
+     */
+    bool matches(SkStream* stream) const;
+
+    /*
+     * Returns the entry for the last indexed row that is <= row, or nullptr if there is none.
+     */
+    const Entry* findEntry(int row) const;
+
+    int mcuHeight() const { return (int)fMCUHeight; }
+
+    const std::vector<Entry>& entries() const { return fEntries; }
+
+    /*
+     * Returns a stream of the jpeg as if it started at entry's row. The returned stream reads
+     * from (and seeks) src, which must outlive it. Returns nullptr if src can't seek to the
+     * entry or doesn't have a restart marker there.
+     */
+    std::unique_ptr<SkStream> makeStream(SkStream* src, const Entry& entry) const;
+
+private:
+    SkJpegMCUIndex() = default;
+
+    uint32_t           fHeight = 0;
+    uint32_t           fMCUHeight = 0;
+    uint32_t           fHeightOffset = 0;  // of the frame height, in fHeader
+    sk_sp<SkData>      fHeader;            // everything before the entropy coded data
+    std::vector<Entry> fEntries;           // sorted by row
+};
+
+#endif
@@ -15,6 +15,9 @@
 #include "include/private/SkColorData.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkMasks.h"
+#include "src/core/SkOpts.h"
+
+#include <utility>
 
 static void swizzle_mask16_to_rgba_opaque(
         void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
@@ -141,6 +144,38 @@ static void swizzle_mask16_to_565(
     }
 }
 
+// Without sampling, 16 and 32 bit pixels unpack to 8888 with SkOpts, a vector at a time.
+template <typename T, bool kSwapRB, SkAlphaType kAlphaType>
+static void fast_swizzle_mask_to_n32(
+        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
+        uint32_t startX, uint32_t sampleX) {
+    SkASSERT(1 == sampleX);
+
+    uint32_t bitfields[4] = {
+        masks->getRedMask(), masks->getGreenMask(), masks->getBlueMask(), masks->getAlphaMask(),
+    };
+    if (kSwapRB) {
+        std::swap(bitfields[0], bitfields[2]);
+    }
+    uint32_t fill = 0;
+    if (kOpaque_SkAlphaType == kAlphaType) {
+        bitfields[3] = 0;
+        fill = 0xFF000000;
+    }
+
+    uint32_t* dstPtr = (uint32_t*) dstRow;
+    const uint8_t* srcPtr = srcRow + sizeof(T) * startX;
+    if (sizeof(T) == 2) {
+        SkOpts::bitfields16_to_8888(dstPtr, srcPtr, width, bitfields, fill);
+    } else {
+        SkOpts::bitfields32_to_8888(dstPtr, srcPtr, width, bitfields, fill);
+    }
+    if (kPremul_SkAlphaType == kAlphaType) {
+        // Premultiplying doesn't care whether red or blue comes first.
+        SkOpts::RGBA_to_rgbA(dstPtr, dstPtr, width);
+    }
+}
+
 static void swizzle_mask24_to_rgba_opaque(
         void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
         uint32_t startX, uint32_t sampleX) {
@@ -396,6 +431,7 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
         const SkCodec::Options& options) {
 
     // Choose the appropriate row procedure
+    RowProc fastProc = nullptr;
     RowProc proc = nullptr;
     switch (bitsPerPixel) {
         case 16:
@@ -403,13 +439,16 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                 case kRGBA_8888_SkColorType:
                     if (srcIsOpaque) {
                         proc = &swizzle_mask16_to_rgba_opaque;
+                        fastProc = &fast_swizzle_mask_to_n32<uint16_t, false, kOpaque_SkAlphaType>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
                                 proc = &swizzle_mask16_to_rgba_unpremul;
+                                fastProc = &fast_swizzle_mask_to_n32<uint16_t, false, kUnpremul_SkAlphaType>;
                                 break;
                             case kPremul_SkAlphaType:
                                 proc = &swizzle_mask16_to_rgba_premul;
+                                fastProc = &fast_swizzle_mask_to_n32<uint16_t, false, kPremul_SkAlphaType>;
                                 break;
                             default:
                                 break;
@@ -419,13 +458,16 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                 case kBGRA_8888_SkColorType:
                     if (srcIsOpaque) {
                         proc = &swizzle_mask16_to_bgra_opaque;
+                        fastProc = &fast_swizzle_mask_to_n32<uint16_t, true, kOpaque_SkAlphaType>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
                                 proc = &swizzle_mask16_to_bgra_unpremul;
+                                fastProc = &fast_swizzle_mask_to_n32<uint16_t, true, kUnpremul_SkAlphaType>;
                                 break;
                             case kPremul_SkAlphaType:
                                 proc = &swizzle_mask16_to_bgra_premul;
+                                fastProc = &fast_swizzle_mask_to_n32<uint16_t, true, kPremul_SkAlphaType>;
                                 break;
                             default:
                                 break;
@@ -485,13 +527,16 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                 case kRGBA_8888_SkColorType:
                     if (srcIsOpaque) {
                         proc = &swizzle_mask32_to_rgba_opaque;
+                        fastProc = &fast_swizzle_mask_to_n32<uint32_t, false, kOpaque_SkAlphaType>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
                                 proc = &swizzle_mask32_to_rgba_unpremul;
+                                fastProc = &fast_swizzle_mask_to_n32<uint32_t, false, kUnpremul_SkAlphaType>;
                                 break;
                             case kPremul_SkAlphaType:
                                 proc = &swizzle_mask32_to_rgba_premul;
+                                fastProc = &fast_swizzle_mask_to_n32<uint32_t, false, kPremul_SkAlphaType>;
                                 break;
                             default:
                                 break;
@@ -501,13 +546,16 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                 case kBGRA_8888_SkColorType:
                     if (srcIsOpaque) {
                         proc = &swizzle_mask32_to_bgra_opaque;
+                        fastProc = &fast_swizzle_mask_to_n32<uint32_t, true, kOpaque_SkAlphaType>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
                                 proc = &swizzle_mask32_to_bgra_unpremul;
+                                fastProc = &fast_swizzle_mask_to_n32<uint32_t, true, kUnpremul_SkAlphaType>;
                                 break;
                             case kPremul_SkAlphaType:
                                 proc = &swizzle_mask32_to_bgra_premul;
+                                fastProc = &fast_swizzle_mask_to_n32<uint32_t, true, kPremul_SkAlphaType>;
                                 break;
                             default:
                                 break;
@@ -526,6 +574,12 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
             return nullptr;
     }
 
+    // A discontiguous mask keeps a shift and size in SkMasks that the fast procs can't recover
+    // from the mask, so those decode with the slow procs.
+    if (!masks->isContiguous()) {
+        fastProc = nullptr;
+    }
+
     int srcOffset = 0;
     int srcWidth = dstInfo.width();
     if (options.fSubset) {
@@ -533,7 +587,7 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
         srcWidth = options.fSubset->width();
     }
 
-    return new SkMaskSwizzler(masks, proc, srcOffset, srcWidth);
+    return new SkMaskSwizzler(masks, fastProc, proc, srcOffset, srcWidth);
 }
 
 /*
@@ -541,9 +595,12 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
  * Constructor for mask swizzler
  *
  */
-SkMaskSwizzler::SkMaskSwizzler(SkMasks* masks, RowProc proc, int srcOffset, int subsetWidth)
+SkMaskSwizzler::SkMaskSwizzler(SkMasks* masks, RowProc fastProc, RowProc proc, int srcOffset,
+                               int subsetWidth)
     : fMasks(masks)
-    , fRowProc(proc)
+    , fFastProc(fastProc)
+    , fSlowProc(proc)
+    , fActualProc(fFastProc ? fFastProc : fSlowProc)
     , fSubsetWidth(subsetWidth)
     , fDstWidth(subsetWidth)
     , fSampleX(1)
@@ -561,6 +618,13 @@ int SkMaskSwizzler::onSetSampleX(int sampleX) {
 
     // check that fX0 is valid
     SkASSERT(fX0 >= 0);
+
+    // As in SkSwizzler, the optimized procs do not support sampling.
+    if (1 == fSampleX && fFastProc) {
+        fActualProc = fFastProc;
+    } else {
+        fActualProc = fSlowProc;
+    }
     return fDstWidth;
 }
 
@@ -571,5 +635,5 @@ int SkMaskSwizzler::onSetSampleX(int sampleX) {
  */
 void SkMaskSwizzler::swizzle(void* dst, const uint8_t* SK_RESTRICT src) {
     SkASSERT(nullptr != dst && nullptr != src);
-    fRowProc(dst, src, fDstWidth, fMasks, fX0, fSampleX);
+    fActualProc(dst, src, fDstWidth, fMasks, fX0, fSampleX);
 }
@@ -58,12 +58,16 @@ private:
     typedef void (*RowProc)(void* dstRow, const uint8_t* srcRow, int width,
             SkMasks* masks, uint32_t startX, uint32_t sampleX);
 
-    SkMaskSwizzler(SkMasks* masks, RowProc proc, int subsetWidth, int srcOffset);
+    SkMaskSwizzler(SkMasks* masks, RowProc fastProc, RowProc proc, int subsetWidth,
+                   int srcOffset);
 
     int onSetSampleX(int) override;
 
     SkMasks*        fMasks;           // unowned
-    const RowProc   fRowProc;
+    // Used when not sampling, or nullptr if there is no faster proc than fSlowProc.
+    const RowProc   fFastProc;
+    const RowProc   fSlowProc;
+    RowProc         fActualProc;
 
     // FIXME: Can this class share more with SkSwizzler? These variables are all the same.
     const int       fSubsetWidth;     // Width of the subset of source before any sampling.
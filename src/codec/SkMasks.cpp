@@ -80,6 +80,15 @@ uint8_t SkMasks::getAlpha(uint32_t pixel) const {
     return get_comp(pixel, fAlpha.mask, fAlpha.shift, fAlpha.size);
 }
 
+static bool is_contiguous(const SkMasks::MaskInfo& info) {
+    return info.mask == (((1u << info.size) - 1) << info.shift);
+}
+
+bool SkMasks::isContiguous() const {
+    return is_contiguous(fRed) && is_contiguous(fGreen) && is_contiguous(fBlue) &&
+           is_contiguous(fAlpha);
+}
+
 /*
  *
  * Process an input mask to obtain the necessary information
@@ -51,6 +51,15 @@ public:
         return fAlpha.mask;
      }
 
+    // Getters for the color masks, truncated to 8 bits, as SkOpts::bitfields*_to_8888 take them
+    uint32_t getRedMask() const { return fRed.mask; }
+    uint32_t getGreenMask() const { return fGreen.mask; }
+    uint32_t getBlueMask() const { return fBlue.mask; }
+
+    // True if each mask is a single run of bits. Only then do the masks alone determine each
+    // component's shift and size, as SkOpts::bitfields*_to_8888 assume.
+    bool isContiguous() const;
+
 private:
     const MaskInfo fRed;
     const MaskInfo fGreen;
@@ -21,6 +21,7 @@
 #include "include/private/SkNoncopyable.h"
 #include "include/private/SkTemplates.h"
 #include "modules/skcms/skcms.h"
+#include "src/codec/SkBoxDownsampler.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkColorTable.h"
 #include "src/codec/SkPngPriv.h"
@@ -511,6 +512,7 @@ public:
         , fRowBytes(0)
         , fFirstRow(0)
         , fLastRow(0)
+        , fBoxDownsampler(nullptr)
     {}
 
     static void AllRowsCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum, int /*pass*/) {
@@ -531,6 +533,9 @@ private:
     int                         fLastRow;
     int                         fRowsNeeded;
 
+    // If set, every row goes to this instead of fDst.
+    SkBoxDownsampler*           fBoxDownsampler;
+
     using INHERITED = SkPngCodec;
 
     static SkPngNormalDecoder* GetDecoder(png_structp png_ptr) {
@@ -574,10 +579,18 @@ private:
         fRowBytes = rowBytes;
         fRowsWrittenToOutput = 0;
         fRowsNeeded = fLastRow - fFirstRow + 1;
+        fBoxDownsampler = nullptr;
+    }
+
+    bool setBoxDownsampler(SkBoxDownsampler* downsampler) override {
+        fBoxDownsampler = downsampler;
+        return true;
     }
 
     Result decode(int* rowsDecoded) override {
-        if (this->swizzler()) {
+        if (fBoxDownsampler) {
+            fRowsNeeded = fBoxDownsampler->dstHeight();
+        } else if (this->swizzler()) {
             const int sampleY = this->swizzler()->sampleY();
             fRowsNeeded = get_scaled_dimension(fLastRow - fFirstRow + 1, sampleY);
         }
@@ -603,8 +616,14 @@ private:
         SkASSERT(rowNum <= fLastRow);
         SkASSERT(fRowsWrittenToOutput < fRowsNeeded);
 
-        // If there is no swizzler, all rows are needed.
-        if (!this->swizzler() || this->swizzler()->rowNeeded(rowNum - fFirstRow)) {
+        if (fBoxDownsampler) {
+            // Every row is needed, but only some complete an output row.
+            this->applyXformRow(fBoxDownsampler->srcRow(), row);
+            if (fBoxDownsampler->accumulateRow(rowNum - fFirstRow)) {
+                fRowsWrittenToOutput++;
+            }
+        } else if (!this->swizzler() || this->swizzler()->rowNeeded(rowNum - fFirstRow)) {
+            // If there is no swizzler, all rows are needed.
             this->applyXformRow(fDst, row);
             fDst = SkTAddOffset<void>(fDst, fRowBytes);
             fRowsWrittenToOutput++;
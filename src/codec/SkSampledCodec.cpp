@@ -13,6 +13,7 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkTemplates.h"
+#include "src/codec/SkBoxDownsampler.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkSampler.h"
 #include "src/core/SkMathPriv.h"
@@ -210,6 +211,20 @@ SkCodec::Result SkSampledCodec::sampledDecode(const SkImageInfo& info, void* pix
 
     const SkImageInfo nativeInfo = info.makeDimensions(nativeSize);
 
+    if (options.fBoxFilter) {
+        auto downsampler = SkBoxDownsampler::Make(info, pixels, rowBytes,
+                                                  {subsetWidth, subsetHeight});
+        if (downsampler) {
+            const SkCodec::Result result = this->boxFilteredDecode(
+                    downsampler.get(), info, pixels, rowBytes, nativeInfo,
+                    options.fSubset ? &subset : nullptr, subsetY, subsetHeight, options);
+            if (result != SkCodec::kUnimplemented) {
+                return result;
+            }
+            // Otherwise this->codec() can't hand over every row, so sample instead.
+        }
+    }
+
     {
         // Although startScanlineDecode expects the bottom and top to match the
         // SkImageInfo, startIncrementalDecode uses them to determine which rows to
@@ -351,3 +366,109 @@ SkCodec::Result SkSampledCodec::sampledDecode(const SkImageInfo& info, void* pix
             return SkCodec::kUnimplemented;
     }
 }
+
+SkCodec::Result SkSampledCodec::boxFilteredDecode(SkBoxDownsampler* downsampler,
+        const SkImageInfo& info, void* pixels, size_t rowBytes, const SkImageInfo& nativeInfo,
+        const SkIRect* subset, int subsetY, int subsetHeight, const AndroidOptions& options) {
+    const int subsetWidth = subset ? subset->width() : nativeInfo.width();
+    const size_t srcRowBytes = info.bytesPerPixel() * (size_t)subsetWidth;
+
+    // Like sampling, only produce the dimensions that getSampledDimensions() reports.
+    // SkBoxDownsampler::Make() has already checked that info is no larger than the subset.
+    const int sampleX = subsetWidth / info.width();
+    const int sampleY = subsetHeight / info.height();
+    if (get_scaled_dimension(subsetWidth, sampleX) != info.width() ||
+        get_scaled_dimension(subsetHeight, sampleY) != info.height()) {
+        return SkCodec::kInvalidScale;
+    }
+
+    // Fill the rows that no box was completed for. Those are at the bottom of a top down
+    // decode, and at the top of a bottom up decode.
+    auto fillIncomplete = [&](bool bottomUp) {
+        const int rowsWritten = downsampler->rowsWritten();
+        void* fillDst = SkTAddOffset<void>(pixels, bottomUp ? 0 : rowsWritten * rowBytes);
+        SkSampler::Fill(info.makeWH(info.width(), info.height() - rowsWritten), fillDst,
+                        rowBytes, options.fZeroInitialized);
+    };
+
+    {
+        AndroidOptions incrementalOptions = options;
+        SkIRect incrementalSubset;
+        if (subset) {
+            incrementalSubset = SkIRect::MakeLTRB(subset->fLeft, subsetY,
+                                                  subset->fRight, subsetY + subsetHeight);
+            incrementalOptions.fSubset = &incrementalSubset;
+        }
+        const SkCodec::Result startResult = this->codec()->startIncrementalDecode(nativeInfo,
+                pixels, rowBytes, &incrementalOptions);
+        if (SkCodec::kSuccess == startResult) {
+            SkSampler* sampler = this->codec()->getSampler(true);
+            if (sampler && sampler->setSampleX(1) == subsetWidth &&
+                this->codec()->setBoxDownsampler(downsampler)) {
+                int rowsDecoded = 0;
+                const SkCodec::Result incResult = this->codec()->incrementalDecode(&rowsDecoded);
+                // downsampler does not outlive this call.
+                this->codec()->setBoxDownsampler(nullptr);
+                if (incResult == SkCodec::kSuccess) {
+                    return SkCodec::kSuccess;
+                }
+                SkASSERT(incResult == SkCodec::kIncompleteInput
+                      || incResult == SkCodec::kErrorInInput);
+
+                // Incremental decodes are top down.
+                fillIncomplete(false);
+                return incResult;
+            }
+            // Otherwise try the scanline decoder, which starts over.
+        } else if (startResult == SkCodec::kIncompleteInput
+                || startResult == SkCodec::kErrorInInput) {
+            return SkCodec::kInvalidInput;
+        } else if (startResult != SkCodec::kUnimplemented) {
+            return startResult;
+        } // kUnimplemented means use the scanline decoder.
+    }
+
+    AndroidOptions scanlineOptions = options;
+    scanlineOptions.fSubset = subset;
+    SkCodec::Result result = this->codec()->startScanlineDecode(nativeInfo, &scanlineOptions);
+    if (SkCodec::kIncompleteInput == result || SkCodec::kErrorInInput == result) {
+        return SkCodec::kInvalidInput;
+    } else if (SkCodec::kSuccess != result) {
+        return result;
+    }
+
+    SkSampler* sampler = this->codec()->getSampler(true);
+    if (!sampler || sampler->setSampleX(1) != subsetWidth) {
+        return SkCodec::kUnimplemented;
+    }
+
+    switch (this->codec()->getScanlineOrder()) {
+        case SkCodec::kTopDown_SkScanlineOrder:
+            if (!this->codec()->skipScanlines(subsetY)) {
+                fillIncomplete(false);
+                return SkCodec::kIncompleteInput;
+            }
+            for (int y = 0; y < subsetHeight; y++) {
+                if (1 != this->codec()->getScanlines(downsampler->srcRow(), 1, srcRowBytes)) {
+                    fillIncomplete(false);
+                    return SkCodec::kIncompleteInput;
+                }
+                downsampler->accumulateRow(y);
+            }
+            return SkCodec::kSuccess;
+        case SkCodec::kBottomUp_SkScanlineOrder:
+            // Note that these modes do not support subsetting.
+            SkASSERT(0 == subsetY && nativeInfo.height() == subsetHeight);
+            for (int y = 0; y < subsetHeight; y++) {
+                const int srcY = this->codec()->nextScanline();
+                if (1 != this->codec()->getScanlines(downsampler->srcRow(), 1, srcRowBytes)) {
+                    fillIncomplete(true);
+                    return SkCodec::kIncompleteInput;
+                }
+                downsampler->accumulateRow(srcY);
+            }
+            return SkCodec::kSuccess;
+        default:
+            return SkCodec::kUnimplemented;
+    }
+}
@@ -13,6 +13,7 @@
 
 #include <cstddef>
 
+class SkBoxDownsampler;
 struct SkIRect;
 struct SkImageInfo;
 
@@ -60,6 +61,17 @@ private:
     SkCodec::Result sampledDecode(const SkImageInfo& info, void* pixels, size_t rowBytes,
             const AndroidOptions& options);
 
+    /**
+     *  Called by sampledDecode() when options.fBoxFilter is set, to average the pixels with
+     *  downsampler as each row is decoded.
+     *
+     *  Returns kUnimplemented if this->codec() can't decode that way, so the caller should
+     *  sample instead.
+     */
+    SkCodec::Result boxFilteredDecode(SkBoxDownsampler* downsampler, const SkImageInfo& info,
+            void* pixels, size_t rowBytes, const SkImageInfo& nativeInfo, const SkIRect* subset,
+            int subsetY, int subsetHeight, const AndroidOptions& options);
+
     using INHERITED = SkAndroidCodec;
 };
 #endif // SkSampledCodec_DEFINED
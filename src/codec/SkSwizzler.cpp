@@ -254,6 +254,17 @@ static void swizzle_index_to_n32(
     }
 }
 
+static void fast_swizzle_index_to_n32(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::index_to_8888((uint32_t*) dst, src + offset, width, ctable);
+}
+
 static void swizzle_index_to_n32_skipZ(
         void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int dstWidth,
         int bpp, int deltaSrc, int offset, const SkPMColor ctable[]) {
@@ -560,6 +571,28 @@ static void swizzle_rgb16_to_bgra(
     }
 }
 
+static void fast_swizzle_rgb16_to_rgba(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_RGB1((uint32_t*) dst, src + offset, width);
+}
+
+static void fast_swizzle_rgb16_to_bgra(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_BGR1((uint32_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgb16_to_565(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -635,6 +668,50 @@ static void swizzle_rgba16_to_bgra_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_RGBA((uint32_t*) dst, src + offset, width);
+}
+
+static void fast_swizzle_rgba16_to_rgba_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_rgbA((uint32_t*) dst, src + offset, width);
+}
+
+static void fast_swizzle_rgba16_to_bgra_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_BGRA((uint32_t*) dst, src + offset, width);
+}
+
+static void fast_swizzle_rgba16_to_bgra_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_bgrA((uint32_t*) dst, src + offset, width);
+}
+
 // kCMYK
 //
 // CMYK is stored as four bytes per pixel.
@@ -937,6 +1014,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                                 proc = &swizzle_index_to_n32_skipZ;
                             } else {
                                 proc = &swizzle_index_to_n32;
+                                fastProc = &fast_swizzle_index_to_n32;
                             }
                             break;
                         case kRGB_565_SkColorType:
@@ -959,6 +1037,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                 case kRGBA_8888_SkColorType:
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = &swizzle_rgb16_to_rgba;
+                        fastProc = &fast_swizzle_rgb16_to_rgba;
                         break;
                     }
 
@@ -969,6 +1048,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                 case kBGRA_8888_SkColorType:
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = &swizzle_rgb16_to_bgra;
+                        fastProc = &fast_swizzle_rgb16_to_bgra;
                         break;
                     }
 
@@ -992,8 +1072,13 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
             switch (dstInfo.colorType()) {
                 case kRGBA_8888_SkColorType:
                     if (16 == encodedInfo.bitsPerComponent()) {
-                        proc = premultiply ? &swizzle_rgba16_to_rgba_premul :
-                                             &swizzle_rgba16_to_rgba_unpremul;
+                        if (premultiply) {
+                            proc = &swizzle_rgba16_to_rgba_premul;
+                            fastProc = &fast_swizzle_rgba16_to_rgba_premul;
+                        } else {
+                            proc = &swizzle_rgba16_to_rgba_unpremul;
+                            fastProc = &fast_swizzle_rgba16_to_rgba_unpremul;
+                        }
                         break;
                     }
 
@@ -1019,8 +1104,13 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                     break;
                 case kBGRA_8888_SkColorType:
                     if (16 == encodedInfo.bitsPerComponent()) {
-                        proc = premultiply ? &swizzle_rgba16_to_bgra_premul :
-                                             &swizzle_rgba16_to_bgra_unpremul;
+                        if (premultiply) {
+                            proc = &swizzle_rgba16_to_bgra_premul;
+                            fastProc = &fast_swizzle_rgba16_to_bgra_premul;
+                        } else {
+                            proc = &swizzle_rgba16_to_bgra_unpremul;
+                            fastProc = &fast_swizzle_rgba16_to_bgra_unpremul;
+                        }
                         break;
                     }
 
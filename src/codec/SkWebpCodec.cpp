@@ -13,6 +13,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkMath.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkSize.h"
@@ -28,6 +29,7 @@
 #include "src/core/SkStreamPriv.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstring>
 #include <utility>
@@ -316,6 +318,94 @@ bool SkWebpCodec::onGetFrameInfo(int i, FrameInfo* frameInfo) const {
     return true;
 }
 
+bool SkWebpCodec::onQueryYUVAInfo(const SkYUVAPixmapInfo::SupportedDataTypes& supportedDataTypes,
+                                  SkYUVAPixmapInfo* yuvaPixmapInfo) const {
+    // Lossy webp is coded as 4:2:0 YUV, with an optional full resolution alpha plane, and libwebp
+    // can write those planes out without converting them to RGB. Lossless webp is coded as BGRA,
+    // and animations need frames composited in RGB, so those are only decoded by onGetPixels().
+    const SkEncodedInfo::Color color = this->getEncodedInfo().color();
+    if (color != SkEncodedInfo::kYUV_Color && color != SkEncodedInfo::kYUVA_Color) {
+        return false;
+    }
+    if (WebPDemuxGetI(fDemux, WEBP_FF_FORMAT_FLAGS) & ANIMATION_FLAG) {
+        return false;
+    }
+
+    WebPIterator frame;
+    SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoFrame(&frame);
+    // Partial data is left to onGetPixels(), which can report the rows that were decoded.
+    if (!WebPDemuxGetFrame(fDemux, 1, &frame) || !frame.complete ||
+        frame.width != this->dimensions().width() || frame.height != this->dimensions().height()) {
+        return false;
+    }
+
+    const auto planeConfig = color == SkEncodedInfo::kYUVA_Color
+                                     ? SkYUVAInfo::PlaneConfig::kY_U_V_A
+                                     : SkYUVAInfo::PlaneConfig::kY_U_V;
+    if (!supportedDataTypes.supported(planeConfig, SkYUVAPixmapInfo::DataType::kUnorm8)) {
+        return false;
+    }
+    if (yuvaPixmapInfo) {
+        // VP8 uses the BT.601 limited range matrix, with chroma sited like jpeg's.
+        SkYUVAInfo yuvaInfo(this->dimensions(),
+                            planeConfig,
+                            SkYUVAInfo::Subsampling::k420,
+                            kRec601_Limited_SkYUVColorSpace,
+                            this->getOrigin(),
+                            SkYUVAInfo::Siting::kCentered,
+                            SkYUVAInfo::Siting::kCentered);
+        *yuvaPixmapInfo = SkYUVAPixmapInfo(yuvaInfo, SkYUVAPixmapInfo::DataType::kUnorm8, nullptr);
+    }
+    return true;
+}
+
+SkCodec::Result SkWebpCodec::onGetYUVAPlanes(const SkYUVAPixmaps& yuvaPixmaps) {
+    SkYUVAPixmapInfo info;
+    if (!this->onQueryYUVAInfo(SkYUVAPixmapInfo::SupportedDataTypes::All(), &info) ||
+        info.yuvaInfo() != yuvaPixmaps.yuvaInfo() ||
+        yuvaPixmaps.dataType() != SkYUVAPixmapInfo::DataType::kUnorm8) {
+        return kInvalidInput;
+    }
+
+    WebPDecoderConfig config;
+    if (0 == WebPInitDecoderConfig(&config)) {
+        // ABI mismatch.
+        return kInvalidInput;
+    }
+    SkAutoTCallVProc<WebPDecBuffer, WebPFreeDecBuffer> autoFree(&(config.output));
+
+    WebPIterator frame;
+    SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoFrame(&frame);
+    // If this succeeded in onQueryYUVAInfo(), it should succeed again here.
+    SkAssertResult(WebPDemuxGetFrame(fDemux, 1, &frame));
+
+    const std::array<SkPixmap, SkYUVAPixmaps::kMaxPlanes>& planes = yuvaPixmaps.planes();
+    const bool hasAlpha = yuvaPixmaps.yuvaInfo().hasAlpha();
+    config.output.colorspace = hasAlpha ? MODE_YUVA : MODE_YUV;
+    config.output.is_external_memory = 1;
+
+    WebPYUVABuffer& yuva = config.output.u.YUVA;
+    yuva.y = static_cast<uint8_t*>(planes[0].writable_addr());
+    yuva.y_stride = SkToInt(planes[0].rowBytes());
+    yuva.y_size = planes[0].computeByteSize();
+    yuva.u = static_cast<uint8_t*>(planes[1].writable_addr());
+    yuva.u_stride = SkToInt(planes[1].rowBytes());
+    yuva.u_size = planes[1].computeByteSize();
+    yuva.v = static_cast<uint8_t*>(planes[2].writable_addr());
+    yuva.v_stride = SkToInt(planes[2].rowBytes());
+    yuva.v_size = planes[2].computeByteSize();
+    if (hasAlpha) {
+        yuva.a = static_cast<uint8_t*>(planes[3].writable_addr());
+        yuva.a_stride = SkToInt(planes[3].rowBytes());
+        yuva.a_size = planes[3].computeByteSize();
+    }
+
+    if (VP8_STATUS_OK != WebPDecode(frame.fragment.bytes, frame.fragment.size, &config)) {
+        return kInvalidInput;
+    }
+    return kSuccess;
+}
+
 static bool is_8888(SkColorType colorType) {
     switch (colorType) {
         case kRGBA_8888_SkColorType:
@@ -13,6 +13,7 @@
 #include "include/core/SkEncodedImageFormat.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkTypes.h"
+#include "include/core/SkYUVAPixmaps.h"
 #include "include/private/SkEncodedInfo.h"
 #include "include/private/SkTemplates.h"
 #include "src/codec/SkFrameHolder.h"
@@ -47,6 +48,11 @@ protected:
     bool onGetFrameInfo(int, FrameInfo*) const override;
     int onGetRepetitionCount() override;
 
+    bool onQueryYUVAInfo(const SkYUVAPixmapInfo::SupportedDataTypes&,
+                         SkYUVAPixmapInfo*) const override;
+
+    Result onGetYUVAPlanes(const SkYUVAPixmaps& yuvaPixmaps) override;
+
     const SkFrameHolder* getFrameHolder() const override {
         return &fFrameHolder;
     }
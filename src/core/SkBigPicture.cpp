@@ -6,11 +6,22 @@
  */
 
 #include "include/core/SkBBHFactory.h"
+#include "include/core/SkMaskFilter.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPathEffect.h"
+#include "include/utils/SkNoDrawCanvas.h"
 #include "src/core/SkBigPicture.h"
+#include "src/core/SkMathPriv.h"
+#include "src/core/SkPicturePriv.h"
 #include "src/core/SkRecord.h"
 #include "src/core/SkRecordDraw.h"
+#include "src/core/SkRectPriv.h"
 #include "src/core/SkTraceEvent.h"
 
+#include <algorithm>
+#include <climits>
+#include <utility>
+
 SkBigPicture::SkBigPicture(const SkRect& cull,
                            sk_sp<SkRecord> record,
                            std::unique_ptr<SnapshotArray> drawablePicts,
@@ -63,6 +74,193 @@ struct NestedApproxOpCounter {
     }
 };
 
+struct LayerFinder {
+    bool fFound = false;
+
+    void operator()(const SkRecords::SaveLayer&)  { fFound = true; }
+    void operator()(const SkRecords::SaveBehind&) { fFound = true; }
+    void operator()(const SkRecords::DrawPicture& op) {
+        // SkCanvas::drawPicture() wraps the picture in a layer when it's drawn with a paint.
+        fFound |= op.paint || draws_layers(op.picture);
+    }
+
+    template <typename T>
+    std::enable_if_t<(T::kTags & SkRecords::kHasPaint_Tag) != 0> operator()(const T& op) {
+        // SkCanvas draws with an image filter by drawing into a layer and filtering that.
+        const SkPaint* paint = AsPtr(op.paint);
+        fFound |= paint && paint->getImageFilter();
+    }
+    template <typename T>
+    std::enable_if_t<(T::kTags & SkRecords::kHasPaint_Tag) == 0> operator()(const T&) {}
+
+    static bool draws_layers(sk_sp<const SkPicture> picture) {
+        const SkBigPicture* big = picture ? SkPicturePriv::AsSkBigPicture(picture) : nullptr;
+        return big && big->drawsLayers();
+    }
+
+private:
+    template <typename T> static const T* AsPtr(const SkRecords::Optional<T>& x) { return x; }
+    template <typename T> static const T* AsPtr(const T& x) { return &x; }
+};
+
+bool SkBigPicture::drawsLayers() const {
+    LayerFinder finder;
+    for (int i = 0; i < fRecord->count() && !finder.fFound; i++) {
+        fRecord->visit(i, finder);
+    }
+    for (int i = 0; i < this->drawableCount() && !finder.fFound; i++) {
+        finder.fFound |= LayerFinder::draws_layers(sk_ref_sp(this->drawablePicts()[i]));
+    }
+    return finder.fFound;
+}
+
+// Scan converting a path, or an anti-aliased or non-rectangular clip, chops its edges at the
+// clip, and the chopped edges step through the rows in the clip a little differently than the
+// originals did. So when playback is split into clipped bands, anything rasterized from edges
+// has to land entirely inside one band to draw exactly what it would unclipped. Axis-aligned
+// rects and images, and paints that fill the clip, come out the same under any clip.
+//
+// BandBlocker collects the device rows that bands must not be split inside. It replays the
+// record's matrix and clip ops into a no-draw canvas to know the CTM at each op.
+class BandBlocker {
+public:
+    BandBlocker(SkCanvas* canvas, const SkMatrix& matrix, const SkRect bounds[],
+                SkPicture const* const drawablePicts[], int drawableCount)
+        : fCanvas(canvas)
+        , fMatrix(matrix)
+        , fBounds(bounds)
+        , fDraw(canvas, drawablePicts, nullptr, drawableCount) {}
+
+    void setCurrentOp(int index) { fIndex = index; }
+
+    template <typename T>
+    std::enable_if_t<(T::kTags & SkRecords::kDraw_Tag) != 0> operator()(const T& op) {
+        if (!this->isExact(op)) {
+            this->block(fMatrix.mapRect(fBounds[fIndex]));
+        }
+    }
+
+    template <typename T>
+    std::enable_if_t<(T::kTags & SkRecords::kDraw_Tag) == 0> operator()(const T& op) {
+        this->checkClip(op);
+        fDraw(op);
+    }
+
+    // Blocked rows as [top, bottom) spans, sorted by top and merged where they overlap.
+    std::vector<std::pair<int, int>> spans() {
+        std::sort(fBlocked.begin(), fBlocked.end());
+        std::vector<std::pair<int, int>> spans;
+        for (const auto& [top, bottom] : fBlocked) {
+            if (!spans.empty() && top < spans.back().second) {
+                spans.back().second = std::max(spans.back().second, bottom);
+            } else {
+                spans.push_back({top, bottom});
+            }
+        }
+        return spans;
+    }
+
+private:
+    static bool IsSimpleFill(const SkPaint* paint) {
+        return !paint || (paint->getStyle() == SkPaint::kFill_Style &&
+                          !paint->getPathEffect() &&
+                          !paint->getMaskFilter());
+    }
+
+    template <typename T> bool isExact(const T&) const { return false; }
+    bool isExact(const SkRecords::DrawPaint&) const { return true; }
+    bool isExact(const SkRecords::DrawRect& op) const {
+        return IsSimpleFill(&op.paint) && fCanvas->getTotalMatrix().rectStaysRect();
+    }
+    bool isExact(const SkRecords::DrawImage& op) const {
+        return IsSimpleFill(op.paint) && fCanvas->getTotalMatrix().rectStaysRect();
+    }
+    bool isExact(const SkRecords::DrawImageRect& op) const {
+        return IsSimpleFill(op.paint) && fCanvas->getTotalMatrix().rectStaysRect();
+    }
+
+    template <typename T> void checkClip(const T&) {}
+    void checkClip(const SkRecords::ClipRect& op) {
+        const SkMatrix& ctm = fCanvas->getTotalMatrix();
+        if (!ctm.rectStaysRect()) {
+            this->block(ctm.mapRect(op.rect));
+        }
+    }
+    void checkClip(const SkRecords::ClipRRect& op) {
+        const SkMatrix& ctm = fCanvas->getTotalMatrix();
+        if (!op.rrect.isRect() || !ctm.rectStaysRect()) {
+            this->block(ctm.mapRect(op.rrect.getBounds()));
+        }
+    }
+    void checkClip(const SkRecords::ClipPath& op) {
+        const SkMatrix& ctm = fCanvas->getTotalMatrix();
+        if (op.path.isInverseFillType()) {
+            this->block(SkRectPriv::MakeLargest());
+        } else if (!op.path.isRect(nullptr) || !ctm.rectStaysRect()) {
+            this->block(ctm.mapRect(op.path.getBounds()));
+        }
+    }
+
+    void block(const SkRect& deviceBounds) {
+        // Outset by a row for anti-aliasing and any rounding in the bounds.
+        const SkIRect ir = deviceBounds.roundOut();
+        fBlocked.push_back({Sk32_sat_sub(ir.fTop, 1), Sk32_sat_add(ir.fBottom, 1)});
+    }
+
+    SkCanvas*                        fCanvas;
+    const SkMatrix                   fMatrix;
+    const SkRect*                    fBounds;
+    SkRecords::Draw                  fDraw;
+    int                              fIndex = 0;
+    std::vector<std::pair<int, int>> fBlocked;
+};
+
+std::vector<int> SkBigPicture::bandCuts(const SkMatrix& matrix,
+                                        SkISize device,
+                                        int bandCount) const {
+    std::vector<int> cuts;
+    if (matrix.hasPerspective()) {
+        return cuts;
+    }
+
+    const int count = fRecord->count();
+    std::vector<SkRect> bounds(count);
+    std::vector<SkBBoxHierarchy::Metadata> meta(count);
+    SkRecordFillBounds(fCullRect, *fRecord, bounds.data(), meta.data());
+
+    SkNoDrawCanvas canvas(device.width(), device.height());
+    canvas.concat(matrix);
+    BandBlocker blocker(&canvas, matrix, bounds.data(),
+                        this->drawablePicts(), this->drawableCount());
+    for (int i = 0; i < count; i++) {
+        blocker.setCurrentOp(i);
+        fRecord->visit(i, blocker);
+    }
+    const std::vector<std::pair<int, int>> spans = blocker.spans();
+
+    // Aim for evenly sized bands, moving each cut out of any blocked span it lands in.
+    for (int i = 1; i < bandCount; i++) {
+        const int target = SkToInt((int64_t)device.height() * i / bandCount);
+        const int prev   = cuts.empty() ? 0 : cuts.back();
+
+        int candidates[2] = {target, target};
+        auto span = std::upper_bound(spans.begin(), spans.end(), std::make_pair(target, INT_MAX));
+        if (span != spans.begin() && target < (--span)->second && span->first < target) {
+            // Try the nearer edge of the span first.
+            candidates[0] = target - span->first <= span->second - target ? span->first
+                                                                           : span->second;
+            candidates[1] = candidates[0] == span->first ? span->second : span->first;
+        }
+        for (int cut : candidates) {
+            if (prev < cut && cut < device.height()) {
+                cuts.push_back(cut);
+                break;
+            }
+        }
+    }
+    return cuts;
+}
+
 SkRect SkBigPicture::cullRect()            const { return fCullRect; }
 int SkBigPicture::approximateOpCount(bool nested) const {
     if (nested) {
@@ -11,10 +11,13 @@
 #include "include/core/SkM44.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkSize.h"
 #include "include/private/SkNoncopyable.h"
 #include "include/private/SkTemplates.h"
 #include "include/private/base/SkOnce.h"
 
+#include <vector>
+
 class SkBBoxHierarchy;
 class SkMatrix;
 class SkRecord;
@@ -56,6 +59,16 @@ public:
                          int start,
                          int stop,
                          const SkM44& initialCTM) const;
+// Used by SkPicture::playbackInBands(). True if playing back this picture, or any picture
+// it draws, may allocate a layer (saveLayer, an image filter on a paint, a picture drawn
+// with a paint, or saveBehind). Layers are sized to the clip, so their pixels line up
+// differently depending on how the device is clipped.
+    bool drawsLayers() const;
+// Also used by SkPicture::playbackInBands(). Returns the rows, in increasing order, where a
+// device of this size, drawn into through matrix, can be split into at most bandCount
+// horizontal bands that each draw exactly what unclipped playback would draw there.
+    std::vector<int> bandCuts(const SkMatrix& matrix, SkISize device, int bandCount) const;
+
 // Used by GrRecordReplaceDraw
     const SkBBoxHierarchy* bbh() const { return fBBH.get(); }
     const SkRecord*     record() const { return fRecord.get(); }
@@ -290,7 +290,11 @@ const SkMipmap* SkMipmapCache::AddAndRef(const SkImage_Base* image, SkResourceCa
         return nullptr;
     }
 
-    SkMipmap* mipmap = SkMipmap::Build(src, get_fact(localCache));
+    // Draws usually sample one or two levels, so only filter those (and the levels above them)
+    // when they're first asked for, rather than the whole chain up front.
+    SkMipmap::BuildOptions options;
+    options.fLazy = true;
+    SkMipmap* mipmap = SkMipmap::Build(src, get_fact(localCache), options);
     if (mipmap) {
         MipMapRec* rec = new MipMapRec(SkBitmapCacheDesc::Make(image), mipmap);
         CHECK_LOCAL(localCache, add, Add, rec);
@@ -140,6 +140,7 @@ private:
     friend class SkDraw;
     friend class SkDrawTiler;
     friend class SkSurface_Raster;
+    friend class SkThreadedBitmapDevice;
 
     class BDDraw;
 
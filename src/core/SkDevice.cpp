@@ -341,8 +341,10 @@ void SkBaseDevice::drawFilteredImage(const skif::Mapping& mapping,
     // getImageFilterCache returns a bare image filter cache pointer that must be ref'ed until the
     // filter's filterImage(ctx) function returns.
     sk_sp<SkImageFilterCache> cache(this->getImageFilterCache());
-    skif::Context ctx(mapping, targetOutput, cache.get(), colorType, this->imageInfo().colorSpace(),
-                      skif::FilterResult(sk_ref_sp(src)));
+    skif::Context ctx = skif::Context(mapping, targetOutput, cache.get(), colorType,
+                                      this->imageInfo().colorSpace(),
+                                      skif::FilterResult(sk_ref_sp(src)))
+                                .withExecutor(this->getImageFilterExecutor());
 
     SkIPoint offset;
     sk_sp<SkSpecialImage> result = as_IFB(filter)->filterImage(ctx).imageAndOffset(&offset);
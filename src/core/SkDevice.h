@@ -30,6 +30,7 @@ class SkBitmap;
 class SkColorSpace;
 class SkMesh;
 struct SkDrawShadowRec;
+class SkExecutor;
 class SkImageFilter;
 class SkImageFilterCache;
 struct SkIRect;
@@ -500,6 +501,8 @@ private:
     }
 
     virtual SkImageFilterCache* getImageFilterCache() { return nullptr; }
+    // If not null, image filters drawn to this device may be evaluated in tiles on this executor.
+    virtual SkExecutor* getImageFilterExecutor() { return nullptr; }
 
     friend class SkNoPixelsDevice;
     friend class SkBitmapDevice;
@@ -7,6 +7,7 @@
 
 #include "include/core/SkCanvas.h"
 #include "include/core/SkDocument.h"
+#include "include/core/SkPicture.h"
 #include "include/core/SkStream.h"
 
 SkDocument::SkDocument(SkWStream* stream) : fStream(stream), fState(kBetweenPages_State) {}
@@ -48,6 +49,28 @@ void SkDocument::endPage() {
     }
 }
 
+void SkDocument::drawPages(SkSpan<const sk_sp<SkPicture>> pages) {
+    this->endPage();
+    if (kClosed_State == fState) {
+        return;
+    }
+    this->onDrawPages(pages);
+}
+
+void SkDocument::onDrawPages(SkSpan<const sk_sp<SkPicture>> pages) {
+    for (const sk_sp<SkPicture>& picture : pages) {
+        if (!picture) {
+            continue;
+        }
+        const SkRect cull = picture->cullRect();
+        if (SkCanvas* canvas = this->beginPage(cull.width(), cull.height())) {
+            canvas->translate(-cull.x(), -cull.y());
+            canvas->drawPicture(picture);
+        }
+        this->endPage();
+    }
+}
+
 void SkDocument::close() {
     for (;;) {
         switch (fState) {
@@ -17,6 +17,7 @@
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkSpecialSurface.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkValidationUtils.h"
 #include "src/core/SkWriteBuffer.h"
 #if SK_SUPPORT_GPU
@@ -30,6 +31,7 @@
 #include "src/gpu/ganesh/SurfaceFillContext.h"
 #endif
 #include <atomic>
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // SkImageFilter - A number of the public APIs on SkImageFilter downcast to SkImageFilter_Base
@@ -120,6 +122,19 @@ bool SkImageFilter_Base::affectsTransparentBlack() const {
     return false;
 }
 
+bool SkImageFilter_Base::canFilterInTiles() const {
+    if (!this->onCanFilterInTiles()) {
+        return false;
+    }
+    for (int i = 0; i < this->countInputs(); i++) {
+        const SkImageFilter* input = this->getInput(i);
+        if (input && !as_IFB(input)->canFilterInTiles()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool SkImageFilter::asAColorFilter(SkColorFilter** filterPtr) const {
     SkASSERT(nullptr != filterPtr);
     if (!this->isColorFilterNode(filterPtr)) {
@@ -244,7 +259,11 @@ skif::FilterResult SkImageFilter_Base::filterImage(const skif::Context& context)
         return result;
     }
 
-    result = this->onFilterImage(context);
+    if (context.executor() && !context.gpuBacked() && this->canFilterInTiles()) {
+        result = this->filterImageInTiles(context);
+    } else {
+        result = this->onFilterImage(context);
+    }
 
     if (context.gpuBacked()) {
         SkASSERT(!result.image() || result.image()->isTextureBacked());
@@ -257,6 +276,87 @@ skif::FilterResult SkImageFilter_Base::filterImage(const skif::Context& context)
     return result;
 }
 
+// Tiles need to be large compared to the margin most filters add around them, since every tile
+// re-filters its margin.
+static constexpr int kFilterTileSize = 256;
+
+skif::FilterResult SkImageFilter_Base::filterImageInTiles(const skif::Context& context) const {
+    SkASSERT(context.executor() && !context.gpuBacked());
+
+    // Tiles don't split any further, and their inputs are filtered on the tile's thread.
+    const skif::Context serialContext = context.withExecutor(nullptr);
+
+    const SkIRect output = SkIRect(context.desiredOutput());
+    std::vector<SkIRect> tiles;
+    for (int y = output.fTop; y < output.fBottom; y += kFilterTileSize) {
+        for (int x = output.fLeft; x < output.fRight; x += kFilterTileSize) {
+            SkIRect tile = SkIRect::MakeXYWH(x, y, kFilterTileSize, kFilterTileSize);
+            SkAssertResult(tile.intersect(output));
+            tiles.push_back(tile);
+        }
+    }
+    if (tiles.size() < 2) {
+        return this->onFilterImage(serialContext);
+    }
+
+    // Each tile needs the input that the filter DAG maps it to. If the tiles' inputs overlap so
+    // much that they add up to more than twice the input of the whole output, filter it at once
+    // and leave it to the inputs to use the executor.
+    const skif::LayerSpace<SkIRect> contentBounds = context.source().layerBounds();
+    auto inputArea = [&](const SkIRect& desiredOutput) {
+        SkIRect input = SkIRect(this->onGetInputLayerBounds(
+                context.mapping(), skif::LayerSpace<SkIRect>(desiredOutput), contentBounds));
+        return input.isEmpty() ? 0 : int64_t(input.width()) * input.height();
+    };
+    int64_t tiledInputArea = 0;
+    for (const SkIRect& tile : tiles) {
+        tiledInputArea += inputArea(tile);
+    }
+    if (tiledInputArea > 2 * inputArea(output)) {
+        return this->onFilterImage(context);
+    }
+
+    // Filtering a tile goes through filterImage(), so each tile and each of its inputs is cached
+    // under the tile's bounds.
+    std::vector<skif::FilterResult> results(tiles.size());
+    SkTaskGroup(*context.executor()).batch(SkToInt(tiles.size()), [&](int i) {
+        results[i] = this->filterImage(
+                serialContext.withNewDesiredOutput(skif::LayerSpace<SkIRect>(tiles[i])));
+    });
+
+    SkIRect bounds = SkIRect::MakeEmpty();
+    for (size_t i = 0; i < tiles.size(); i++) {
+        SkIRect tileBounds = SkIRect(results[i].layerBounds());
+        if (results[i] && tileBounds.intersect(tiles[i])) {
+            bounds.join(tileBounds);
+        }
+    }
+    if (bounds.isEmpty()) {
+        return {};
+    }
+
+    sk_sp<SkSpecialSurface> surf = context.makeSurface(bounds.size());
+    if (!surf) {
+        return {};
+    }
+    SkCanvas* canvas = surf->getCanvas();
+    canvas->clear(SK_ColorTRANSPARENT);
+    canvas->translate(-bounds.fLeft, -bounds.fTop);
+    for (size_t i = 0; i < tiles.size(); i++) {
+        // Each tile's result may extend past the tile, but is only correct within it.
+        SkIPoint origin;
+        sk_sp<SkSpecialImage> image = results[i].imageAndOffset(&origin);
+        if (image) {
+            canvas->save();
+            canvas->clipIRect(tiles[i]);
+            image->draw(canvas, origin.fX, origin.fY);
+            canvas->restore();
+        }
+    }
+    return skif::FilterResult(surf->makeImageSnapshot(),
+                              skif::LayerSpace<SkIPoint>(bounds.topLeft()));
+}
+
 skif::LayerSpace<SkIRect> SkImageFilter_Base::getInputBounds(
         const skif::Mapping& mapping, const skif::DeviceSpace<SkIRect>& desiredOutput,
         const skif::ParameterSpace<SkRect>* knownContentBounds) const {
@@ -18,6 +18,7 @@
 #include "src/core/SkSpecialSurface.h"
 
 class GrRecordingContext;
+class SkExecutor;
 class SkImageFilter;
 class SkImageFilterCache;
 class SkSpecialSurface;
@@ -725,6 +726,9 @@ public:
     // The cache to use when recursing through the filter DAG, in order to avoid repeated
     // calculations of the same image.
     SkImageFilterCache* cache() const { return fCache; }
+    // If not null, CPU-backed filters that can be evaluated in tiles split the desired output
+    // into tiles and filter them concurrently on this executor.
+    SkExecutor* executor() const { return fExecutor; }
     // The output device's color type, which can be used for intermediate images to be
     // compatible with the eventual target of the filtered result.
     SkColorType colorType() const { return fColorType; }
@@ -776,11 +780,22 @@ public:
 
     // Create a new context that matches this context, but with an overridden layer space.
     Context withNewMapping(const Mapping& mapping) const {
-        return Context(mapping, fDesiredOutput, fCache, fColorType, fColorSpace, fSource);
+        Context ctx(mapping, fDesiredOutput, fCache, fColorType, fColorSpace, fSource);
+        ctx.fExecutor = fExecutor;
+        return ctx;
     }
     // Create a new context that matches this context, but with an overridden desired output rect.
     Context withNewDesiredOutput(const LayerSpace<SkIRect>& desiredOutput) const {
-        return Context(fMapping, desiredOutput, fCache, fColorType, fColorSpace, fSource);
+        Context ctx(fMapping, desiredOutput, fCache, fColorType, fColorSpace, fSource);
+        ctx.fExecutor = fExecutor;
+        return ctx;
+    }
+    // Create a new context that matches this context, but filters tiles on 'executor' (or
+    // serially, if it is null).
+    Context withExecutor(SkExecutor* executor) const {
+        Context ctx = *this;
+        ctx.fExecutor = executor;
+        return ctx;
     }
 
 private:
@@ -792,6 +807,8 @@ private:
     // is bounded by the device, so this can be a bare pointer.
     SkColorSpace*       fColorSpace;
     FilterResult        fSource;
+    // Not owned; the device that started filtering outlives the filter evaluation.
+    SkExecutor*         fExecutor = nullptr;
 };
 
 } // end namespace skif
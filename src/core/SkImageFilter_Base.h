@@ -103,6 +103,11 @@ public:
     // color other than transparent black.
     bool affectsTransparentBlack() const;
 
+    // Returns true if every node in this image filter graph produces the same pixels for any
+    // sub-rectangle of the desired output as it would when filtering the whole output, so that
+    // the graph can be evaluated in independent tiles.
+    bool canFilterInTiles() const;
+
     /**
      *  Most ImageFilters can natively handle scaling and translate components in the CTM. Only
      *  some of them can handle affine (or more complex) matrices. Some may only handle translation.
@@ -342,6 +347,11 @@ private:
 
     static void PurgeCache();
 
+    // Splits the context's desired output into tiles and filters them concurrently on the
+    // context's executor, then stitches the tiles into one result. Falls back to filtering the
+    // whole output at once when tiling would not pay off.
+    skif::FilterResult filterImageInTiles(const skif::Context& context) const;
+
     // Configuration points for the filter implementation, marked private since they should not
     // need to be invoked by the subclasses. These refer to the node's specific behavior and are
     // not responsible for aggregating the behavior of the entire filter DAG.
@@ -369,6 +379,14 @@ private:
      */
     virtual bool onAffectsTransparentBlack() const { return false; }
 
+    /**
+     *  Return true if this node's output within any rectangle depends only on its inputs within
+     *  the rectangle mapped by onGetInputLayerBounds(), and not on the rectangle itself. Nodes that
+     *  treat the edges of the desired output specially (e.g. clamping or edge normals) must
+     *  return false. Only needs to describe this node; canFilterInTiles() checks the inputs.
+     */
+    virtual bool onCanFilterInTiles() const { return false; }
+
     /**
      *  This is the virtual which should be overridden by the derived class to perform image
      *  filtering. Subclasses are responsible for recursing to their input filters, although the
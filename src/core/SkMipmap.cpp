@@ -6,15 +6,20 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkHalf.h"
 #include "include/private/SkVx.h"
+#include "include/private/base/SkOnce.h"
 #include "include/private/base/SkTo.h"
 #include "src/core/SkImageInfoPriv.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkMipmap.h"
 #include "src/core/SkMipmapBuilder.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkTaskGroup.h"
+#include <algorithm>
 #include <new>
 
 //
@@ -381,6 +386,107 @@ template <typename F> void downsample_3_3(void* dst, const void* src, size_t src
     }
 }
 
+typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
+
+namespace {
+
+// The filters for one color type, one for each combination of even and odd src dimensions.
+struct Downsamplers {
+    FilterProc* proc_1_2 = nullptr;
+    FilterProc* proc_1_3 = nullptr;
+    FilterProc* proc_2_1 = nullptr;
+    FilterProc* proc_2_2 = nullptr;
+    FilterProc* proc_2_3 = nullptr;
+    FilterProc* proc_3_1 = nullptr;
+    FilterProc* proc_3_2 = nullptr;
+    FilterProc* proc_3_3 = nullptr;
+
+    // Returns the filter that takes a level of this size down to the next one.
+    FilterProc* choose(int width, int height) const {
+        if (height & 1) {
+            if (height == 1) {        // src-height is 1
+                if (width & 1) {      // src-width is 3
+                    return proc_3_1;
+                } else {              // src-width is 2
+                    return proc_2_1;
+                }
+            } else {                  // src-height is 3
+                if (width & 1) {
+                    if (width == 1) { // src-width is 1
+                        return proc_1_3;
+                    } else {          // src-width is 3
+                        return proc_3_3;
+                    }
+                } else {              // src-width is 2
+                    return proc_2_3;
+                }
+            }
+        } else {                      // src-height is 2
+            if (width & 1) {
+                if (width == 1) {     // src-width is 1
+                    return proc_1_2;
+                } else {              // src-width is 3
+                    return proc_3_2;
+                }
+            } else {                  // src-width is 2
+                return proc_2_2;
+            }
+        }
+    }
+};
+
+}  // namespace
+
+// Levels are split into bands of rows for an executor only when each band would still have at
+// least this many dst pixels; below that, handing the work to another thread costs more than it
+// saves.
+static constexpr int kMinPixelsPerBand = 128 * 1024;
+
+// Filters srcPM, the level above dstPM, into dstPM. Every dst row reads only its own two (or
+// three) src rows, so bands of dst rows can be filtered independently.
+static void downsample_level(const Downsamplers& procs, const SkPixmap& srcPM,
+                             const SkPixmap& dstPM, SkExecutor* executor) {
+    FilterProc* proc = procs.choose(srcPM.width(), srcPM.height());
+    const size_t srcRB = srcPM.rowBytes();
+    const int width  = dstPM.width();
+    const int height = dstPM.height();
+
+    auto filterRows = [&](int top, int bottom) {
+        const char* srcRow = (const char*)srcPM.addr() + 2 * top * srcRB;
+        char* dstRow = (char*)dstPM.writable_addr() + top * dstPM.rowBytes();
+        for (int y = top; y < bottom; y++) {
+            proc(dstRow, srcRow, srcRB, width);
+            srcRow += srcRB * 2; // jump two rows
+            dstRow += dstPM.rowBytes();
+        }
+    };
+
+    int bands = 1;
+    if (executor) {
+        bands = SkToInt(std::min<int64_t>(height, sk_64_mul(width, height) / kMinPixelsPerBand));
+    }
+    if (bands <= 1) {
+        filterRows(0, height);
+        return;
+    }
+
+    SkTaskGroup group(*executor);
+    group.batch(bands, [&](int band) {
+        filterRows(height * band / bands, height * (band + 1) / bands);
+    });
+    group.wait();
+}
+
+// The state a lazily built mipmap needs to filter its levels on demand.
+struct SkMipmap::LazyLevels {
+    LazyLevels(const SkBitmap& src, const Downsamplers& procs, int count)
+        : fSrc(src), fProcs(procs), fFilled(new SkOnce[count]) {}
+
+    SkBitmap                  fSrc;      // the base level, until level 0 is filtered from it
+    Downsamplers              fProcs;
+    std::unique_ptr<SkOnce[]> fFilled;   // one per level
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 SkMipmap::SkMipmap(void* malloc, size_t size) : SkCachedData(malloc, size) {}
@@ -401,16 +507,12 @@ size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
 
 SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
                           bool computeContents) {
-    typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
+    return Make(src, fact, computeContents, nullptr, nullptr);
+}
 
-    FilterProc* proc_1_2 = nullptr;
-    FilterProc* proc_1_3 = nullptr;
-    FilterProc* proc_2_1 = nullptr;
-    FilterProc* proc_2_2 = nullptr;
-    FilterProc* proc_2_3 = nullptr;
-    FilterProc* proc_3_1 = nullptr;
-    FilterProc* proc_3_2 = nullptr;
-    FilterProc* proc_3_3 = nullptr;
+SkMipmap* SkMipmap::Make(const SkPixmap& src, SkDiscardableFactoryProc fact,
+                         bool computeContents, SkExecutor* executor, const SkBitmap* lazySrc) {
+    Downsamplers procs;
 
     const SkColorType ct = src.colorType();
     const SkAlphaType at = src.alphaType();
@@ -418,128 +520,128 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
     switch (ct) {
         case kRGBA_8888_SkColorType:
         case kBGRA_8888_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
+            procs.proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
+            procs.proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
+            procs.proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
+            procs.proc_2_2 = SkOpts::downsample_2_2_8888;
+            procs.proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
+            procs.proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
+            procs.proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
+            procs.proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
             break;
         case kRGB_565_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_565>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_565>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_565>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_565>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_565>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_565>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_565>;
+            procs.proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
+            procs.proc_1_3 = downsample_1_3<ColorTypeFilter_565>;
+            procs.proc_2_1 = downsample_2_1<ColorTypeFilter_565>;
+            procs.proc_2_2 = downsample_2_2<ColorTypeFilter_565>;
+            procs.proc_2_3 = downsample_2_3<ColorTypeFilter_565>;
+            procs.proc_3_1 = downsample_3_1<ColorTypeFilter_565>;
+            procs.proc_3_2 = downsample_3_2<ColorTypeFilter_565>;
+            procs.proc_3_3 = downsample_3_3<ColorTypeFilter_565>;
             break;
         case kARGB_4444_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_4444>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_4444>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_4444>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_4444>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_4444>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_4444>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_4444>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_4444>;
+            procs.proc_1_2 = downsample_1_2<ColorTypeFilter_4444>;
+            procs.proc_1_3 = downsample_1_3<ColorTypeFilter_4444>;
+            procs.proc_2_1 = downsample_2_1<ColorTypeFilter_4444>;
+            procs.proc_2_2 = downsample_2_2<ColorTypeFilter_4444>;
+            procs.proc_2_3 = downsample_2_3<ColorTypeFilter_4444>;
+            procs.proc_3_1 = downsample_3_1<ColorTypeFilter_4444>;
+            procs.proc_3_2 = downsample_3_2<ColorTypeFilter_4444>;
+            procs.proc_3_3 = downsample_3_3<ColorTypeFilter_4444>;
             break;
         case kAlpha_8_SkColorType:
         case kGray_8_SkColorType:
         case kR8_unorm_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_8>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_8>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_8>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8>;
+            procs.proc_1_2 = downsample_1_2<ColorTypeFilter_8>;
+            procs.proc_1_3 = downsample_1_3<ColorTypeFilter_8>;
+            procs.proc_2_1 = downsample_2_1<ColorTypeFilter_8>;
+            procs.proc_2_2 = SkOpts::downsample_2_2_A8;
+            procs.proc_2_3 = downsample_2_3<ColorTypeFilter_8>;
+            procs.proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
+            procs.proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
+            procs.proc_3_3 = downsample_3_3<ColorTypeFilter_8>;
             break;
         case kRGBA_F16Norm_SkColorType:
         case kRGBA_F16_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_RGBA_F16>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_RGBA_F16>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_RGBA_F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_RGBA_F16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_RGBA_F16>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_RGBA_F16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_RGBA_F16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_RGBA_F16>;
+            procs.proc_1_2 = downsample_1_2<ColorTypeFilter_RGBA_F16>;
+            procs.proc_1_3 = downsample_1_3<ColorTypeFilter_RGBA_F16>;
+            procs.proc_2_1 = downsample_2_1<ColorTypeFilter_RGBA_F16>;
+            procs.proc_2_2 = SkOpts::downsample_2_2_F16;
+            procs.proc_2_3 = downsample_2_3<ColorTypeFilter_RGBA_F16>;
+            procs.proc_3_1 = downsample_3_1<ColorTypeFilter_RGBA_F16>;
+            procs.proc_3_2 = downsample_3_2<ColorTypeFilter_RGBA_F16>;
+            procs.proc_3_3 = downsample_3_3<ColorTypeFilter_RGBA_F16>;
             break;
         case kR8G8_unorm_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_88>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_88>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_88>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_88>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_88>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_88>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_88>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_88>;
+            procs.proc_1_2 = downsample_1_2<ColorTypeFilter_88>;
+            procs.proc_1_3 = downsample_1_3<ColorTypeFilter_88>;
+            procs.proc_2_1 = downsample_2_1<ColorTypeFilter_88>;
+            procs.proc_2_2 = downsample_2_2<ColorTypeFilter_88>;
+            procs.proc_2_3 = downsample_2_3<ColorTypeFilter_88>;
+            procs.proc_3_1 = downsample_3_1<ColorTypeFilter_88>;
+            procs.proc_3_2 = downsample_3_2<ColorTypeFilter_88>;
+            procs.proc_3_3 = downsample_3_3<ColorTypeFilter_88>;
             break;
         case kR16G16_unorm_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_1616>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_1616>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_1616>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_1616>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_1616>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_1616>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_1616>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_1616>;
+            procs.proc_1_2 = downsample_1_2<ColorTypeFilter_1616>;
+            procs.proc_1_3 = downsample_1_3<ColorTypeFilter_1616>;
+            procs.proc_2_1 = downsample_2_1<ColorTypeFilter_1616>;
+            procs.proc_2_2 = downsample_2_2<ColorTypeFilter_1616>;
+            procs.proc_2_3 = downsample_2_3<ColorTypeFilter_1616>;
+            procs.proc_3_1 = downsample_3_1<ColorTypeFilter_1616>;
+            procs.proc_3_2 = downsample_3_2<ColorTypeFilter_1616>;
+            procs.proc_3_3 = downsample_3_3<ColorTypeFilter_1616>;
             break;
         case kA16_unorm_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_16>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_16>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_16>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_16>;
+            procs.proc_1_2 = downsample_1_2<ColorTypeFilter_16>;
+            procs.proc_1_3 = downsample_1_3<ColorTypeFilter_16>;
+            procs.proc_2_1 = downsample_2_1<ColorTypeFilter_16>;
+            procs.proc_2_2 = downsample_2_2<ColorTypeFilter_16>;
+            procs.proc_2_3 = downsample_2_3<ColorTypeFilter_16>;
+            procs.proc_3_1 = downsample_3_1<ColorTypeFilter_16>;
+            procs.proc_3_2 = downsample_3_2<ColorTypeFilter_16>;
+            procs.proc_3_3 = downsample_3_3<ColorTypeFilter_16>;
             break;
         case kRGBA_1010102_SkColorType:
         case kBGRA_1010102_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_1010102>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_1010102>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_1010102>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_1010102>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_1010102>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_1010102>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_1010102>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_1010102>;
+            procs.proc_1_2 = downsample_1_2<ColorTypeFilter_1010102>;
+            procs.proc_1_3 = downsample_1_3<ColorTypeFilter_1010102>;
+            procs.proc_2_1 = downsample_2_1<ColorTypeFilter_1010102>;
+            procs.proc_2_2 = downsample_2_2<ColorTypeFilter_1010102>;
+            procs.proc_2_3 = downsample_2_3<ColorTypeFilter_1010102>;
+            procs.proc_3_1 = downsample_3_1<ColorTypeFilter_1010102>;
+            procs.proc_3_2 = downsample_3_2<ColorTypeFilter_1010102>;
+            procs.proc_3_3 = downsample_3_3<ColorTypeFilter_1010102>;
             break;
         case kA16_float_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_Alpha_F16>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_Alpha_F16>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_Alpha_F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_Alpha_F16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_Alpha_F16>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_Alpha_F16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_Alpha_F16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_Alpha_F16>;
+            procs.proc_1_2 = downsample_1_2<ColorTypeFilter_Alpha_F16>;
+            procs.proc_1_3 = downsample_1_3<ColorTypeFilter_Alpha_F16>;
+            procs.proc_2_1 = downsample_2_1<ColorTypeFilter_Alpha_F16>;
+            procs.proc_2_2 = downsample_2_2<ColorTypeFilter_Alpha_F16>;
+            procs.proc_2_3 = downsample_2_3<ColorTypeFilter_Alpha_F16>;
+            procs.proc_3_1 = downsample_3_1<ColorTypeFilter_Alpha_F16>;
+            procs.proc_3_2 = downsample_3_2<ColorTypeFilter_Alpha_F16>;
+            procs.proc_3_3 = downsample_3_3<ColorTypeFilter_Alpha_F16>;
             break;
         case kR16G16_float_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_F16F16>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_F16F16>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_F16F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_F16F16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_F16F16>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_F16F16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_F16F16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_F16F16>;
+            procs.proc_1_2 = downsample_1_2<ColorTypeFilter_F16F16>;
+            procs.proc_1_3 = downsample_1_3<ColorTypeFilter_F16F16>;
+            procs.proc_2_1 = downsample_2_1<ColorTypeFilter_F16F16>;
+            procs.proc_2_2 = downsample_2_2<ColorTypeFilter_F16F16>;
+            procs.proc_2_3 = downsample_2_3<ColorTypeFilter_F16F16>;
+            procs.proc_3_1 = downsample_3_1<ColorTypeFilter_F16F16>;
+            procs.proc_3_2 = downsample_3_2<ColorTypeFilter_F16F16>;
+            procs.proc_3_3 = downsample_3_3<ColorTypeFilter_F16F16>;
             break;
         case kR16G16B16A16_unorm_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_16161616>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_16161616>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_16161616>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_16161616>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_16161616>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_16161616>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_16161616>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_16161616>;
+            procs.proc_1_2 = downsample_1_2<ColorTypeFilter_16161616>;
+            procs.proc_1_3 = downsample_1_3<ColorTypeFilter_16161616>;
+            procs.proc_2_1 = downsample_2_1<ColorTypeFilter_16161616>;
+            procs.proc_2_2 = downsample_2_2<ColorTypeFilter_16161616>;
+            procs.proc_2_3 = downsample_2_3<ColorTypeFilter_16161616>;
+            procs.proc_3_1 = downsample_3_1<ColorTypeFilter_16161616>;
+            procs.proc_3_2 = downsample_3_2<ColorTypeFilter_16161616>;
+            procs.proc_3_3 = downsample_3_3<ColorTypeFilter_16161616>;
             break;
 
         case kUnknown_SkColorType:
@@ -592,43 +694,12 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
     int         width = src.width();
     int         height = src.height();
     uint32_t    rowBytes;
-    SkPixmap    srcPM(src);
 
     // Depending on architecture and other factors, the pixel data alignment may need to be as
     // large as 8 (for F16 pixels). See the comment on SkMipmap::Level.
     SkASSERT(SkIsAlign8((uintptr_t)addr));
 
     for (int i = 0; i < countLevels; ++i) {
-        FilterProc* proc;
-        if (height & 1) {
-            if (height == 1) {        // src-height is 1
-                if (width & 1) {      // src-width is 3
-                    proc = proc_3_1;
-                } else {              // src-width is 2
-                    proc = proc_2_1;
-                }
-            } else {                  // src-height is 3
-                if (width & 1) {
-                    if (width == 1) { // src-width is 1
-                        proc = proc_1_3;
-                    } else {          // src-width is 3
-                        proc = proc_3_3;
-                    }
-                } else {              // src-width is 2
-                    proc = proc_2_3;
-                }
-            }
-        } else {                      // src-height is 2
-            if (width & 1) {
-                if (width == 1) {     // src-width is 1
-                    proc = proc_1_2;
-                } else {              // src-width is 3
-                    proc = proc_3_2;
-                }
-            } else {                  // src-width is 2
-                proc = proc_2_2;
-            }
-        }
         width = std::max(1, width >> 1);
         height = std::max(1, height >> 1);
         rowBytes = SkToU32(SkColorTypeMinRowBytes(ct, width));
@@ -640,27 +711,42 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
         levels[i].fScale  = SkSize::Make(SkIntToScalar(width)  / src.width(),
                                          SkIntToScalar(height) / src.height());
 
-        const SkPixmap& dstPM = levels[i].fPixmap;
         if (computeContents) {
-            const void* srcBasePtr = srcPM.addr();
-            void* dstBasePtr = dstPM.writable_addr();
-
-            const size_t srcRB = srcPM.rowBytes();
-            for (int y = 0; y < height; y++) {
-                proc(dstBasePtr, srcBasePtr, srcRB, width);
-                srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-                dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
-            }
+            downsample_level(procs, i == 0 ? src : levels[i - 1].fPixmap, levels[i].fPixmap,
+                             executor);
         }
-        srcPM = dstPM;
         addr += height * rowBytes;
     }
     SkASSERT(addr == baseAddr + size);
 
+    if (lazySrc && countLevels > 0) {
+        mipmap->fLazy = std::make_unique<LazyLevels>(*lazySrc, procs, countLevels);
+    }
+
     SkASSERT(mipmap->fLevels);
     return mipmap;
 }
 
+void SkMipmap::fillLevel(int index) const {
+    if (!fLazy) {
+        return;
+    }
+    fLazy->fFilled[index]([&] {
+        SkPixmap srcPM;
+        if (index == 0) {
+            srcPM = fLazy->fSrc.pixmap();
+        } else {
+            this->fillLevel(index - 1);
+            srcPM = fLevels[index - 1].fPixmap;
+        }
+        downsample_level(fLazy->fProcs, srcPM, fLevels[index].fPixmap, &SkExecutor::GetDefault());
+        if (index == 0) {
+            // Only level 0 reads the base, and this SkOnce is the only place that touches it.
+            fLazy->fSrc.reset();
+        }
+    });
+}
+
 int SkMipmap::ComputeLevelCount(int baseWidth, int baseHeight) {
     if (baseWidth < 1 || baseHeight < 1) {
         return 0;
@@ -762,6 +848,7 @@ bool SkMipmap::extractLevel(SkSize scaleSize, Level* levelPtr) const {
         level = fCount;
     }
     if (levelPtr) {
+        this->fillLevel(level - 1);
         *levelPtr = fLevels[level - 1];
         // need to augment with our colorspace
         levelPtr->fPixmap.setColorSpace(fCS);
@@ -803,6 +890,16 @@ SkMipmap* SkMipmap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
     return Build(srcPixmap, fact);
 }
 
+SkMipmap* SkMipmap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact,
+                          const BuildOptions& options) {
+    SkPixmap srcPixmap;
+    if (!src.peekPixels(&srcPixmap)) {
+        return nullptr;
+    }
+    return Make(srcPixmap, fact, /*computeContents=*/!options.fLazy, options.fExecutor,
+                options.fLazy ? &src : nullptr);
+}
+
 int SkMipmap::countLevels() const {
     return fCount;
 }
@@ -818,6 +915,7 @@ bool SkMipmap::getLevel(int index, Level* levelPtr) const {
         return false;
     }
     if (levelPtr) {
+        this->fillLevel(index);
         *levelPtr = fLevels[index];
         // need to augment with our colorspace
         levelPtr->fPixmap.setColorSpace(fCS);
@@ -15,9 +15,12 @@
 #include "src/core/SkImageInfoPriv.h"
 #include "src/shaders/SkShaderBase.h"
 
+#include <memory>
+
 class SkBitmap;
 class SkData;
 class SkDiscardableMemory;
+class SkExecutor;
 class SkMipmapBuilder;
 
 typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
@@ -39,6 +42,21 @@ public:
 
     static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
 
+    struct BuildOptions {
+        // If set, levels large enough to be worth splitting are filtered in horizontal bands of
+        // rows on this executor. Build() still returns only once every band is done.
+        SkExecutor* fExecutor = nullptr;
+
+        // If set, Build() only allocates the levels. Each level is filtered the first time
+        // getLevel() or extractLevel() returns it, along with any larger levels it is filtered
+        // from, so draws only pay for the levels they sample. The mipmap keeps a ref on src's
+        // pixels until level 0 has been filtered, and they must not change before then. Lazy
+        // levels are filtered on SkExecutor::GetDefault() at the time they're requested;
+        // fExecutor is not kept.
+        bool        fLazy = false;
+    };
+    static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc, const BuildOptions&);
+
     // Determines how many levels a SkMipmap will have without creating that mipmap.
     // This does not include the base mipmap level that the user provided when
     // creating the SkMipmap.
@@ -83,14 +101,23 @@ protected:
     }
 
 private:
+    struct LazyLevels;
+
     sk_sp<SkColorSpace> fCS;
     Level*              fLevels;    // managed by the baseclass, may be null due to onDataChanged.
     int                 fCount;
+    std::unique_ptr<LazyLevels> fLazy;  // non-null if levels are filtered on first use
 
     SkMipmap(void* malloc, size_t size);
     SkMipmap(size_t size, SkDiscardableMemory* dm);
 
+    static SkMipmap* Make(const SkPixmap& src, SkDiscardableFactoryProc, bool computeContents,
+                          SkExecutor*, const SkBitmap* lazySrc);
     static size_t AllocLevelsSize(int levelCount, size_t pixelSize);
+
+    // Filters fLevels[index] (and any larger levels it depends on) if it was built lazily and
+    // hasn't been filtered yet. Safe to call from multiple threads.
+    void fillLevel(int index) const;
 };
 
 #endif
@@ -43,6 +43,7 @@
 #include "src/opts/SkBlitMask_opts.h"
 #include "src/opts/SkBlitRow_opts.h"
 #include "src/opts/SkChecksum_opts.h"
+#include "src/opts/SkMipmap_opts.h"
 #include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkSwizzler_opts.h"
 #include "src/opts/SkUtils_opts.h"
@@ -70,6 +71,15 @@ namespace SkOpts {
     DEFINE_DEFAULT(gray_to_RGB1);
     DEFINE_DEFAULT(grayA_to_RGBA);
     DEFINE_DEFAULT(grayA_to_rgbA);
+    DEFINE_DEFAULT(RGB16_to_RGB1);
+    DEFINE_DEFAULT(RGB16_to_BGR1);
+    DEFINE_DEFAULT(RGBA16_to_RGBA);
+    DEFINE_DEFAULT(RGBA16_to_BGRA);
+    DEFINE_DEFAULT(RGBA16_to_rgbA);
+    DEFINE_DEFAULT(RGBA16_to_bgrA);
+    DEFINE_DEFAULT(index_to_8888);
+    DEFINE_DEFAULT(bitfields16_to_8888);
+    DEFINE_DEFAULT(bitfields32_to_8888);
     DEFINE_DEFAULT(inverted_CMYK_to_RGB1);
     DEFINE_DEFAULT(inverted_CMYK_to_BGR1);
 
@@ -83,6 +93,10 @@ namespace SkOpts {
 
     DEFINE_DEFAULT(cubic_solver);
 
+    DEFINE_DEFAULT(downsample_2_2_8888);
+    DEFINE_DEFAULT(downsample_2_2_F16);
+    DEFINE_DEFAULT(downsample_2_2_A8);
+
     DEFINE_DEFAULT(hash_fn);
 
     DEFINE_DEFAULT(S32_alpha_D32_filter_DX);
@@ -94,6 +94,26 @@ namespace SkOpts {
                            grayA_to_RGBA,   // i.e. expand to color channels
                            grayA_to_rgbA;   // i.e. expand to color channels and premultiply
 
+    // As above, but from big-endian 16-bit components, keeping the high byte of each.
+    extern Swizzle_8888_u8 RGB16_to_RGB1,   // i.e. strip to 8 bits and insert an opaque alpha
+                           RGB16_to_BGR1,   // i.e. strip, swap RB and insert an opaque alpha
+                           RGBA16_to_RGBA,  // i.e. just strip to 8 bits
+                           RGBA16_to_BGRA,  // i.e. strip and swap RB
+                           RGBA16_to_rgbA,  // i.e. strip and premultiply
+                           RGBA16_to_bgrA;  // i.e. strip, swap RB and premultiply
+
+    // Look up each 8-bit index in a 256 entry color table.
+    typedef void (*Index_to_8888)(uint32_t*, const uint8_t*, int, const uint32_t ctable[]);
+    extern Index_to_8888 index_to_8888;
+
+    // Unpack 16- or 32-bit pixels with bitfield masks (as in BMP) to 8888. Byte c of each dst
+    // pixel is (src & masks[c]) shifted down and rounded from its width in bits to 8 bits, or 0
+    // if masks[c] is 0. Masks are at most 8 bits wide. Then fill is or'd in.
+    typedef void (*Bitfields_to_8888)(uint32_t*, const uint8_t*, int, const uint32_t masks[4],
+                                      uint32_t fill);
+    extern Bitfields_to_8888 bitfields16_to_8888,
+                             bitfields32_to_8888;
+
     extern void (*memset16)(uint16_t[], uint16_t, int);
     extern void SK_SPI(*memset32)(uint32_t[], uint32_t, int);
     extern void (*memset64)(uint64_t[], uint64_t, int);
@@ -104,6 +124,12 @@ namespace SkOpts {
 
     extern float (*cubic_solver)(float, float, float, float);
 
+    // 2x2 box filters for SkMipmap: average two src rows down to one row of count dst pixels.
+    typedef void (*Downsample_2_2)(void* dst, const void* src, size_t srcRB, int count);
+    extern Downsample_2_2 downsample_2_2_8888,
+                          downsample_2_2_F16,
+                          downsample_2_2_A8;
+
     static inline uint32_t hash(const void* data, size_t bytes, uint32_t seed=0) {
         // hash_fn is defined in SkOpts_spi.h so it can be used by //modules
         return hash_fn(data, bytes, seed);
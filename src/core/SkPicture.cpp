@@ -7,10 +7,16 @@
 
 #include "include/core/SkPicture.h"
 
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkSerialProcs.h"
+#include "include/core/SkSurface.h"
+#include "include/private/SkTHash.h"
 #include "include/private/base/SkTo.h"
+#include "src/core/SkBigPicture.h"
 #include "src/core/SkCanvasPriv.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkPictureData.h"
@@ -19,8 +25,11 @@
 #include "src/core/SkPictureRecord.h"
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkStreamPriv.h"
+#include "src/core/SkTaskGroup.h"
 
+#include <algorithm>
 #include <atomic>
+#include <vector>
 
 #if SK_SUPPORT_GPU
 #include "include/private/chromium/Slug.h"
@@ -350,3 +359,76 @@ sk_sp<SkPicture> SkPicture::MakePlaceholder(SkRect cull) {
     };
     return sk_make_sp<Placeholder>(cull);
 }
+
+bool SkPicture::playbackInBands(const SkPixmap& dst, const SkMatrix* matrix,
+                                SkExecutor* executor, int bandCount,
+                                const SkSurfaceProps* props) const {
+    // Every band draws through its own surface over all of dst, clipped to its rows, so each
+    // draw sees exactly the same device coordinates as it would when played back serially.
+    auto draw = [&](const SkIRect* band) {
+        sk_sp<SkSurface> surface = SkSurface::MakeRasterDirect(dst, props);
+        if (!surface) {
+            return false;
+        }
+        SkCanvas* canvas = surface->getCanvas();
+        if (band) {
+            canvas->clipIRect(*band);
+        }
+        if (matrix) {
+            canvas->concat(*matrix);
+        }
+        this->playback(canvas);
+        return true;
+    };
+
+    const SkBigPicture* big = this->asSkBigPicture();
+    if (!executor || bandCount <= 1 || dst.height() <= 1 || !big || big->drawsLayers()) {
+        return draw(nullptr);
+    }
+
+    std::vector<int> rows = big->bandCuts(matrix ? *matrix : SkMatrix::I(),
+                                          dst.dimensions(),
+                                          std::min(bandCount, dst.height()));
+    if (rows.empty()) {
+        return draw(nullptr);
+    }
+    rows.insert(rows.begin(), 0);
+    rows.push_back(dst.height());
+
+    std::atomic<bool> ok{true};
+    SkTaskGroup tasks(*executor);
+    tasks.batch(SkToInt(rows.size()) - 1, [&](int i) {
+        const SkIRect band = SkIRect::MakeLTRB(0, rows[i], dst.width(), rows[i + 1]);
+        if (!draw(&band)) {
+            ok = false;
+        }
+    });
+    tasks.wait();
+    return ok;
+}
+
+void SkPicture::decodeImagesAhead(SkExecutor* executor) const {
+    // Re-recording into an SkPictureRecord, as serializing does, gathers every image and
+    // picture drawn, without duplicates. Pictures it draws get the same treatment in turn.
+    SkTHashSet<uint32_t> seenImages, seenPictures;
+    std::vector<const SkPicture*> pending = {this};
+    seenPictures.add(this->uniqueID());
+    while (!pending.empty()) {
+        const SkPicture* picture = pending.back();
+        pending.pop_back();
+
+        std::unique_ptr<SkPictureData> data(picture->backport());
+        for (const sk_sp<const SkImage>& image : data->images()) {
+            if (image->isLazyGenerated() && !seenImages.contains(image->uniqueID())) {
+                seenImages.add(image->uniqueID());
+                image->decodeAhead(executor);
+            }
+        }
+        for (const sk_sp<const SkPicture>& sub : data->pictures()) {
+            if (!seenPictures.contains(sub->uniqueID())) {
+                seenPictures.add(sub->uniqueID());
+                pending.push_back(sub.get());
+            }
+        }
+    }
+}
@@ -142,6 +142,10 @@ public:
         return read_index_base_1_or_null(reader, fVertices);
     }
 
+    // Used by SkPicture::decodeImagesAhead().
+    const SkTArray<sk_sp<const SkImage>>&   images() const { return fImages; }
+    const SkTArray<sk_sp<const SkPicture>>& pictures() const { return fPictures; }
+
 private:
     // these help us with reading/writing
     // Does not affect ownership of SkStream.
@@ -7,6 +7,11 @@
 
 #include "src/core/SkRTree.h"
 
+#include "include/private/SkVx.h"
+#include "src/core/SkMathPriv.h"
+
+#include <limits>
+
 SkRTree::SkRTree() : fCount(0) {}
 
 void SkRTree::insert(const SkRect boundsArray[], int N) {
@@ -34,11 +39,13 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
             Node* n = this->allocateNodeAtLevel(0);
             n->fNumChildren = 1;
             n->fChildren[0] = branches[0];
-            fRoot.fSubtree = n;
-            fRoot.fBounds  = branches[0].fBounds;
+            fRootBounds = branches[0].fBounds;
+            this->pack(n);
         } else {
             fNodes.reserve(CountNodes(fCount));
-            fRoot = this->bulkLoad(&branches);
+            Branch root = this->bulkLoad(&branches);
+            fRootBounds = root.fBounds;
+            this->pack(root.fSubtree);
         }
     }
 }
@@ -141,20 +148,144 @@ SkRTree::Branch SkRTree::bulkLoad(std::vector<Branch>* branches, int level) {
     return this->bulkLoad(branches, level + 1);
 }
 
+void SkRTree::pack(const Node* root) {
+    constexpr float kInf = std::numeric_limits<float>::infinity();
+
+    // Visiting nodes breadth-first, each node's index in order is its index in fPacked.
+    std::vector<const Node*> order;
+    order.reserve(fNodes.size());
+    order.push_back(root);
+
+    fPacked.resize(fNodes.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        const Node* node = order[i];
+        PackedNode& packed = fPacked[i];
+        packed.fNumChildren = node->fNumChildren;
+        packed.fLevel = node->fLevel;
+        for (int c = 0; c < kLanes; c++) {
+            if (c < node->fNumChildren) {
+                const Branch& child = node->fChildren[c];
+                packed.fLeft[c]   = child.fBounds.fLeft;
+                packed.fTop[c]    = child.fBounds.fTop;
+                packed.fRight[c]  = child.fBounds.fRight;
+                packed.fBottom[c] = child.fBounds.fBottom;
+                if (0 == node->fLevel) {
+                    packed.fChildren[c] = child.fOpIndex;
+                } else {
+                    packed.fChildren[c] = SkToS32(order.size());
+                    order.push_back(child.fSubtree);
+                }
+            } else {
+                packed.fLeft[c] = packed.fTop[c]    = +kInf;
+                packed.fRight[c] = packed.fBottom[c] = -kInf;
+                packed.fChildren[c] = -1;
+            }
+        }
+    }
+    SkASSERT(order.size() == fPacked.size());
+
+    // The pointer-based tree is no longer needed.
+    std::vector<Node>().swap(fNodes);
+}
+
+uint32_t SkRTree::Hits(const PackedNode& node, const SkRect& query) {
+    using F = skvx::Vec<kLanes, float>;
+
+    // This is SkRect::Intersects(child, query) for every child at once.
+    F L = max(F::Load(node.fLeft),   query.fLeft),
+      T = max(F::Load(node.fTop),    query.fTop),
+      R = min(F::Load(node.fRight),  query.fRight),
+      B = min(F::Load(node.fBottom), query.fBottom);
+    auto hit = (L < R) & (T < B);
+    if (!any(hit)) {
+        return 0;
+    }
+
+    uint32_t bits = 0;
+    for (int i = 0; i < node.fNumChildren; i++) {
+        bits |= (hit[i] ? 1u : 0u) << i;
+    }
+    return bits;
+}
+
 void SkRTree::search(const SkRect& query, std::vector<int>* results) const {
-    if (fCount > 0 && SkRect::Intersects(fRoot.fBounds, query)) {
-        this->search(fRoot.fSubtree, query, results);
+    if (fCount > 0 && SkRect::Intersects(fRootBounds, query)) {
+        this->search(0, query, results);
     }
 }
 
-void SkRTree::search(Node* node, const SkRect& query, std::vector<int>* results) const {
-    for (int i = 0; i < node->fNumChildren; ++i) {
-        if (SkRect::Intersects(node->fChildren[i].fBounds, query)) {
-            if (0 == node->fLevel) {
-                results->push_back(node->fChildren[i].fOpIndex);
-            } else {
-                this->search(node->fChildren[i].fSubtree, query, results);
+void SkRTree::search(int nodeIndex, const SkRect& query, std::vector<int>* results) const {
+    const PackedNode& node = fPacked[nodeIndex];
+    for (uint32_t hits = Hits(node, query); hits; hits &= hits - 1) {
+        const int i = SkCTZ(hits);
+        if (0 == node.fLevel) {
+            results->push_back(node.fChildren[i]);
+        } else {
+            this->search(node.fChildren[i], query, results);
+        }
+    }
+}
+
+// Per-level storage for the batched search, so recursing doesn't allocate at every node.
+struct SkRTree::BatchScratch {
+    struct Level {
+        std::vector<uint32_t> hits;  // per active query
+        std::vector<int>      next;  // active queries for the child being visited
+    };
+    std::vector<Level> levels;
+};
+
+void SkRTree::search(const SkRect queries[], int count, std::vector<int> results[]) const {
+    if (fCount == 0 || count <= 0) {
+        return;
+    }
+
+    std::vector<int> active;
+    active.reserve(count);
+    for (int q = 0; q < count; q++) {
+        if (SkRect::Intersects(fRootBounds, queries[q])) {
+            active.push_back(q);
+        }
+    }
+    if (active.empty()) {
+        return;
+    }
+
+    BatchScratch scratch;
+    scratch.levels.resize(fPacked[0].fLevel + 1);
+    this->search(0, queries, active.data(), SkToInt(active.size()), results, &scratch);
+}
+
+void SkRTree::search(int nodeIndex, const SkRect queries[], const int active[], int activeCount,
+                     std::vector<int> results[], BatchScratch* scratch) const {
+    const PackedNode& node = fPacked[nodeIndex];
+    BatchScratch::Level& level = scratch->levels[node.fLevel];
+
+    uint32_t children = 0;
+    level.hits.resize(activeCount);
+    for (int q = 0; q < activeCount; q++) {
+        level.hits[q] = Hits(node, queries[active[q]]);
+        children |= level.hits[q];
+    }
+
+    // Visit children in order so each query's results match what search() would find.
+    for (; children; children &= children - 1) {
+        const int i = SkCTZ(children);
+        if (0 == node.fLevel) {
+            for (int q = 0; q < activeCount; q++) {
+                if (level.hits[q] & (1u << i)) {
+                    results[active[q]].push_back(node.fChildren[i]);
+                }
+            }
+        } else {
+            level.next.clear();
+            for (int q = 0; q < activeCount; q++) {
+                if (level.hits[q] & (1u << i)) {
+                    level.next.push_back(active[q]);
+                }
             }
+            this->search(node.fChildren[i], queries, level.next.data(),
+                         SkToInt(level.next.size()), results, scratch);
         }
     }
 }
@@ -162,7 +293,7 @@ void SkRTree::search(Node* node, const SkRect& query, std::vector<int>* results)
 size_t SkRTree::bytesUsed() const {
     size_t byteCount = sizeof(SkRTree);
 
-    byteCount += fNodes.capacity() * sizeof(Node);
+    byteCount += fPacked.capacity() * sizeof(PackedNode);
 
     return byteCount;
 }
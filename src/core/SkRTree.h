@@ -22,6 +22,10 @@
  * which groups rects by position on the Hilbert curve, is probably worth a look). There also
  * exist top-down bulk load variants (VAMSplit, TopDownGreedy, etc).
  *
+ * Once loaded, the tree is packed into a read-only form for searching: nodes are laid out
+ * breadth-first in one contiguous array, and each node stores its children's bounds as
+ * structure-of-arrays so that all of them are tested against a query at once with SIMD.
+ *
  * For more details see:
  *
  *  Beckmann, N.; Kriegel, H. P.; Schneider, R.; Seeger, B. (1990). "The R*-tree:
@@ -35,10 +39,14 @@ public:
     void search(const SkRect& query, std::vector<int>* results) const override;
     size_t bytesUsed() const override;
 
+    // Searches for count queries in a single walk of the tree.  The ops intersecting queries[i]
+    // are appended to results[i], in the same order search(queries[i], &results[i]) finds them.
+    void search(const SkRect queries[], int count, std::vector<int> results[]) const;
+
     // Methods and constants below here are only public for tests.
 
     // Return the depth of the tree structure.
-    int getDepth() const { return fCount ? fRoot.fSubtree->fLevel + 1 : 0; }
+    int getDepth() const { return fCount ? fPacked[0].fLevel + 1 : 0; }
     // Insertion count (not overall node count, which may be greater).
     int getCount() const { return fCount; }
 
@@ -47,6 +55,7 @@ public:
                      kMaxChildren = 11;
 
 private:
+    // Branches and Nodes are only used while bulk loading; they are then packed into PackedNodes.
     struct Node;
 
     struct Branch {
@@ -63,7 +72,26 @@ private:
         Branch fChildren[kMaxChildren];
     };
 
-    void search(Node* root, const SkRect& query, std::vector<int>* results) const;
+    // A node as searched.  Unused lanes have bounds that intersect nothing, so every lane can be
+    // tested without looking at fNumChildren.
+    static constexpr int kLanes = 16;
+    static_assert(kMaxChildren <= kLanes, "");
+
+    struct PackedNode {
+        float    fLeft[kLanes], fTop[kLanes], fRight[kLanes], fBottom[kLanes];
+        int32_t  fChildren[kLanes];  // Op indices at level 0, otherwise indices into fPacked.
+        uint16_t fNumChildren;
+        uint16_t fLevel;
+    };
+
+    // Returns a bit per child of node, set if that child intersects query.
+    static uint32_t Hits(const PackedNode& node, const SkRect& query);
+
+    struct BatchScratch;
+
+    void search(int node, const SkRect& query, std::vector<int>* results) const;
+    void search(int node, const SkRect queries[], const int active[], int activeCount,
+                std::vector<int> results[], BatchScratch*) const;
 
     // Consumes the input array.
     Branch bulkLoad(std::vector<Branch>* branches, int level = 0);
@@ -73,10 +101,14 @@ private:
 
     Node* allocateNodeAtLevel(uint16_t level);
 
+    // Lays out the tree under root breadth-first in fPacked, then frees fNodes.
+    void pack(const Node* root);
+
     // This is the count of data elements (rather than total nodes in the tree)
     int fCount;
-    Branch fRoot;
+    SkRect fRootBounds;
     std::vector<Node> fNodes;
+    std::vector<PackedNode> fPacked;
 };
 
 #endif
@@ -84,6 +84,12 @@ public:
         }
     }
 
+    // Overwrites the current clip with one captured elsewhere, e.g. from a deferred draw.
+    void replaceClip(const SkRasterClip& rc) {
+        this->writable_rc() = rc;
+        this->validate();
+    }
+
     void validate() const {
 #ifdef SK_DEBUG
         const SkRasterClip& clip = this->rc();
@@ -7,11 +7,18 @@
 
 #include "src/core/SkRecordOpts.h"
 
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkShader.h"
 #include "include/private/SkTDArray.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkRRectPriv.h"
 #include "src/core/SkRecordPattern.h"
 #include "src/core/SkRecords.h"
 
+#include <vector>
+
 using namespace SkRecords;
 
 // Most of the optimizations in this file are pattern-based.  These are all defined as structs with:
@@ -19,24 +26,24 @@ using namespace SkRecords;
 //   - a bool onMatch(SkRceord*, Match*, int begin, int end) method,
 //     which returns true if it made changes and false if not.
 
-// Run a pattern-based optimization once across the SkRecord, returning true if it made any changes.
+// Run a pattern-based optimization once across the SkRecord, returning how many matches it changed.
 // It looks for spans which match Pass::Match, and when found calls onMatch() with that pattern,
 // record, and [begin,end) span of the commands that matched.
 template <typename Pass>
-static bool apply(Pass* pass, SkRecord* record) {
+static int apply(Pass* pass, SkRecord* record) {
     typename Pass::Match match;
-    bool changed = false;
+    int changed = 0;
     int begin, end = 0;
 
     while (match.search(record, &begin, &end)) {
-        changed |= pass->onMatch(record, &match, begin, end);
+        changed += pass->onMatch(record, &match, begin, end) ? 1 : 0;
     }
     return changed;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-static void multiple_set_matrices(SkRecord* record) {
+static int multiple_set_matrices(SkRecord* record) {
     struct {
         typedef Pattern<Is<SetMatrix>,
                         Greedy<Is<NoOp>>,
@@ -48,7 +55,11 @@ static void multiple_set_matrices(SkRecord* record) {
             return true;
         }
     } pass;
-    while (apply(&pass, record));
+    int changed = 0;
+    while (int n = apply(&pass, record)) {
+        changed += n;
+    }
+    return changed;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -161,12 +172,16 @@ struct SaveNoDrawsRestoreNooper {
         return true;
     }
 };
-void SkRecordNoopSaveRestores(SkRecord* record) {
+int SkRecordNoopSaveRestores(SkRecord* record) {
     SaveOnlyDrawsRestoreNooper onlyDraws;
     SaveNoDrawsRestoreNooper noDraws;
 
     // Run until they stop changing things.
-    while (apply(&onlyDraws, record) || apply(&noDraws, record));
+    int changed = 0, n;
+    while ((n = apply(&onlyDraws, record)) || (n = apply(&noDraws, record))) {
+        changed += n;
+    }
+    return changed;
 }
 
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
@@ -218,9 +233,9 @@ struct SaveLayerDrawRestoreNooper {
         return true;
     }
 };
-void SkRecordNoopSaveLayerDrawRestores(SkRecord* record) {
+int SkRecordNoopSaveLayerDrawRestores(SkRecord* record) {
     SaveLayerDrawRestoreNooper pass;
-    apply(&pass, record);
+    return apply(&pass, record);
 }
 #endif
 
@@ -273,14 +288,262 @@ struct SvgOpacityAndFilterLayerMergePass {
     }
 };
 
-void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
+int SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
     SvgOpacityAndFilterLayerMergePass pass;
-    apply(&pass, record);
+    return apply(&pass, record);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// True if a non-antialiased draw with this paint leaves every pixel it covers opaque, no matter
+// what was there before.  Image draws ignore the paint's style and path effect.
+static bool paint_overwrites_opaquely(const SkPaint* paint, bool isImageDraw) {
+    if (!paint) {
+        return true;
+    }
+    if (paint->isAntiAlias() ||
+        paint->getAlpha() != 0xFF ||
+        paint->getMaskFilter() ||
+        paint->getImageFilter() ||
+        (paint->getShader() && !paint->getShader()->isOpaque()) ||
+        (paint->getColorFilter() && !paint->getColorFilter()->isAlphaUnchanged())) {
+        return false;
+    }
+    if (!isImageDraw && (paint->getStyle() != SkPaint::kFill_Style || paint->getPathEffect())) {
+        return false;
+    }
+    auto mode = paint->asBlendMode();
+    return mode && (*mode == SkBlendMode::kSrcOver || *mode == SkBlendMode::kSrc);
+}
+
+// Walks the record backwards, collecting the areas that later opaque draws are known to cover.
+// Every draw in a run shares the same matrix and clip, so the areas are kept in local space; any
+// command that changes the matrix or clip, or that might read back the destination, ends the run.
+//
+// A draw can only be removed if it is not antialiased: its pixels are then exactly those whose
+// centers it contains, and those are all overwritten by a covering non-antialiased occluder.
+class OccludedDrawNooper {
+public:
+    explicit OccludedDrawNooper(SkRecord* record) : fRecord(record) {}
+
+    int run() {
+        for (int i = fRecord->count(); i --> 0;) {
+            fRemove = false;
+            fRecord->visit(i, *this);
+            if (fRemove) {
+                fRecord->replace<NoOp>(i);
+                fRemoved++;
+            }
+        }
+        return fRemoved;
+    }
+
+    // State changes, layers, and anything else that isn't a simple draw end the run.
+    template <typename T>
+    std::enable_if_t<!(T::kTags & kDraw_Tag)> operator()(const T&) { fOccluderCount = 0; }
+
+    // Nested pictures and drawables may contain layers that read back the destination.
+    void operator()(const DrawPicture&)  { fOccluderCount = 0; }
+    void operator()(const DrawDrawable&) { fOccluderCount = 0; }
+    void operator()(const DrawBehind&)   { fOccluderCount = 0; }
+
+    void operator()(const NoOp&) {}
+    void operator()(const DrawAnnotation&) {}
+
+    // Other draws don't occlude anything and are never removed, but they don't end the run either.
+    template <typename T>
+    std::enable_if_t<SkToBool(T::kTags & kDraw_Tag)> operator()(const T&) {}
+
+    void operator()(const DrawRect& op) {
+        this->tryRemove(op.rect, &op.paint);
+        if (paint_overwrites_opaquely(&op.paint, false)) {
+            this->addOccluder(op.rect.makeSorted());  // SkCanvas sorts rects before drawing.
+        }
+    }
+    void operator()(const DrawRRect& op) {
+        this->tryRemove(op.rrect.getBounds(), &op.paint);
+        if (paint_overwrites_opaquely(&op.paint, false)) {
+            this->addOccluder(SkRRectPriv::InnerBounds(op.rrect));
+        }
+    }
+    void operator()(const DrawImage& op) {
+        SkRect dst = SkRect::MakeXYWH(op.left, op.top, op.image->width(), op.image->height());
+        this->tryRemoveImage(dst, op.paint);
+        if (op.image->isOpaque() && paint_overwrites_opaquely(op.paint, true)) {
+            this->addOccluder(dst);
+        }
+    }
+    void operator()(const DrawImageRect& op) {
+        this->tryRemoveImage(op.dst, op.paint);
+        // A src that hangs off the image only draws the part of dst mapped from inside the image.
+        if (op.image->isOpaque() && paint_overwrites_opaquely(op.paint, true) &&
+            SkRect::Make(op.image->bounds()).contains(op.src)) {
+            this->addOccluder(op.dst);
+        }
+    }
+
+    void operator()(const DrawDRRect& op) { this->tryRemove(op.outer.getBounds(), &op.paint); }
+    void operator()(const DrawOval& op)   { this->tryRemove(op.oval, &op.paint); }
+    void operator()(const DrawArc& op)    { this->tryRemove(op.oval, &op.paint); }
+    void operator()(const DrawRegion& op) {
+        this->tryRemove(SkRect::Make(op.region.getBounds()), &op.paint);
+    }
+    void operator()(const DrawPath& op) {
+        if (!op.path.isInverseFillType()) {
+            this->tryRemove(op.path.getBounds(), &op.paint);
+        }
+    }
+
+private:
+    static constexpr int kMaxOccluders = 8;
+
+    void tryRemove(const SkRect& bounds, const SkPaint* paint) {
+        // Hairlines are drawn at least a pixel wide no matter how small their local bounds are,
+        // and mask and image filters may draw outside them.
+        if (paint->isAntiAlias() || paint->getMaskFilter() || paint->getImageFilter() ||
+            (paint->getStyle() != SkPaint::kFill_Style && paint->getStrokeWidth() == 0) ||
+            !paint->canComputeFastBounds()) {
+            return;
+        }
+        SkRect storage;
+        this->tryRemove(paint->computeFastBounds(bounds, &storage));
+    }
+
+    void tryRemoveImage(const SkRect& dst, const SkPaint* paint) {
+        if (paint && (paint->isAntiAlias() || paint->getMaskFilter() || paint->getImageFilter())) {
+            return;
+        }
+        this->tryRemove(dst);
+    }
+
+    void tryRemove(const SkRect& bounds) {
+        const SkRect sorted = bounds.makeSorted();
+        for (int i = 0; i < fOccluderCount; i++) {
+            if (fOccluders[i].contains(sorted)) {
+                fRemove = true;
+                return;
+            }
+        }
+    }
+
+    void addOccluder(const SkRect& rect) {
+        if (rect.isEmpty() || !rect.isFinite()) {
+            return;
+        }
+        // Keep the largest occluders, skipping any that would add nothing new.
+        int smallest = 0;
+        for (int i = 0; i < fOccluderCount; i++) {
+            if (fOccluders[i].contains(rect)) {
+                return;
+            }
+            if (area(fOccluders[i]) < area(fOccluders[smallest])) {
+                smallest = i;
+            }
+        }
+        if (fOccluderCount < kMaxOccluders) {
+            fOccluders[fOccluderCount++] = rect;
+        } else if (area(rect) > area(fOccluders[smallest])) {
+            fOccluders[smallest] = rect;
+        }
+    }
+
+    static float area(const SkRect& r) { return r.width() * r.height(); }
+
+    SkRecord* fRecord;
+    SkRect    fOccluders[kMaxOccluders];
+    int       fOccluderCount = 0;
+    int       fRemoved = 0;
+    bool      fRemove = false;
+};
+
+int SkRecordNoopOccludedDraws(SkRecord* record) {
+    return OccludedDrawNooper(record).run();
+}
+
+// DrawImageRects can be merged into a DrawEdgeAAImageSet when their paints match in everything
+// but alpha and antialiasing, which the set carries per entry.  SkCanvas draws such a set by
+// drawing each entry as an image rect with that entry's alpha and antialiasing restored.
+static SkPaint image_set_paint(const SkPaint* paint) {
+    SkPaint shared = paint ? *paint : SkPaint();
+    shared.setAlphaf(1.0f);
+    shared.setAntiAlias(false);
+    return shared;
+}
+
+static bool can_merge_image_rects(const DrawImageRect& a, const DrawImageRect& b) {
+    return a.sampling == b.sampling &&
+           a.constraint == b.constraint &&
+           image_set_paint(a.paint) == image_set_paint(b.paint);
+}
+
+int SkRecordMergeImageRects(SkRecord* record) {
+    int merged = 0;
+    std::vector<int> run;
+    for (int i = 0; i < record->count();) {
+        Is<DrawImageRect> first;
+        if (!record->mutate(i, first) ||
+            (first.get()->paint && first.get()->paint->getImageFilter())) {
+            i++;
+            continue;
+        }
+
+        // Collect the DrawImageRects that can be merged with the first, skipping over NoOps.
+        run = {i};
+        int end = i + 1;
+        for (; end < record->count(); end++) {
+            Is<NoOp> noop;
+            Is<DrawImageRect> next;
+            if (record->mutate(end, noop)) {
+                continue;
+            }
+            if (!record->mutate(end, next) || !can_merge_image_rects(*first.get(), *next.get())) {
+                break;
+            }
+            run.push_back(end);
+        }
+
+        if (run.size() > 1) {
+            const int count = SkToInt(run.size());
+            SkAutoTArray<SkCanvas::ImageSetEntry> set(count);
+            for (int j = 0; j < count; j++) {
+                Is<DrawImageRect> entry;
+                record->mutate(run[j], entry);
+                const DrawImageRect& op = *entry.get();
+                set[j] = SkCanvas::ImageSetEntry(op.image, op.src, op.dst,
+                                                 op.paint ? op.paint->getAlphaf() : 1.0f,
+                                                 op.paint && op.paint->isAntiAlias()
+                                                         ? SkCanvas::kAll_QuadAAFlags
+                                                         : SkCanvas::kNone_QuadAAFlags);
+            }
+
+            SkPaint* paint = nullptr;
+            SkPaint shared = image_set_paint(first.get()->paint);
+            if (shared != SkPaint()) {
+                paint = new (record->alloc<SkPaint>()) SkPaint(shared);
+            }
+            SkSamplingOptions sampling = first.get()->sampling;
+            SkCanvas::SrcRectConstraint constraint = first.get()->constraint;
+
+            for (int j = 1; j < count; j++) {
+                record->replace<NoOp>(run[j]);
+            }
+            new (record->replace<DrawEdgeAAImageSet>(run[0])) DrawEdgeAAImageSet{
+                    paint, std::move(set), count, nullptr, nullptr, sampling, constraint};
+            merged += count;
+        }
+        i = end;
+    }
+    return merged;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-void SkRecordOptimize(SkRecord* record) {
+void SkRecordOptimize(SkRecord* record, SkRecordOptimizeStats* stats) {
+    SkRecordOptimizeStats ignored;
+    if (!stats) {
+        stats = &ignored;
+    }
+
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
     // and the bounding box hierarchy will do the work of skipping no-op
@@ -294,21 +557,33 @@ void SkRecordOptimize(SkRecord* record) {
     // because it makes the following Android CTS test fail:
     // android.uirendering.cts.testclasses.LayerTests#testSaveLayerClippedWithAlpha
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
-    SkRecordNoopSaveLayerDrawRestores(record);
+    stats->fNoopSaveLayerDrawRestores += SkRecordNoopSaveLayerDrawRestores(record);
 #endif
-    SkRecordMergeSvgOpacityAndFilterLayers(record);
+    stats->fMergedSvgOpacityLayers += SkRecordMergeSvgOpacityAndFilterLayers(record);
+
+    // Run after the layer passes, which may have flattened layers into plain draws.
+    stats->fOccludedDraws += SkRecordNoopOccludedDraws(record);
 
     record->defrag();
 }
 
-void SkRecordOptimize2(SkRecord* record) {
-    multiple_set_matrices(record);
-    SkRecordNoopSaveRestores(record);
+void SkRecordOptimize2(SkRecord* record, SkRecordOptimizeStats* stats) {
+    SkRecordOptimizeStats ignored;
+    if (!stats) {
+        stats = &ignored;
+    }
+
+    stats->fMultipleSetMatrices += multiple_set_matrices(record);
+    stats->fNoopSaveRestores += SkRecordNoopSaveRestores(record);
     // See why we turn this off in SkRecordOptimize above.
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
-    SkRecordNoopSaveLayerDrawRestores(record);
+    stats->fNoopSaveLayerDrawRestores += SkRecordNoopSaveLayerDrawRestores(record);
 #endif
-    SkRecordMergeSvgOpacityAndFilterLayers(record);
+    stats->fMergedSvgOpacityLayers += SkRecordMergeSvgOpacityAndFilterLayers(record);
+    stats->fOccludedDraws += SkRecordNoopOccludedDraws(record);
+    // Merging changes how the GPU backend batches and antialiases these draws, so it's only
+    // done here for now.
+    stats->fMergedImageRects += SkRecordMergeImageRects(record);
 
     record->defrag();
 }
@@ -10,23 +10,43 @@
 
 #include "src/core/SkRecord.h"
 
-// Run all optimizations in recommended order.
-void SkRecordOptimize(SkRecord*);
+// How many changes each pass made during SkRecordOptimize() or SkRecordOptimize2().
+struct SkRecordOptimizeStats {
+    int fNoopSaveRestores          = 0;  // Save-Restore pairs and spans turned into NoOps
+    int fNoopSaveLayerDrawRestores = 0;  // SaveLayers folded into their single draw
+    int fMergedSvgOpacityLayers    = 0;  // SVG opacity layers folded into filter layers
+    int fMultipleSetMatrices       = 0;  // SetMatrix ops made redundant by the next one
+    int fOccludedDraws             = 0;  // draws hidden by a later opaque draw
+    int fMergedImageRects          = 0;  // DrawImageRects folded into DrawEdgeAAImageSets
+};
+
+// Run all optimizations in recommended order.  If stats is not null, the number of changes made
+// by each pass is added to it.
+void SkRecordOptimize(SkRecord*, SkRecordOptimizeStats* stats = nullptr);
 
 // Turns logical no-op Save-[non-drawing command]*-Restore patterns into actual no-ops.
-void SkRecordNoopSaveRestores(SkRecord*);
+// Returns the number of patterns no-op'd.
+int SkRecordNoopSaveRestores(SkRecord*);
 
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
 // For some SaveLayer-[drawing command]-Restore patterns, merge the SaveLayer's alpha into the
-// draw, and no-op the SaveLayer and Restore.
-void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
+// draw, and no-op the SaveLayer and Restore.  Returns the number of SaveLayers removed.
+int SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 #endif
 
 // For SVG generated SaveLayer-Save-ClipRect-SaveLayer-3xRestore patterns, merge
-// the alpha of the first SaveLayer to the second SaveLayer.
-void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
+// the alpha of the first SaveLayer to the second SaveLayer.  Returns the number of merges.
+int SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
+
+// No-ops non-antialiased draws that are completely covered by a later opaque, non-antialiased
+// rect, rrect, or image draw under the same matrix and clip.  Returns the number of draws removed.
+int SkRecordNoopOccludedDraws(SkRecord*);
+
+// Merges runs of DrawImageRects that differ only in image, rects, alpha, and antialiasing into a
+// single DrawEdgeAAImageSet.  Returns the number of DrawImageRects merged.
+int SkRecordMergeImageRects(SkRecord*);
 
 // Experimental optimizers
-void SkRecordOptimize2(SkRecord*);
+void SkRecordOptimize2(SkRecord*, SkRecordOptimizeStats* stats = nullptr);
 
 #endif//SkRecordOpts_DEFINED
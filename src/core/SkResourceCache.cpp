@@ -9,6 +9,7 @@
 
 #include "include/core/SkTraceMemoryDump.h"
 #include "include/private/base/SkMutex.h"
+#include "include/private/base/SkOnce.h"
 #include "include/private/base/SkTo.h"
 #include "src/core/SkDiscardableMemory.h"
 #include "src/core/SkImageFilter_Base.h"
@@ -16,8 +17,10 @@
 #include "src/core/SkMipmap.h"
 #include "src/core/SkOpts.h"
 
+#include <atomic>
 #include <stddef.h>
 #include <stdlib.h>
+#include <utility>
 
 DECLARE_SKMESSAGEBUS_MESSAGE(SkResourceCache::PurgeSharedIDMessage, uint32_t, true)
 
@@ -75,6 +78,12 @@ namespace {
 class SkResourceCache::Hash :
     public SkTHashTable<SkResourceCache::Rec*, SkResourceCache::Key, HashTraits> {};
 
+struct SkResourceCache::SharedBudget {
+    std::atomic<size_t> fBytesUsed{0};
+    std::atomic<int>    fCount{0};
+    int                 fShardCount = 1;
+};
+
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -86,6 +95,8 @@ void SkResourceCache::init() {
     fCount = 0;
     fSingleAllocationByteLimit = 0;
 
+    fSharedBudget = nullptr;
+
     // One of these should be explicit set by the caller after we return.
     fTotalByteLimit = 0;
     fDiscardableFactory = nullptr;
@@ -103,6 +114,15 @@ SkResourceCache::SkResourceCache(size_t byteLimit)
     fTotalByteLimit = byteLimit;
 }
 
+SkResourceCache::SkResourceCache(DiscardableFactory factory, size_t byteLimit,
+                                 SharedBudget* budget)
+        : fPurgeSharedIDInbox(SK_InvalidUniqueID) {
+    this->init();
+    fDiscardableFactory = factory;
+    fTotalByteLimit = factory ? 0 : byteLimit;
+    fSharedBudget = budget;
+}
+
 SkResourceCache::~SkResourceCache() {
     Rec* rec = fHead;
     while (rec) {
@@ -122,12 +142,15 @@ bool SkResourceCache::find(const Key& key, FindVisitor visitor, void* context) {
         Rec* rec = *found;
         if (visitor(*rec, context)) {
             this->moveToHead(rec);  // for our LRU
+            fStats.fHits++;
             return true;
         } else {
             this->remove(rec);  // stale
+            fStats.fMisses++;
             return false;
         }
     }
+    fStats.fMisses++;
     return false;
 }
 
@@ -187,6 +210,10 @@ void SkResourceCache::remove(Rec* rec) {
 
     fTotalBytesUsed -= used;
     fCount -= 1;
+    if (fSharedBudget) {
+        fSharedBudget->fBytesUsed.fetch_sub(used, std::memory_order_relaxed);
+        fSharedBudget->fCount.fetch_sub(1, std::memory_order_relaxed);
+    }
 
     //SkDebugf("-RC count [%3d] bytes %d\n", fCount, fTotalBytesUsed);
 
@@ -215,18 +242,33 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
 
     Rec* rec = fTail;
     while (rec) {
-        if (!forcePurge && fTotalBytesUsed < byteLimit && fCount < countLimit) {
+        if (!forcePurge && !this->isOverBudget(byteLimit, countLimit)) {
             break;
         }
 
         Rec* prev = rec->fPrev;
         if (rec->canBePurged()) {
             this->remove(rec);
+            fStats.fEvictions++;
         }
         rec = prev;
     }
 }
 
+bool SkResourceCache::isOverBudget(size_t byteLimit, int countLimit) const {
+    if (fSharedBudget) {
+        // Other shards may be changing these, so this is only approximately the global total.
+        bool over = fSharedBudget->fBytesUsed.load(std::memory_order_relaxed) >= byteLimit ||
+                    fSharedBudget->fCount.load(std::memory_order_relaxed) >= countLimit;
+        // A shard only gives up entries while it holds more than its share of the budget, so
+        // that entries in other shards can't push out everything (including what was just added)
+        // from a lightly used one. Whenever the total is over, some shard is over its share.
+        const int n = fSharedBudget->fShardCount;
+        return over && (fTotalBytesUsed > byteLimit / n || fCount > countLimit / n);
+    }
+    return fTotalBytesUsed >= byteLimit || fCount >= countLimit;
+}
+
 //#define SK_TRACK_PURGE_SHAREDID_HITRATE
 
 #ifdef SK_TRACK_PURGE_SHAREDID_HITRATE
@@ -358,6 +400,10 @@ void SkResourceCache::addToHead(Rec* rec) {
     }
     fTotalBytesUsed += rec->bytesUsed();
     fCount += 1;
+    if (fSharedBudget) {
+        fSharedBudget->fBytesUsed.fetch_add(rec->bytesUsed(), std::memory_order_relaxed);
+        fSharedBudget->fCount.fetch_add(1, std::memory_order_relaxed);
+    }
 
     this->validate();
 }
@@ -452,94 +498,179 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static SkResourceCache* gResourceCache = nullptr;
-static SkMutex& resource_cache_mutex() {
-    static SkMutex& mutex = *(new SkMutex);
-    return mutex;
-}
+// Keys are spread over the shards by the top bits of their hash; SkTHashTable uses the low bits.
+class SkResourceCache::Shards {
+public:
+    static constexpr int kCount = 16;
 
-/** Must hold resource_cache_mutex() when calling. */
-static SkResourceCache* get_cache() {
-    // resource_cache_mutex() is always held when this is called, so we don't need to be fancy in here.
-    resource_cache_mutex().assertHeld();
-    if (nullptr == gResourceCache) {
+    static Shards* Get() {
+        static SkOnce once;
+        static Shards* shards;
+        once([]{
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
+            shards = new Shards(SkDiscardableMemory::Create, SK_DEFAULT_IMAGE_CACHE_LIMIT);
 #else
-        gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+            shards = new Shards(nullptr, SK_DEFAULT_IMAGE_CACHE_LIMIT);
 #endif
+        });
+        return shards;
+    }
+
+    Shards(DiscardableFactory factory, size_t byteLimit) : fDiscardableFactory(factory) {
+        fBudget.fShardCount = kCount;
+        for (Shard& shard : fShards) {
+            shard.fCache = new SkResourceCache(fDiscardableFactory, byteLimit, &fBudget);
+        }
+    }
+
+    ~Shards() {
+        for (Shard& shard : fShards) {
+            delete shard.fCache;
+        }
+    }
+
+    // Calls fn(cache) with the shard responsible for key locked.
+    template <typename Fn>
+    auto withShard(const Key& key, Fn&& fn) {
+        return this->withShard(SkToInt(key.hash() >> 28), std::forward<Fn>(fn));
+    }
+
+    template <typename Fn>
+    auto withShard(int index, Fn&& fn) {
+        Shard& shard = fShards[index];
+        SkAutoMutexExclusive am(shard.fMutex);
+        return fn(shard.fCache);
+    }
+
+    // Calls fn(index, cache) for every shard in turn, each locked while it is visited.
+    template <typename Fn>
+    void forEachShard(Fn&& fn) {
+        for (int i = 0; i < kCount; i++) {
+            SkAutoMutexExclusive am(fShards[i].fMutex);
+            fn(i, fShards[i].fCache);
+        }
+    }
+
+    bool find(const Key& key, FindVisitor visitor, void* context) {
+        return this->withShard(key, [&](SkResourceCache* cache) {
+            return cache->find(key, visitor, context);
+        });
+    }
+
+    void add(Rec* rec, void* payload) {
+        this->withShard(rec->getKey(), [&](SkResourceCache* cache) { cache->add(rec, payload); });
     }
-    return gResourceCache;
-}
+
+    void checkMessages() {
+        this->forEachShard([](int, SkResourceCache* cache) { cache->checkMessages(); });
+    }
+
+    void dumpMemoryStatistics(SkTraceMemoryDump* dump);
+
+    size_t totalBytesUsed() const { return fBudget.fBytesUsed.load(std::memory_order_relaxed); }
+
+    DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
+
+private:
+    static_assert(kCount == 16, "withShard() uses the top four bits of the hash");
+
+    struct Shard {
+        SkMutex          fMutex;
+        SkResourceCache* fCache;
+    };
+
+    Shard              fShards[kCount];
+    SharedBudget       fBudget;
+    DiscardableFactory fDiscardableFactory;
+};
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getTotalBytesUsed();
+    return Shards::Get()->totalBytesUsed();
 }
 
+// The shards all share the same limits, so any one of them can answer for the others.
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getTotalByteLimit();
+    return Shards::Get()->withShard(0, [](SkResourceCache* cache) {
+        return cache->getTotalByteLimit();
+    });
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->setTotalByteLimit(newLimit);
+    // Every shard checks the shared total against the same limit.
+    size_t prevLimit = 0;
+    Shards::Get()->forEachShard([&](int i, SkResourceCache* cache) {
+        size_t prev = cache->setTotalByteLimit(newLimit);
+        if (i == 0) {
+            prevLimit = prev;
+        }
+    });
+    return prevLimit;
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->discardableFactory();
+    return Shards::Get()->discardableFactory();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->newCachedData(bytes);
+    // Like newCachedData(), handle any pending purges first. The allocation itself doesn't
+    // touch the shards, so it happens outside their locks.
+    CheckMessages();
+    if (DiscardableFactory factory = Shards::Get()->discardableFactory()) {
+        SkDiscardableMemory* dm = factory(bytes);
+        return dm ? new SkCachedData(bytes, dm) : nullptr;
+    }
+    return new SkCachedData(sk_malloc_throw(bytes), bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    get_cache()->dump();
+    SkDebugf("SkResourceCache: %d shards, %zu bytes total\n",
+             Shards::kCount, Shards::Get()->totalBytesUsed());
+    Shards::Get()->forEachShard([](int, SkResourceCache* cache) { cache->dump(); });
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->setSingleAllocationByteLimit(size);
+    size_t prevLimit = 0;
+    Shards::Get()->forEachShard([&](int i, SkResourceCache* cache) {
+        size_t prev = cache->setSingleAllocationByteLimit(size);
+        if (i == 0) {
+            prevLimit = prev;
+        }
+    });
+    return prevLimit;
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getSingleAllocationByteLimit();
+    return Shards::Get()->withShard(0, [](SkResourceCache* cache) {
+        return cache->getSingleAllocationByteLimit();
+    });
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->getEffectiveSingleAllocationByteLimit();
+    return Shards::Get()->withShard(0, [](SkResourceCache* cache) {
+        return cache->getEffectiveSingleAllocationByteLimit();
+    });
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->purgeAll();
+    Shards::Get()->forEachShard([](int, SkResourceCache* cache) { cache->purgeAll(); });
 }
 
 void SkResourceCache::CheckMessages() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->checkMessages();
+    Shards::Get()->checkMessages();
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    return get_cache()->find(key, visitor, context);
+    return Shards::Get()->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec, void* payload) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    get_cache()->add(rec, payload);
+    Shards::Get()->add(rec, payload);
 }
 
 void SkResourceCache::VisitAll(Visitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
-    get_cache()->visitAll(visitor, context);
+    Shards::Get()->forEachShard([&](int, SkResourceCache* cache) {
+        cache->visitAll(visitor, context);
+    });
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
@@ -605,8 +736,43 @@ static void sk_trace_dump_visitor(const SkResourceCache::Rec& rec, void* context
     }
 }
 
-void SkResourceCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
+void SkResourceCache::Shards::dumpMemoryStatistics(SkTraceMemoryDump* dump) {
     // Since resource could be backed by malloc or discardable, the cache always dumps detailed
     // stats to be accurate.
-    VisitAll(sk_trace_dump_visitor, dump);
+    this->forEachShard([dump](int, SkResourceCache* cache) {
+        cache->visitAll(sk_trace_dump_visitor, dump);
+    });
+
+    this->forEachShard([dump](int i, SkResourceCache* cache) {
+        SkString dumpName = SkStringPrintf("skia/sk_resource_cache/shard_%d", i);
+        const Stats& stats = cache->stats();
+        dump->dumpNumericValue(dumpName.c_str(), "hits",      "objects", stats.fHits);
+        dump->dumpNumericValue(dumpName.c_str(), "misses",    "objects", stats.fMisses);
+        dump->dumpNumericValue(dumpName.c_str(), "evictions", "objects", stats.fEvictions);
+    });
+}
+
+void SkResourceCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    Shards::Get()->dumpMemoryStatistics(dump);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkResourceCache::ShardsForTesting::ShardsForTesting(size_t byteLimit)
+    : fShards(new Shards(nullptr, byteLimit)) {}
+
+SkResourceCache::ShardsForTesting::~ShardsForTesting() { delete fShards; }
+
+bool SkResourceCache::ShardsForTesting::find(const Key& key, FindVisitor visitor, void* context) {
+    return fShards->find(key, visitor, context);
+}
+
+void SkResourceCache::ShardsForTesting::add(Rec* rec, void* payload) {
+    fShards->add(rec, payload);
+}
+
+void SkResourceCache::ShardsForTesting::checkMessages() { fShards->checkMessages(); }
+
+void SkResourceCache::ShardsForTesting::dumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    fShards->dumpMemoryStatistics(dump);
 }
@@ -25,6 +25,11 @@ class SkTraceMemoryDump;
  *
  *  As a convenience, a global instance is also defined, which can be safely
  *  access across threads via the static methods (e.g. FindAndLock, etc.).
+ *  The global instance is split by key hash into shards, each an instance of
+ *  this class with its own lock and LRU list, so that threads using different
+ *  keys rarely contend. The shards share one byte (or count) budget: while the
+ *  shards' total is over it, a shard holding more than its share purges its own
+ *  least recently used entries as it is added to.
  */
 class SkResourceCache {
 public:
@@ -117,6 +122,13 @@ public:
 
     typedef const Rec* ID;
 
+    /** Counters for diagnostics. */
+    struct Stats {
+        uint64_t fHits = 0;
+        uint64_t fMisses = 0;     // including stale entries found and purged
+        uint64_t fEvictions = 0;  // entries purged to stay within the budget, or by purgeAll()
+    };
+
     /**
      *  Callback function for find(). If called, the cache will have found a match for the
      *  specified Key, and will pass in the corresponding Rec, along with a caller-specified
@@ -170,7 +182,7 @@ public:
     static void TestDumpMemoryStatistics();
 
     /** Dump memory usage statistics of every Rec in the cache using the
-        SkTraceMemoryDump interface.
+        SkTraceMemoryDump interface, followed by each shard's Stats.
      */
     static void DumpMemoryStatistics(SkTraceMemoryDump* dump);
 
@@ -188,6 +200,29 @@ public:
      */
     static void Dump();
 
+private:
+    // The global cache: a fixed set of shards, each guarded by its own mutex.
+    class Shards;
+
+public:
+    /**
+     *  A set of shards laid out like the global cache's, but owned by the caller, so that tests
+     *  can exercise the sharded, thread-safe paths without touching the global cache.
+     */
+    class ShardsForTesting {
+    public:
+        explicit ShardsForTesting(size_t byteLimit);
+        ~ShardsForTesting();
+
+        bool find(const Key&, FindVisitor, void* context);
+        void add(Rec*, void* payload = nullptr);
+        void checkMessages();
+        void dumpMemoryStatistics(SkTraceMemoryDump*);
+
+    private:
+        Shards* fShards;
+    };
+
     ///////////////////////////////////////////////////////////////////////////
 
     /**
@@ -250,6 +285,8 @@ public:
 
     DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
 
+    const Stats& stats() const { return fStats; }
+
     SkCachedData* newCachedData(size_t bytes);
 
     /**
@@ -258,6 +295,12 @@ public:
     void dump() const;
 
 private:
+    // The totals of all shards, which purgeAsNeeded() checks against the budget.
+    struct SharedBudget;
+
+    // Construct one shard of the global cache.
+    SkResourceCache(DiscardableFactory, size_t byteLimit, SharedBudget*);
+
     Rec*    fHead;
     Rec*    fTail;
 
@@ -271,10 +314,14 @@ private:
     size_t  fSingleAllocationByteLimit;
     int     fCount;
 
+    SharedBudget*       fSharedBudget;
+    Stats               fStats;
+
     SkMessageBus<PurgeSharedIDMessage, uint32_t>::Inbox fPurgeSharedIDInbox;
 
     void checkMessages();
     void purgeAsNeeded(bool forcePurge = false);
+    bool isOverBudget(size_t byteLimit, int countLimit) const;
 
     // linklist management
     void moveToHead(Rec*);
@@ -59,14 +59,102 @@ SkGlyphDigest SkScalerCache::addGlyph(SkGlyph* glyph) {
     SkGlyphDigest digest = SkGlyphDigest{index, *glyph};
     fDigestForPackedGlyphID.set(glyph->getPackedID(), digest);
     fGlyphForIndex.push_back(glyph);
+    this->publish(glyph);
     return digest;
 }
 
+SkGlyph* SkScalerCache::findReady(SkPackedGlyphID packedID, uint8_t flags) const {
+    const ReadTable* table = fReadTable.load(std::memory_order_acquire);
+    if (table == nullptr) {
+        return nullptr;
+    }
+    for (uint32_t i = SkPackedGlyphID::Hash()(packedID) & table->fMask;;
+         i = (i + 1) & table->fMask) {
+        const ReadSlot& slot = table->fSlots[i];
+        SkGlyph* glyph = slot.fGlyph.load(std::memory_order_acquire);
+        if (glyph == nullptr) {
+            return nullptr;
+        }
+        if (glyph->getPackedID() == packedID) {
+            uint8_t ready = slot.fReady.load(std::memory_order_acquire);
+            return (ready & flags) == flags ? glyph : nullptr;
+        }
+    }
+}
+
+template <typename ID>
+size_t SkScalerCache::findReadyPrefix(
+        SkSpan<const ID> glyphIDs, uint8_t flags, const SkGlyph* results[]) const {
+    size_t count = 0;
+    for (auto glyphID : glyphIDs) {
+        const SkGlyph* glyph = this->findReady(SkPackedGlyphID{glyphID}, flags);
+        if (glyph == nullptr) {
+            break;
+        }
+        results[count++] = glyph;
+    }
+    return count;
+}
+
+void SkScalerCache::publish(SkGlyph* glyph) {
+    uint8_t ready = kMetricsReady;
+    if (glyph->setImageHasBeenCalled())    { ready |= kImageReady; }
+    if (glyph->setPathHasBeenCalled())     { ready |= kPathReady; }
+    if (glyph->setDrawableHasBeenCalled()) { ready |= kDrawableReady; }
+
+    auto find = [](const ReadTable* table, SkPackedGlyphID packedID) {
+        uint32_t i = SkPackedGlyphID::Hash()(packedID) & table->fMask;
+        while (true) {
+            SkGlyph* other = table->fSlots[i].fGlyph.load(std::memory_order_relaxed);
+            if (other == nullptr || other->getPackedID() == packedID) {
+                return &table->fSlots[i];
+            }
+            i = (i + 1) & table->fMask;
+        }
+    };
+
+    const ReadTable* table = fReadTable.load(std::memory_order_relaxed);
+    if (table != nullptr) {
+        ReadSlot* slot = find(table, glyph->getPackedID());
+        if (slot->fGlyph.load(std::memory_order_relaxed) != nullptr) {
+            // Only new bits are ever set, so a reader never sees data go away.
+            slot->fReady.fetch_or(ready, std::memory_order_release);
+            return;
+        }
+    }
+
+    const uint32_t capacity = table != nullptr ? table->fMask + 1 : 0;
+    if (2 * SkToU32(fReadTableCount + 1) > capacity) {
+        // Grow into a new table, and publish it once it holds all the old glyphs.
+        const uint32_t newCapacity = std::max(kMinReadTableCapacity, 2 * capacity);
+        ReadTable* newTable = fAlloc.make<ReadTable>(
+                ReadTable{fAlloc.makeArray<ReadSlot>(newCapacity), newCapacity - 1});
+        for (uint32_t i = 0; i < capacity; i++) {
+            const ReadSlot& from = table->fSlots[i];
+            if (SkGlyph* other = from.fGlyph.load(std::memory_order_relaxed)) {
+                ReadSlot* to = find(newTable, other->getPackedID());
+                to->fReady.store(from.fReady.load(std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+                to->fGlyph.store(other, std::memory_order_relaxed);
+            }
+        }
+        fReadTable.store(newTable, std::memory_order_release);
+        table = newTable;
+    }
+
+    // Set the flags before the glyph, so a reader that finds the glyph also finds its flags.
+    ReadSlot* slot = find(table, glyph->getPackedID());
+    slot->fReady.store(ready, std::memory_order_relaxed);
+    slot->fGlyph.store(glyph, std::memory_order_release);
+    fReadTableCount++;
+}
+
 size_t SkScalerCache::preparePath(SkGlyph* glyph) {
     size_t delta = 0;
     if (glyph->setPath(&fAlloc, fScalerContext.get())) {
         delta = glyph->path()->approximateBytesUsed();
     }
+    this->publish(glyph);
     return delta;
 }
 
@@ -80,6 +168,7 @@ std::tuple<const SkPath*, size_t> SkScalerCache::mergePath(
     if (glyph->setPath(&fAlloc, path, hairline)) {
         pathDelta = glyph->path()->approximateBytesUsed();
     }
+    this->publish(glyph);
     return {glyph->path(), pathDelta};
 }
 
@@ -89,6 +178,7 @@ size_t SkScalerCache::prepareDrawable(SkGlyph* glyph) {
         delta = glyph->drawable()->approximateBytesUsed();
         SkASSERT(delta > 0);
     }
+    this->publish(glyph);
     return delta;
 }
 
@@ -103,6 +193,7 @@ std::tuple<SkDrawable*, size_t> SkScalerCache::mergeDrawable(SkGlyph* glyph,
         delta = glyph->drawable()->approximateBytesUsed();
         SkASSERT(delta > 0);
     }
+    this->publish(glyph);
     return {glyph->drawable(), delta};
 }
 
@@ -133,6 +224,7 @@ std::tuple<const void*, size_t> SkScalerCache::prepareImage(SkGlyph* glyph) {
     if (glyph->setImage(&fAlloc, fScalerContext.get())) {
         delta = glyph->imageSize();
     }
+    this->publish(glyph);
     return {glyph->image(), delta};
 }
 
@@ -151,6 +243,7 @@ std::tuple<SkGlyph*, size_t> SkScalerCache::mergeGlyphAndImage(
             }
             // TODO: assert that any metrics on `from` are the same.
             delta = to->setMetricsAndImage(&fAlloc, from);
+            this->publish(to);
         }
         return {to, delta};
     } else {
@@ -163,16 +256,25 @@ std::tuple<SkGlyph*, size_t> SkScalerCache::mergeGlyphAndImage(
 
 std::tuple<SkSpan<const SkGlyph*>, size_t> SkScalerCache::metrics(
         SkSpan<const SkGlyphID> glyphIDs, const SkGlyph* results[]) {
+    size_t ready = this->findReadyPrefix(glyphIDs, kMetricsReady, results);
+    if (ready == glyphIDs.size()) {
+        return {{results, glyphIDs.size()}, 0};
+    }
     SkAutoMutexExclusive lock{fMu};
-    auto [glyphs, delta] = this->internalPrepare(glyphIDs, kMetricsOnly, results);
-    return {glyphs, delta};
+    auto [_, delta] = this->internalPrepare(glyphIDs.subspan(ready), kMetricsOnly, results + ready);
+    return {{results, glyphIDs.size()}, delta};
 }
 
 std::tuple<SkSpan<const SkGlyph*>, size_t> SkScalerCache::preparePaths(
         SkSpan<const SkGlyphID> glyphIDs, const SkGlyph* results[]) {
+    size_t ready = this->findReadyPrefix(glyphIDs, kPathReady, results);
+    if (ready == glyphIDs.size()) {
+        return {{results, glyphIDs.size()}, 0};
+    }
     SkAutoMutexExclusive lock{fMu};
-    auto [glyphs, delta] = this->internalPrepare(glyphIDs, kMetricsAndPath, results);
-    return {glyphs, delta};
+    auto [_, delta] =
+            this->internalPrepare(glyphIDs.subspan(ready), kMetricsAndPath, results + ready);
+    return {{results, glyphIDs.size()}, delta};
 }
 
 size_t SkScalerCache::glyphIDsToPaths(SkSpan<sktext::IDOrPath> idsOrPaths) {
@@ -189,10 +291,14 @@ size_t SkScalerCache::glyphIDsToPaths(SkSpan<sktext::IDOrPath> idsOrPaths) {
 
 std::tuple<SkSpan<const SkGlyph*>, size_t> SkScalerCache::prepareImages(
         SkSpan<const SkPackedGlyphID> glyphIDs, const SkGlyph* results[]) {
-    const SkGlyph** cursor = results;
+    size_t ready = this->findReadyPrefix(glyphIDs, kImageReady, results);
+    if (ready == glyphIDs.size()) {
+        return {{results, glyphIDs.size()}, 0};
+    }
+    const SkGlyph** cursor = results + ready;
     SkAutoMutexExclusive lock{fMu};
     size_t delta = 0;
-    for (auto glyphID : glyphIDs) {
+    for (auto glyphID : glyphIDs.subspan(ready)) {
         auto[glyph, glyphSize] = this->glyph(glyphID);
         auto[_, imageSize] = this->prepareImage(glyph);
         delta += glyphSize + imageSize;
@@ -204,10 +310,14 @@ std::tuple<SkSpan<const SkGlyph*>, size_t> SkScalerCache::prepareImages(
 
 std::tuple<SkSpan<const SkGlyph*>, size_t> SkScalerCache::prepareDrawables(
         SkSpan<const SkGlyphID> glyphIDs, const SkGlyph* results[]) {
-    const SkGlyph** cursor = results;
+    size_t ready = this->findReadyPrefix(glyphIDs, kDrawableReady, results);
+    if (ready == glyphIDs.size()) {
+        return {{results, glyphIDs.size()}, 0};
+    }
+    const SkGlyph** cursor = results + ready;
     SkAutoMutexExclusive lock{fMu};
     size_t delta = 0;
-    for (auto glyphID : glyphIDs) {
+    for (auto glyphID : glyphIDs.subspan(ready)) {
         auto[glyph, glyphSize] = this->glyph(SkPackedGlyphID{glyphID});
         size_t drawableSize = this->prepareDrawable(glyph);
         delta += glyphSize + drawableSize;
@@ -244,9 +354,10 @@ std::tuple<SkScalar, size_t> SkScalerCache::findMaximumGlyphDimension(
 }
 
 template <typename Fn>
-size_t SkScalerCache::commonFilterLoop(SkDrawableGlyphBuffer* accepted, Fn&& fn) {
+size_t SkScalerCache::commonFilterLoop(
+        SkZip<SkGlyphVariant, SkPoint> input, size_t start, Fn&& fn) {
     size_t total = 0;
-    for (auto [i, packedID, pos] : SkMakeEnumerate(accepted->input())) {
+    for (auto [i, packedID, pos] : SkMakeEnumerate(input).last(input.size() - start)) {
         if (SkScalarsAreFinite(pos.x(), pos.y())) {
             auto [digest, size] = this->digest(packedID);
             total += size;
@@ -259,9 +370,31 @@ size_t SkScalerCache::commonFilterLoop(SkDrawableGlyphBuffer* accepted, Fn&& fn)
 }
 
 size_t SkScalerCache::prepareForDrawingMasksCPU(SkDrawableGlyphBuffer* accepted) {
+    SkZip<SkGlyphVariant, SkPoint> input = accepted->input();
+
+    // Accept glyphs whose images are ready without taking the lock. Glyphs are accepted in
+    // input order, so the locked loop below picks up exactly where this one stops.
+    size_t start = 0;
+    for (; start < input.size(); start++) {
+        auto [packedID, pos] = input[start];
+        if (SkScalarsAreFinite(pos.x(), pos.y())) {
+            SkGlyph* glyph = this->findReady(packedID.packedID(), kImageReady);
+            if (glyph == nullptr) {
+                break;
+            }
+            // Empty and too large glyphs have no image.
+            if (glyph->image() != nullptr) {
+                accepted->accept(glyph, start);
+            }
+        }
+    }
+    if (start == input.size()) {
+        return 0;
+    }
+
     SkAutoMutexExclusive lock{fMu};
     size_t imageDelta = 0;
-    size_t delta = this->commonFilterLoop(accepted,
+    size_t delta = this->commonFilterLoop(input, start,
         [&](size_t i, SkGlyphDigest digest, SkPoint pos) SK_REQUIRES(fMu) {
             // If the glyph is too large, then no image is created.
             SkGlyph* glyph = fGlyphForIndex[digest.index()];
@@ -341,9 +474,33 @@ std::tuple<SkRect, size_t> SkScalerCache::prepareForSDFTDrawing(
 
 size_t SkScalerCache::prepareForPathDrawing(
         SkDrawableGlyphBuffer* accepted, SkSourceGlyphBuffer* rejected) {
+    SkZip<SkGlyphVariant, SkPoint> input = accepted->input();
+
+    // As in prepareForDrawingMasksCPU, handle the prefix of glyphs with ready paths lock-free.
+    size_t start = 0;
+    for (; start < input.size(); start++) {
+        auto [packedID, pos] = input[start];
+        if (SkScalarsAreFinite(pos.x(), pos.y())) {
+            SkGlyph* glyph = this->findReady(packedID.packedID(), kPathReady);
+            if (glyph == nullptr) {
+                break;
+            }
+            if (!glyph->isEmpty()) {
+                if (glyph->path() != nullptr) {
+                    accepted->accept(packedID.packedID(), pos);
+                } else {
+                    rejected->reject(start);
+                }
+            }
+        }
+    }
+    if (start == input.size()) {
+        return 0;
+    }
+
     SkAutoMutexExclusive lock{fMu};
     size_t increase = 0;
-    for (auto [i, packedID, pos] : SkMakeEnumerate(accepted->input())) {
+    for (auto [i, packedID, pos] : SkMakeEnumerate(input).last(input.size() - start)) {
         if (SkScalarsAreFinite(pos.x(), pos.y())) {
             auto [digest, glyphIncrease] = this->digest(packedID);
             increase += glyphIncrease;
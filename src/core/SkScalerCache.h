@@ -17,6 +17,7 @@
 #include "src/core/SkGlyph.h"
 #include "src/core/SkGlyphRunPainter.h"
 
+#include <atomic>
 #include <memory>
 
 class SkScalerContext;
@@ -27,6 +28,10 @@ union IDOrDrawable;
 
 // This class represents a strike: a specific combination of typeface, size, matrix, etc., and
 // holds the glyphs for that strike.
+//
+// Glyphs are created, and their images, paths and drawables are generated, while holding fMu.
+// Once a glyph and the data a call needs exist, the call is answered from a lock-free table
+// instead, so many threads drawing the same text do not serialize on fMu.
 class SkScalerCache {
 public:
     SkScalerCache(std::unique_ptr<SkScalerContext> scaler,
@@ -109,8 +114,30 @@ public:
     SkScalerContext* getScalerContext() const { return fScalerContext.get(); }
 
 private:
+    // The parts of a glyph that have been published to lock-free readers.
+    enum ReadyFlags : uint8_t {
+        kMetricsReady  = 1 << 0,
+        kImageReady    = 1 << 1,
+        kPathReady     = 1 << 2,
+        kDrawableReady = 1 << 3,
+    };
+
+    // Return the glyph for packedID if it exists and all of flags are ready; otherwise, return
+    // nullptr. This does not take fMu.
+    SkGlyph* findReady(SkPackedGlyphID packedID, uint8_t flags) const;
+
+    // Fill results with the ready glyphs for the longest prefix of glyphIDs, and return the
+    // length of that prefix. This does not take fMu.
+    template <typename ID>
+    size_t findReadyPrefix(
+            SkSpan<const ID> glyphIDs, uint8_t flags, const SkGlyph* results[]) const;
+
+    // Add glyph to the lock-free table, or update its ready flags if it is already there.
+    void publish(SkGlyph* glyph) SK_REQUIRES(fMu);
+
     template <typename Fn>
-    size_t commonFilterLoop(SkDrawableGlyphBuffer* accepted, Fn&& fn) SK_REQUIRES(fMu);
+    size_t commonFilterLoop(SkZip<SkGlyphVariant, SkPoint> input, size_t start, Fn&& fn)
+            SK_REQUIRES(fMu);
 
     // Return a glyph. Create it if it doesn't exist, and initialize the glyph with metrics and
     // advances using a scaler.
@@ -155,6 +182,22 @@ private:
             fDigestForPackedGlyphID SK_GUARDED_BY(fMu);
     std::vector<SkGlyph*> fGlyphForIndex SK_GUARDED_BY(fMu);
 
+    // An insert-only, open addressed hash table of the glyphs in fGlyphForIndex, kept at most
+    // half full. Only writers holding fMu insert glyphs or set ready flags; readers only load.
+    // When the table grows, a new one is published and the old one stays in fAlloc until the
+    // strike is deleted, so readers never see a freed table.
+    struct ReadSlot {
+        std::atomic<SkGlyph*> fGlyph{nullptr};
+        std::atomic<uint8_t>  fReady{0};
+    };
+    struct ReadTable {
+        ReadSlot* fSlots;
+        uint32_t  fMask;  // The capacity is a power of 2.
+    };
+    std::atomic<const ReadTable*> fReadTable{nullptr};
+    int fReadTableCount SK_GUARDED_BY(fMu) {0};
+    inline static constexpr uint32_t kMinReadTableCapacity = 64;
+
     // so we don't grow our arrays a lot
     inline static constexpr size_t kMinGlyphCount = 8;
     inline static constexpr size_t kMinGlyphImageSize = 16 /* height */ * 8 /* width */;
@@ -0,0 +1,356 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkThreadedBitmapDevice.h"
+
+#include "include/core/SkBlender.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkTextBlob.h"
+#include "include/core/SkVertices.h"
+#include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/text/GlyphRun.h"
+
+namespace {
+
+// Matches SkDrawTiler: past this size SkBitmapDevice translates into sub-tiles itself, so we
+// don't defer and leave the drawing to it.
+constexpr int kMaxDeferredDim = 8192 - 1;
+
+// Conservative local bounds of a draw with paint, or nullptr if they can't be computed.
+const SkRect* paint_bounds(const SkRect& r, const SkPaint& paint, SkRect* storage) {
+    if (!paint.canComputeFastBounds()) {
+        return nullptr;
+    }
+    *storage = paint.computeFastBounds(r, storage);
+    return storage;
+}
+
+// Whether a rect filled with paint under ctm covers exactly the same pixels when its clip is
+// intersected with a tile. Such fills are scan converted a pixel at a time against the clip; any
+// draw built from edges is instead chopped at the clip bounds, which shifts its rasterization.
+bool is_tile_safe_fill(const SkMatrix& ctm, const SkPaint& paint) {
+    return paint.getStyle() == SkPaint::kFill_Style &&
+           !paint.getPathEffect() &&
+           !paint.getMaskFilter() &&
+           ctm.rectStaysRect();
+}
+
+}  // namespace
+
+SkThreadedBitmapDevice::SkThreadedBitmapDevice(const SkBitmap& bitmap,
+                                               const SkSurfaceProps& surfaceProps,
+                                               SkExecutor* executor,
+                                               int tileSize)
+        : INHERITED(bitmap, surfaceProps)
+        , fExecutor(executor)
+        , fTileSize(tileSize) {
+    SkASSERT(fTileSize > 0);
+    if (!fExecutor || !bitmap.getPixels() ||
+        bitmap.width() > kMaxDeferredDim || bitmap.height() > kMaxDeferredDim) {
+        return;
+    }
+
+    fTileCountX = (bitmap.width() + fTileSize - 1) / fTileSize;
+    const int tileCountY = (bitmap.height() + fTileSize - 1) / fTileSize;
+    fTiles.resize(fTileCountX * tileCountY);
+    for (int y = 0; y < tileCountY; ++y) {
+        for (int x = 0; x < fTileCountX; ++x) {
+            SkIRect bounds = SkIRect::MakeXYWH(x * fTileSize, y * fTileSize, fTileSize, fTileSize);
+            SkAssertResult(bounds.intersect(SkIRect::MakeWH(bitmap.width(), bitmap.height())));
+            fTiles[y * fTileCountX + x].fBounds = bounds;
+        }
+    }
+}
+
+SkThreadedBitmapDevice::~SkThreadedBitmapDevice() {
+    // Our pixels may outlive us (e.g. a surface snapshot), so don't drop recorded work.
+    this->flushPendingDraws();
+}
+
+bool SkThreadedBitmapDevice::recordDraw(const SkRect* localBounds, bool tileSafe, DrawFn fn) {
+    if (!this->isDeferring()) {
+        return false;
+    }
+
+    const SkRasterClip& clip = fRCStack.rc();
+    SkIRect devBounds = clip.getBounds();
+    if (localBounds) {
+        // Outset by a pixel to cover anti-aliasing that spills past the geometric bounds.
+        SkIRect drawBounds = this->localToDevice().mapRect(*localBounds).roundOut();
+        if (!devBounds.intersect(drawBounds.makeOutset(1, 1))) {
+            return true;    // clipped out, nothing to draw
+        }
+    }
+    if (clip.isEmpty() || devBounds.isEmpty()) {
+        return true;
+    }
+
+    const int left   = devBounds.fLeft / fTileSize,
+              top    = devBounds.fTop / fTileSize,
+              right  = (devBounds.fRight - 1) / fTileSize,
+              bottom = (devBounds.fBottom - 1) / fTileSize;
+    if (!tileSafe && (left != right || top != bottom)) {
+        // Clipping this draw to each tile would chop its edges at the seams. Draw it now, after
+        // everything recorded before it, with the clip it was given.
+        this->flushPendingDraws();
+        return false;
+    }
+
+    const int index = SkToInt(fPendingDraws.size());
+    fPendingDraws.push_back({this->localToDevice44(), SkRasterClip(clip), tileSafe, std::move(fn)});
+    for (int y = top; y <= bottom; ++y) {
+        for (int x = left; x <= right; ++x) {
+            fTiles[y * fTileCountX + x].fDraws.push_back(index);
+        }
+    }
+    return true;
+}
+
+void SkThreadedBitmapDevice::drawTile(const SkBitmap& target, const Tile& tile) const {
+    if (tile.fDraws.empty()) {
+        return;
+    }
+
+    // Each tile draws through its own device (and canvas, for draws that call back into one),
+    // sharing the root pixels. Tile-safe draws are clipped to the tile; every other draw lies
+    // inside this tile alone and keeps its recorded clip untouched.
+    sk_sp<SkBitmapDevice> device(new SkBitmapDevice(target, this->surfaceProps()));
+    SkCanvas canvas(device);
+    for (int index : tile.fDraws) {
+        const PendingDraw& draw = fPendingDraws[index];
+        SkRasterClip clip(draw.fClip);
+        if (draw.fTileSafe && !clip.op(tile.fBounds, SkClipOp::kIntersect)) {
+            continue;
+        }
+        canvas.setMatrix(draw.fLocalToDevice);
+        device->fRCStack.replaceClip(clip);
+        draw.fDraw(device.get(), &canvas);
+    }
+}
+
+void SkThreadedBitmapDevice::flushPendingDraws() {
+    if (fPendingDraws.empty()) {
+        return;
+    }
+
+    SkPixmap root;
+    if (this->INHERITED::onAccessPixels(&root)) {
+        // Install the pixels in a fresh bitmap so the tiles don't contend on our pixel ref.
+        SkBitmap target;
+        target.installPixels(root);
+
+        SkTaskGroup tasks(*fExecutor);
+        tasks.batch(SkToInt(fTiles.size()), [&](int i) { this->drawTile(target, fTiles[i]); });
+        tasks.wait();
+    }
+
+    fPendingDraws.clear();
+    for (Tile& tile : fTiles) {
+        tile.fDraws.clear();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkThreadedBitmapDevice::drawPaint(const SkPaint& paint) {
+    if (!this->recordDraw(nullptr, /*tileSafe=*/true, [paint](SkBitmapDevice* device, SkCanvas*) {
+            device->drawPaint(paint);
+        })) {
+        this->INHERITED::drawPaint(paint);
+    }
+}
+
+void SkThreadedBitmapDevice::drawPoints(SkCanvas::PointMode mode, size_t count,
+                                        const SkPoint pts[], const SkPaint& paint) {
+    if (!this->isDeferring()) {
+        this->INHERITED::drawPoints(mode, count, pts, paint);
+        return;
+    }
+
+    SkRect bounds, storage;
+    const SkRect* boundsPtr = nullptr;
+    if (paint.canComputeFastBounds()) {
+        bounds.setBounds(pts, SkToInt(count));
+        boundsPtr = &paint.computeFastStrokeBounds(bounds, &storage);
+    }
+    if (!this->recordDraw(boundsPtr, /*tileSafe=*/false,
+                          [mode, points = std::vector<SkPoint>(pts, pts + count), paint](
+                                  SkBitmapDevice* device, SkCanvas*) {
+            device->drawPoints(mode, points.size(), points.data(), paint);
+        })) {
+        this->INHERITED::drawPoints(mode, count, pts, paint);
+    }
+}
+
+void SkThreadedBitmapDevice::drawRect(const SkRect& r, const SkPaint& paint) {
+    SkRect storage;
+    if (!this->recordDraw(paint_bounds(r, paint, &storage),
+                          is_tile_safe_fill(this->localToDevice(), paint),
+                          [r, paint](SkBitmapDevice* device, SkCanvas*) {
+            device->drawRect(r, paint);
+        })) {
+        this->INHERITED::drawRect(r, paint);
+    }
+}
+
+void SkThreadedBitmapDevice::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
+    SkRect storage;
+    if (!this->recordDraw(paint_bounds(rrect.getBounds(), paint, &storage), /*tileSafe=*/false,
+                          [rrect, paint](SkBitmapDevice* device, SkCanvas*) {
+            device->drawRRect(rrect, paint);
+        })) {
+        this->INHERITED::drawRRect(rrect, paint);
+    }
+}
+
+void SkThreadedBitmapDevice::drawPath(const SkPath& path, const SkPaint& paint,
+                                      bool pathIsMutable) {
+    SkRect storage;
+    const SkRect* bounds = path.isInverseFillType()
+                                   ? nullptr
+                                   : paint_bounds(path.getBounds(), paint, &storage);
+    // Every tile replays the same path concurrently, so none of them may modify it.
+    if (!this->recordDraw(bounds, /*tileSafe=*/false,
+                          [path, paint](SkBitmapDevice* device, SkCanvas*) {
+            device->drawPath(path, paint, false);
+        })) {
+        this->INHERITED::drawPath(path, paint, pathIsMutable);
+    }
+}
+
+void SkThreadedBitmapDevice::drawImageRect(const SkImage* image, const SkRect* src,
+                                           const SkRect& dst, const SkSamplingOptions& sampling,
+                                           const SkPaint& paint,
+                                           SkCanvas::SrcRectConstraint constraint) {
+    SkRect storage;
+    const bool hasSrc = src != nullptr;
+    const SkRect srcRect = hasSrc ? *src : SkRect::MakeEmpty();
+    if (!this->recordDraw(paint_bounds(dst, paint, &storage),
+                          is_tile_safe_fill(this->localToDevice(), paint),
+                          [img = sk_ref_sp(image), hasSrc, srcRect, dst, sampling, paint,
+                           constraint](SkBitmapDevice* device, SkCanvas*) {
+            device->drawImageRect(img.get(), hasSrc ? &srcRect : nullptr, dst, sampling, paint,
+                                  constraint);
+        })) {
+        this->INHERITED::drawImageRect(image, src, dst, sampling, paint, constraint);
+    }
+}
+
+void SkThreadedBitmapDevice::drawVertices(const SkVertices* vertices, sk_sp<SkBlender> blender,
+                                          const SkPaint& paint, bool skipColorXform) {
+    SkRect storage;
+    if (!this->recordDraw(paint_bounds(vertices->bounds(), paint, &storage), /*tileSafe=*/false,
+                          [verts = sk_ref_sp(vertices), blender, paint, skipColorXform](
+                                  SkBitmapDevice* device, SkCanvas*) {
+            device->drawVertices(verts.get(), blender, paint, skipColorXform);
+        })) {
+        this->INHERITED::drawVertices(vertices, std::move(blender), paint, skipColorXform);
+    }
+}
+
+void SkThreadedBitmapDevice::drawAtlas(const SkRSXform xform[], const SkRect tex[],
+                                       const SkColor colors[], int count,
+                                       sk_sp<SkBlender> blender, const SkPaint& paint) {
+    if (!this->isDeferring()) {
+        this->INHERITED::drawAtlas(xform, tex, colors, count, std::move(blender), paint);
+        return;
+    }
+
+    std::vector<SkRSXform> xforms(xform, xform + count);
+    std::vector<SkRect> texs(tex, tex + count);
+    std::vector<SkColor> cols;
+    if (colors) {
+        cols.assign(colors, colors + count);
+    }
+    if (!this->recordDraw(nullptr, /*tileSafe=*/false,
+                          [xforms, texs, cols, count, blender, paint](SkBitmapDevice* device,
+                                                                      SkCanvas*) {
+            device->drawAtlas(xforms.data(), texs.data(), cols.empty() ? nullptr : cols.data(),
+                              count, blender, paint);
+        })) {
+        this->INHERITED::drawAtlas(xform, tex, colors, count, std::move(blender), paint);
+    }
+}
+
+void SkThreadedBitmapDevice::onDrawGlyphRunList(SkCanvas* canvas,
+                                                const sktext::GlyphRunList& glyphRunList,
+                                                const SkPaint& initialPaint,
+                                                const SkPaint& drawingPaint) {
+    SkASSERT(!glyphRunList.hasRSXForm());
+    if (!this->isDeferring()) {
+        this->INHERITED::onDrawGlyphRunList(canvas, glyphRunList, initialPaint, drawingPaint);
+        return;
+    }
+
+    // The glyph run list points into transient storage; hold on to it as a blob instead.
+    sk_sp<SkTextBlob> blob = glyphRunList.blob() ? sk_ref_sp(glyphRunList.blob())
+                                                 : glyphRunList.makeBlob();
+    if (!blob) {
+        return;     // no glyphs
+    }
+    SkRect storage;
+    if (!this->recordDraw(paint_bounds(glyphRunList.sourceBoundsWithOrigin(), drawingPaint,
+                                       &storage),
+                          /*tileSafe=*/false,
+                          [blob, origin = glyphRunList.origin(), drawingPaint](
+                                  SkBitmapDevice* device, SkCanvas* tileCanvas) {
+            sktext::GlyphRunBuilder builder;
+            const sktext::GlyphRunList& list = builder.blobToGlyphRunList(*blob, origin);
+            device->onDrawGlyphRunList(tileCanvas, list, drawingPaint, drawingPaint);
+        })) {
+        this->INHERITED::onDrawGlyphRunList(canvas, glyphRunList, initialPaint, drawingPaint);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkThreadedBitmapDevice::drawDevice(SkBaseDevice* device, const SkSamplingOptions& sampling,
+                                        const SkPaint& paint) {
+    this->flushPendingDraws();
+    this->INHERITED::drawDevice(device, sampling, paint);
+}
+
+void SkThreadedBitmapDevice::drawSpecial(SkSpecialImage* src, const SkMatrix& localToDevice,
+                                         const SkSamplingOptions& sampling, const SkPaint& paint) {
+    this->flushPendingDraws();
+    this->INHERITED::drawSpecial(src, localToDevice, sampling, paint);
+}
+
+sk_sp<SkSpecialImage> SkThreadedBitmapDevice::snapSpecial(const SkIRect& bounds, bool forceCopy) {
+    this->flushPendingDraws();
+    return this->INHERITED::snapSpecial(bounds, forceCopy);
+}
+
+bool SkThreadedBitmapDevice::onReadPixels(const SkPixmap& pm, int x, int y) {
+    this->flushPendingDraws();
+    return this->INHERITED::onReadPixels(pm, x, y);
+}
+
+bool SkThreadedBitmapDevice::onWritePixels(const SkPixmap& pm, int x, int y) {
+    this->flushPendingDraws();
+    return this->INHERITED::onWritePixels(pm, x, y);
+}
+
+bool SkThreadedBitmapDevice::onPeekPixels(SkPixmap* pmap) {
+    this->flushPendingDraws();
+    return this->INHERITED::onPeekPixels(pmap);
+}
+
+bool SkThreadedBitmapDevice::onAccessPixels(SkPixmap* pmap) {
+    this->flushPendingDraws();
+    return this->INHERITED::onAccessPixels(pmap);
+}
+
+void SkThreadedBitmapDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
+    this->flushPendingDraws();
+    this->INHERITED::replaceBitmapBackendForRasterSurface(bm);
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkThreadedBitmapDevice_DEFINED
+#define SkThreadedBitmapDevice_DEFINED
+
+#include "include/core/SkM44.h"
+#include "include/core/SkRect.h"
+#include "src/core/SkBitmapDevice.h"
+#include "src/core/SkRasterClip.h"
+
+#include <functional>
+#include <vector>
+
+class SkExecutor;
+
+/**
+ *  A raster device that records draws instead of executing them immediately. Each recorded draw
+ *  captures the current matrix and clip and is binned into the fixed-size tiles its device bounds
+ *  touch. When the pixels are needed (read, snapped, written, or drawn from) the pending draws are
+ *  played back tile by tile, with the tiles rasterized concurrently on an SkExecutor.
+ *
+ *  Every tile replays its draws with the original matrix into the same root pixels. Scan converting
+ *  edges depends on the clip bounds, so only axis-aligned fills (which are clipped a pixel at a
+ *  time) have their clip intersected with each tile. Any other draw is deferred only if it lies
+ *  within a single tile, where it keeps its original clip; otherwise the pending work is flushed
+ *  and it draws on the calling thread. Either way the result is identical to drawing serially.
+ *
+ *  Draws that read back the destination (layers, special images) flush the pending work and then
+ *  run on the calling thread.
+ */
+class SkThreadedBitmapDevice final : public SkBitmapDevice {
+public:
+    static constexpr int kDefaultTileSize = 256;
+
+    SkThreadedBitmapDevice(const SkBitmap& bitmap, const SkSurfaceProps& surfaceProps,
+                           SkExecutor* executor, int tileSize = kDefaultTileSize);
+    ~SkThreadedBitmapDevice() override;
+
+    // Rasterizes all pending draws; returns once the root pixels are up to date.
+    void flushPendingDraws();
+
+    int pendingDrawCount() const { return SkToInt(fPendingDraws.size()); }
+
+protected:
+    void drawPaint(const SkPaint& paint) override;
+    void drawPoints(SkCanvas::PointMode mode, size_t count,
+                    const SkPoint[], const SkPaint& paint) override;
+    void drawRect(const SkRect& r, const SkPaint& paint) override;
+    void drawRRect(const SkRRect& rr, const SkPaint& paint) override;
+    void drawPath(const SkPath&, const SkPaint&, bool pathIsMutable) override;
+    void drawImageRect(const SkImage*, const SkRect* src, const SkRect& dst,
+                       const SkSamplingOptions&, const SkPaint&,
+                       SkCanvas::SrcRectConstraint) override;
+    void drawVertices(const SkVertices*, sk_sp<SkBlender>, const SkPaint&, bool) override;
+    void drawAtlas(const SkRSXform[], const SkRect[], const SkColor[], int count, sk_sp<SkBlender>,
+                   const SkPaint&) override;
+    void onDrawGlyphRunList(SkCanvas*,
+                            const sktext::GlyphRunList&,
+                            const SkPaint& initialPaint,
+                            const SkPaint& drawingPaint) override;
+
+    void drawDevice(SkBaseDevice*, const SkSamplingOptions&, const SkPaint&) override;
+    void drawSpecial(SkSpecialImage*, const SkMatrix&, const SkSamplingOptions&,
+                     const SkPaint&) override;
+    sk_sp<SkSpecialImage> snapSpecial(const SkIRect&, bool forceCopy = false) override;
+
+    bool onReadPixels(const SkPixmap&, int x, int y) override;
+    bool onWritePixels(const SkPixmap&, int, int) override;
+    bool onPeekPixels(SkPixmap*) override;
+    bool onAccessPixels(SkPixmap*) override;
+
+private:
+    // Replays one recorded draw on a per-tile device. The canvas wraps that device and carries the
+    // recorded matrix; it is only needed by draws (text) that may call back into a canvas.
+    using DrawFn = std::function<void(SkBitmapDevice*, SkCanvas*)>;
+
+    struct PendingDraw {
+        SkM44        fLocalToDevice;
+        SkRasterClip fClip;
+        bool         fTileSafe;     // may be clipped to each tile it touches
+        DrawFn       fDraw;
+    };
+
+    struct Tile {
+        SkIRect          fBounds;
+        std::vector<int> fDraws;   // indices into fPendingDraws, in submission order
+    };
+
+    bool isDeferring() const { return !fTiles.empty(); }
+
+    // Records fn if this device is deferring; returns false if the caller must draw immediately.
+    // localBounds, when non-null, is the conservative local-space extent of the draw. Unless
+    // tileSafe, a draw that spans more than one tile flushes the pending work and returns false.
+    bool recordDraw(const SkRect* localBounds, bool tileSafe, DrawFn fn);
+
+    void drawTile(const SkBitmap& target, const Tile& tile) const;
+
+    void replaceBitmapBackendForRasterSurface(const SkBitmap&) override;
+
+    SkExecutor* getImageFilterExecutor() override { return fExecutor; }
+
+    SkExecutor*              fExecutor;
+    int                      fTileSize;
+    int                      fTileCountX = 0;
+    std::vector<Tile>        fTiles;
+    std::vector<PendingDraw> fPendingDraws;
+
+    using INHERITED = SkBitmapDevice;
+};
+
+#endif // SkThreadedBitmapDevice_DEFINED
@@ -625,6 +625,12 @@ namespace skvm {
         std::vector<Instruction> program() const { return fProgram; }
         std::vector<OptimizedInstruction> optimize(viz::Visualizer* visualizer = nullptr) const;
 
+        // Everything besides the optimized instructions that done() passes to Program,
+        // for callers that keep those instructions around to build the Program again later.
+        Features                       features()   const { return fFeatures;   }
+        const std::vector<int>&        strides()    const { return fStrides;    }
+        const std::vector<TraceHook*>& traceHooks() const { return fTraceHooks; }
+
         // Returns a trace-hook ID which must be passed to the trace opcodes.
         int attachTraceHook(TraceHook*);
 
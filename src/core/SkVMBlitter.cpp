@@ -5,7 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkStream.h"
 #include "include/private/SkMacros.h"
+#include "include/private/base/SkMutex.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkBlendModePriv.h"
 #include "src/core/SkBlenderBase.h"
@@ -21,7 +23,9 @@
 #include "src/core/SkVM.h"
 #include "src/core/SkVMBlitter.h"
 #include "src/shaders/SkColorFilterShader.h"
+#include "src/utils/SkVMVisualizer.h"
 
+#include <atomic>
 #include <cinttypes>
 
 #define SK_BLITTER_TRACE_IS_SKVM
@@ -538,30 +542,44 @@ SkVMBlitter::SkVMBlitter(const SkPixmap& device,
         , fParams(EffectiveParams(device, sprite, paint, matrices, std::move(clip)))
         , fKey(CacheKey(fParams, &fUniforms, &fAlloc, ok)) {}
 
-SkVMBlitter::~SkVMBlitter() {
-    if (fStoreToCache) {
-        if (SkLRUCache<Key, skvm::Program>* cache = TryAcquireProgramCache()) {
-            auto cache_program = [&](SkTLazy<skvm::Program>& program, Coverage coverage) {
-                if (program.isValid() && !program->hasTraceHooks()) {
-                    cache->insert_or_update(fKey.withCoverage(coverage), std::move(*program));
-                }
-            };
-            for (int c = 0; c < Coverage::kCount; c++) {
-                cache_program(fPrograms[c], static_cast<Coverage>(c));
-            }
+SkVMBlitter::~SkVMBlitter() = default;
+
+SkVMBlitter::CachedProgram::CachedProgram(const Key& key,
+                                          std::vector<skvm::OptimizedInstruction> instructions,
+                                          std::vector<int> strides,
+                                          std::vector<skvm::TraceHook*> traceHooks,
+                                          bool loaded)
+        : fKey(key)
+        , fInstructions(std::move(instructions))
+        , fStrides(std::move(strides))
+        , fTraceHooks(std::move(traceHooks))
+        , fLoaded(loaded) {}
+
+skvm::Program* SkVMBlitter::CachedProgram::program() {
+    fOnce([this] {
+        fProgram = skvm::Program(fInstructions, /*visualizer=*/nullptr, fStrides, fTraceHooks,
+                                 DebugName(fKey).c_str(), /*allow_jit=*/true);
+    });
+    return &fProgram;
+}
 
-            ReleaseProgramCache();
-        }
-    }
+static SkMutex& program_cache_mutex() {
+    static SkMutex& mutex = *(new SkMutex);
+    return mutex;
 }
 
-SkLRUCache<SkVMBlitter::Key, skvm::Program>* SkVMBlitter::TryAcquireProgramCache() {
+static std::atomic<int> gProgramCacheHits{0},
+                        gProgramCacheMisses{0};
+
+SkLRUCache<SkVMBlitter::Key, sk_sp<SkVMBlitter::CachedProgram>>*
+SkVMBlitter::TryAcquireProgramCache() {
 #if defined(SKVM_JIT)
-    thread_local static SkLRUCache<Key, skvm::Program> cache{64};
-    return &cache;
+    // One cache shared by every thread, so it's a few times larger than the old per-thread ones.
+    static auto* cache = new SkLRUCache<Key, sk_sp<CachedProgram>>{256};
+    program_cache_mutex().acquire();
+    return cache;
 #else
-    // iOS now supports thread_local since iOS 9.
-    // On the other hand, we'll never be able to JIT there anyway.
+    // We'll never be able to JIT here anyway.
     // It's probably fine to not cache any interpreted programs, anywhere.
     return nullptr;
 #endif
@@ -579,7 +597,158 @@ SkString SkVMBlitter::DebugName(const Key& key) {
                           key.coverage);
 }
 
-void SkVMBlitter::ReleaseProgramCache() {}
+void SkVMBlitter::ReleaseProgramCache() {
+    program_cache_mutex().release();
+}
+
+// Saved program caches start with this header. Keys hash programs with SkOpts::hash(), and the
+// optimized instructions depend on the CPU features skvm::Builder detected, so both are recorded
+// along with the layout of the key and instructions to catch caches from another build or CPU.
+static constexpr uint32_t kProgramCacheMagic   = SkSetFourByteTag('s','k','v','m'),
+                          kProgramCacheVersion = 1;
+
+static constexpr int kOpCount = 0
+#define M(op) + 1
+    SKVM_OPS(M)
+#undef M
+    ;
+
+static uint32_t program_cache_fingerprint() {
+    const skvm::Features features = skvm::Builder{}.features();
+    const char seed[] = "SkVMBlitter program cache";
+    return SkOpts::hash(seed, sizeof(seed))
+         ^ (features.fma  ? 1 : 0)
+         ^ (features.fp16 ? 2 : 0);
+}
+
+bool SkVMBlitter::SaveProgramCache(SkWStream* stream) {
+    // Snapshot the cache so we don't hold the lock while writing.
+    std::vector<sk_sp<CachedProgram>> programs;
+    if (auto* cache = TryAcquireProgramCache()) {
+        cache->foreach([&](const Key*, sk_sp<CachedProgram>* program) {
+            if (!(*program)->hasTraceHooks()) {
+                programs.push_back(*program);
+            }
+        });
+        ReleaseProgramCache();
+    }
+
+    bool ok = stream->write32(kProgramCacheMagic)
+           && stream->write32(kProgramCacheVersion)
+           && stream->write32(program_cache_fingerprint())
+           && stream->write32(kOpCount)
+           && stream->write32(sizeof(Key))
+           && stream->write32(sizeof(skvm::OptimizedInstruction))
+           && stream->write32(SkToU32(programs.size()));
+    for (const sk_sp<CachedProgram>& program : programs) {
+        ok = ok && stream->write(&program->key(), sizeof(Key))
+                && stream->write32(SkToU32(program->strides().size()))
+                && stream->write(program->strides().data(),
+                                 program->strides().size() * sizeof(int))
+                && stream->write32(SkToU32(program->instructions().size()));
+        for (const skvm::OptimizedInstruction& inst : program->instructions()) {
+            const int32_t fields[] = {
+                (int32_t)inst.op, inst.x, inst.y, inst.z, inst.w,
+                inst.immA, inst.immB, inst.immC, inst.death, inst.can_hoist,
+            };
+            ok = ok && stream->write(fields, sizeof(fields));
+        }
+    }
+    return ok;
+}
+
+bool SkVMBlitter::LoadProgramCache(SkStream* stream) {
+    uint32_t magic, version, fingerprint, opCount, keySize, instSize, count;
+    if (!stream->readU32(&magic)       || magic       != kProgramCacheMagic          ||
+        !stream->readU32(&version)     || version     != kProgramCacheVersion        ||
+        !stream->readU32(&fingerprint) || fingerprint != program_cache_fingerprint() ||
+        !stream->readU32(&opCount)     || opCount     != kOpCount                    ||
+        !stream->readU32(&keySize)     || keySize     != sizeof(Key)                 ||
+        !stream->readU32(&instSize)    || instSize    != sizeof(skvm::OptimizedInstruction) ||
+        !stream->readU32(&count)) {
+        return false;
+    }
+
+    // Read and sanity check everything before touching the cache, so bad data adds nothing.
+    // This only guards against truncated or mismatched caches; saved caches are trusted input.
+    static constexpr uint32_t kMaxArgs         = 64,
+                              kMaxInstructions = 1 << 20;
+    std::vector<sk_sp<CachedProgram>> programs;
+    for (uint32_t i = 0; i < count; i++) {
+        Key key;
+        uint32_t nargs, ninsts;
+        if (stream->read(&key, sizeof(Key)) != sizeof(Key) ||
+            !stream->readU32(&nargs) || nargs > kMaxArgs) {
+            return false;
+        }
+        std::vector<int> strides(nargs);
+        if (stream->read(strides.data(), nargs * sizeof(int)) != nargs * sizeof(int) ||
+            !stream->readU32(&ninsts) || ninsts == 0 || ninsts > kMaxInstructions) {
+            return false;
+        }
+
+        std::vector<skvm::OptimizedInstruction> instructions(ninsts);
+        for (skvm::Val id = 0; id < (skvm::Val)ninsts; id++) {
+            int32_t f[10];
+            if (stream->read(f, sizeof(f)) != sizeof(f)) {
+                return false;
+            }
+            skvm::OptimizedInstruction& inst = instructions[id];
+            inst = {(skvm::Op)f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7], f[8], f[9] != 0};
+
+            if (f[0] < 0 || f[0] >= kOpCount ||
+                inst.death < id || inst.death > (skvm::Val)ninsts) {
+                return false;
+            }
+            for (skvm::Val arg : {inst.x, inst.y, inst.z, inst.w}) {
+                if (arg != skvm::NA && (arg < 0 || arg >= id)) {
+                    return false;
+                }
+            }
+        }
+        programs.push_back(sk_make_sp<CachedProgram>(key,
+                                                     std::move(instructions),
+                                                     std::move(strides),
+                                                     std::vector<skvm::TraceHook*>{},
+                                                     /*loaded=*/true));
+    }
+
+    if (auto* cache = TryAcquireProgramCache()) {
+        for (sk_sp<CachedProgram>& program : programs) {
+            // Programs already built in this process win over loaded ones.
+            if (!cache->find(program->key())) {
+                cache->insert(program->key(), std::move(program));
+            }
+        }
+        ReleaseProgramCache();
+    }
+    return true;
+}
+
+SkVMBlitter::ProgramCacheStats SkVMBlitter::GetProgramCacheStats() {
+    ProgramCacheStats stats = {gProgramCacheHits.load(), gProgramCacheMisses.load(), 0};
+    if (auto* cache = TryAcquireProgramCache()) {
+        stats.count = cache->count();
+        ReleaseProgramCache();
+    }
+    return stats;
+}
+
+void SkVMBlitter::ResetProgramCacheStats() {
+    gProgramCacheHits   = 0;
+    gProgramCacheMisses = 0;
+}
+
+void SkVMBlitter::PurgeProgramCache() {
+    if (auto* cache = TryAcquireProgramCache()) {
+        cache->reset();
+        ReleaseProgramCache();
+    }
+}
+
+bool SkVMBlitter::usedLoadedProgramForTesting() const {
+    return fPrograms[Coverage::Full] && fPrograms[Coverage::Full]->loaded();
+}
 
 skvm::Program* SkVMBlitter::buildProgram(Coverage coverage) {
     // eg, blitter re-use...
@@ -589,21 +758,24 @@ skvm::Program* SkVMBlitter::buildProgram(Coverage coverage) {
 
     // Next, cache lookup...
     Key key = fKey.withCoverage(coverage);
-    {
-        skvm::Program* p = nullptr;
-        if (SkLRUCache<Key, skvm::Program>* cache = TryAcquireProgramCache()) {
-            p = cache->find(key);
-            ReleaseProgramCache();
-        }
-        if (p) {
-            SkASSERT(!p->empty());
-            fProgramPtrs[coverage] = p;
-            return p;
+    auto* cache = TryAcquireProgramCache();
+    if (cache) {
+        sk_sp<CachedProgram>* found = cache->find(key);
+        if (found) {
+            fPrograms[coverage] = *found;
         }
+        ReleaseProgramCache();
+    }
+    if (fPrograms[coverage]) {
+        gProgramCacheHits++;
+        // Compiling a program loaded from a saved cache happens here, outside the cache lock.
+        fProgramPtrs[coverage] = fPrograms[coverage]->program();
+        SkASSERT(!fProgramPtrs[coverage]->empty());
+        return fProgramPtrs[coverage];
     }
+    gProgramCacheMisses++;
 
     // Okay, let's build it...
-    fStoreToCache = true;
 
     // We don't really _need_ to rebuild fUniforms here.
     // It's just more natural to have effects unconditionally emit them,
@@ -616,14 +788,18 @@ skvm::Program* SkVMBlitter::buildProgram(Coverage coverage) {
     SkASSERTF(fUniforms.buf.size() == prev,
               "%zu, prev was %zu", fUniforms.buf.size(), prev);
 
-    skvm::Program program = builder.done(DebugName(key).c_str());
+    fPrograms[coverage] = sk_make_sp<CachedProgram>(key,
+                                                    builder.optimize(),
+                                                    builder.strides(),
+                                                    builder.traceHooks());
+    skvm::Program* program = fPrograms[coverage]->program();
     if ((false)) {
         static std::atomic<int> missed{0},
                                 total{0};
-        if (!program.hasJIT()) {
+        if (!program->hasJIT()) {
             SkDebugf("\ncouldn't JIT %s\n", DebugName(key).c_str());
             builder.dump();
-            program.dump();
+            program->dump();
 
             missed++;
         }
@@ -632,8 +808,15 @@ skvm::Program* SkVMBlitter::buildProgram(Coverage coverage) {
                                 total.load(), missed.load()); });
         }
     }
-    fProgramPtrs[coverage] = fPrograms[coverage].set(std::move(program));
-    return fProgramPtrs[coverage];
+
+    // Share the program with every other blitter right away, unless it's instrumented for
+    // debugging; those trace hooks belong to this draw alone.
+    if (!program->hasTraceHooks() && (cache = TryAcquireProgramCache())) {
+        cache->insert_or_update(key, fPrograms[coverage]);
+        ReleaseProgramCache();
+    }
+    fProgramPtrs[coverage] = program;
+    return program;
 }
 
 void SkVMBlitter::updateUniforms(int right, int y) {
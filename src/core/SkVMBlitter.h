@@ -9,12 +9,18 @@
 #define SkVMBlitter_DEFINED
 
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRefCnt.h"
+#include "include/private/base/SkOnce.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkBlitter.h"
 #include "src/core/SkLRUCache.h"
-#include "src/core/SkTLazy.h"
 #include "src/core/SkVM.h"
 
+#include <vector>
+
+class SkStream;
+class SkWStream;
+
 class SkVMBlitter final : public SkBlitter {
 public:
     static SkVMBlitter* Make(const SkPixmap& dst,
@@ -40,6 +46,31 @@ public:
 
     ~SkVMBlitter() override;
 
+    // Programs are shared by every SkVMBlitter in the process, keyed by what they draw. The cache
+    // keeps each program's optimized instructions too, so it can be written out with
+    // SaveProgramCache() (e.g. to an SkFILEWStream) and read back by a later process with
+    // LoadProgramCache(). Loaded programs skip building and optimizing entirely; they are only
+    // JIT-compiled from the stored instructions the first time a blitter asks for them.
+    //
+    // Saved caches are only valid for the same build of Skia on the same kind of CPU.
+    // LoadProgramCache() returns false, and adds nothing, if the data doesn't match.
+    static bool SaveProgramCache(SkWStream*);
+    static bool LoadProgramCache(SkStream*);
+
+    struct ProgramCacheStats {
+        int hits;     // Programs found in the cache, including those loaded from a saved cache.
+        int misses;   // Programs that had to be built from scratch.
+        int count;    // Programs currently in the cache.
+    };
+    static ProgramCacheStats GetProgramCacheStats();
+    static void ResetProgramCacheStats();
+
+    // Drops every program from the shared cache. Blitters already using one keep it.
+    static void PurgeProgramCache();
+
+    // True if this blitter has drawn with full coverage using a program from LoadProgramCache().
+    bool usedLoadedProgramForTesting() const;
+
 private:
     enum Coverage { Full, UniformF, MaskA8, MaskLCD16, Mask3D, kCount };
     struct Key {
@@ -60,6 +91,36 @@ private:
         Key withCoverage(Coverage c) const;
     };
 
+    // A program along with the optimized instructions it was built from.
+    class CachedProgram : public SkNVRefCnt<CachedProgram> {
+    public:
+        CachedProgram(const Key& key,
+                      std::vector<skvm::OptimizedInstruction> instructions,
+                      std::vector<int> strides,
+                      std::vector<skvm::TraceHook*> traceHooks,
+                      bool loaded = false);
+
+        // Builds the program the first time it's called. Thread-safe.
+        skvm::Program* program();
+
+        const Key& key() const { return fKey; }
+        const std::vector<skvm::OptimizedInstruction>& instructions() const {
+            return fInstructions;
+        }
+        const std::vector<int>& strides() const { return fStrides; }
+        bool hasTraceHooks() const { return !fTraceHooks.empty(); }
+        bool loaded() const { return fLoaded; }   // read from a saved cache
+
+    private:
+        const Key                                     fKey;
+        const std::vector<skvm::OptimizedInstruction> fInstructions;
+        const std::vector<int>                        fStrides;
+        const std::vector<skvm::TraceHook*>           fTraceHooks;
+        const bool                                    fLoaded;
+        SkOnce                                        fOnce;
+        skvm::Program                                 fProgram;
+    };
+
     struct Params {
         sk_sp<SkShader>         shader;
         sk_sp<SkShader>         clip;
@@ -82,7 +143,9 @@ private:
                              skvm::Uniforms* uniforms, SkArenaAlloc* alloc);
     static Key CacheKey(const Params& params,
                         skvm::Uniforms* uniforms, SkArenaAlloc* alloc, bool* ok);
-    static SkLRUCache<Key, skvm::Program>* TryAcquireProgramCache();
+    // Returns the process-wide program cache, locked, or null if programs aren't cached.
+    // A non-null cache must be unlocked with ReleaseProgramCache().
+    static SkLRUCache<Key, sk_sp<CachedProgram>>* TryAcquireProgramCache();
     static SkString DebugName(const Key& key);
     static void ReleaseProgramCache();
 
@@ -103,9 +166,8 @@ private:
     SkArenaAlloc    fAlloc{2*sizeof(void*)};  // but a few effects need to ref large content.
     const Params    fParams;
     const Key       fKey;
-    bool            fStoreToCache = false;
-    skvm::Program*         fProgramPtrs[Coverage::kCount] = {nullptr};
-    SkTLazy<skvm::Program> fPrograms[Coverage::kCount];
+    skvm::Program*       fProgramPtrs[Coverage::kCount] = {nullptr};
+    sk_sp<CachedProgram> fPrograms[Coverage::kCount];   // Keeps fProgramPtrs alive past eviction.
 
     friend class Viewer;
 };
@@ -70,6 +70,8 @@ protected:
     sk_sp<SkSpecialImage> onFilterImage(const Context&, SkIPoint* offset) const override;
     SkIRect onFilterNodeBounds(const SkIRect& src, const SkMatrix& ctm,
                                MapDirection, const SkIRect* inputRect) const override;
+    // The CPU blur treats everything outside its input as transparent, whatever fTileMode is.
+    bool onCanFilterInTiles() const override { return true; }
 
 private:
     friend void ::SkRegisterBlurImageFilterFlattenable();
@@ -43,6 +43,7 @@ protected:
     bool onIsColorFilterNode(SkColorFilter**) const override;
     MatrixCapability onGetCTMCapability() const override { return MatrixCapability::kComplex; }
     bool onAffectsTransparentBlack() const override;
+    bool onCanFilterInTiles() const override { return true; }
 
 private:
     friend void ::SkRegisterColorFilterImageFilterFlattenable();
@@ -87,6 +87,9 @@ protected:
 
     void flatten(SkWriteBuffer&) const override;
 
+    // Displaced reads are bounds checked against the color input, which covers the tile's margin.
+    bool onCanFilterInTiles() const override { return true; }
+
 private:
     friend void ::SkRegisterDisplacementMapImageFilterFlattenable();
     SK_FLATTENABLE_HOOKS(SkDisplacementMapImageFilter)
@@ -276,8 +279,9 @@ sk_sp<SkSpecialImage> SkDisplacementMapImageFilter::onFilterImage(const Context&
     // With a more complex DAG attached to this input, it's not clear that working in ANY specific
     // color space makes sense, so we ignore color spaces (and gamma) entirely. This may not be
     // ideal, but it's at least consistent and predictable.
-    Context displContext(ctx.mapping(), ctx.desiredOutput(), ctx.cache(),
-                         kN32_SkColorType, nullptr, ctx.source());
+    Context displContext = Context(ctx.mapping(), ctx.desiredOutput(), ctx.cache(),
+                                   kN32_SkColorType, nullptr, ctx.source())
+                                   .withExecutor(ctx.executor());
     sk_sp<SkSpecialImage> displ(this->filterInput(0, displContext, &displOffset));
     if (!displ) {
         return nullptr;
@@ -34,6 +34,7 @@ public:
 protected:
     sk_sp<SkSpecialImage> onFilterImage(const Context&, SkIPoint* offset) const override;
     MatrixCapability onGetCTMCapability() const override { return MatrixCapability::kComplex; }
+    bool onCanFilterInTiles() const override { return true; }
 
 private:
     friend void ::SkRegisterMergeImageFilterFlattenable();
@@ -100,6 +100,7 @@ public:
 protected:
     sk_sp<SkSpecialImage> onFilterImage(const Context&, SkIPoint* offset) const override;
     void flatten(SkWriteBuffer&) const override;
+    bool onCanFilterInTiles() const override { return true; }
 
     SkSize mappedRadius(const SkMatrix& ctm) const {
       SkVector radiusVector = SkVector::Make(fRadius.width(), fRadius.height());
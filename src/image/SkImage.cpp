@@ -8,6 +8,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkData.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageGenerator.h"
@@ -650,6 +651,16 @@ bool SkImage::isLazyGenerated() const {
     return as_IB(this)->onIsLazyGenerated();
 }
 
+void SkImage::decodeAhead(SkExecutor* executor) const {
+    if (!this->isLazyGenerated()) {
+        return;
+    }
+    (executor ? *executor : SkExecutor::GetDefault()).add([image = sk_ref_sp(this)] {
+        SkBitmap bitmap;
+        as_IB(image)->getROPixels(nullptr, &bitmap, kAllow_CachingHint);
+    });
+}
+
 bool SkImage::isAlphaOnly() const { return SkColorTypeIsAlphaOnly(fInfo.colorType()); }
 
 sk_sp<SkImage> SkImage::makeColorSpace(sk_sp<SkColorSpace> target, GrDirectContext* direct) const {
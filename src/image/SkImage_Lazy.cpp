@@ -155,12 +155,26 @@ bool SkImage_Lazy::getROPixels(GrDirectContext* ctx, SkBitmap* bitmap,
         }
         bool success = false;
         {   // make sure ScopedGenerator goes out of scope before we try readPixelsProxy
-            success = ScopedGenerator(fSharedGenerator)->getPixels(pmap);
+            ScopedGenerator generator(fSharedGenerator);
+            // Another thread, e.g. one running decodeAhead(), may have cached the pixels while
+            // we waited for the generator.
+            if (SkBitmapCache::Find(desc, bitmap)) {
+                check_output_bitmap();
+                return true;
+            }
+            success = generator->getPixels(pmap);
+            // Publish the pixels while still holding the generator, so that a thread waiting on
+            // it finds them in the cache instead of decoding again.
+            if (success) {
+                SkBitmapCache::Add(std::move(cacheRec), bitmap);
+            }
         }
-        if (!success && !this->readPixelsProxy(ctx, pmap)) {
-            return false;
+        if (!success) {
+            if (!this->readPixelsProxy(ctx, pmap)) {
+                return false;
+            }
+            SkBitmapCache::Add(std::move(cacheRec), bitmap);
         }
-        SkBitmapCache::Add(std::move(cacheRec), bitmap);
         this->notifyAddedToRasterCache();
     } else {
         if (!bitmap->tryAllocPixels(this->imageInfo())) {
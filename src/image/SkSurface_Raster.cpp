@@ -11,6 +11,7 @@
 #include "src/core/SkDevice.h"
 #include "src/core/SkImageInfoPriv.h"
 #include "src/core/SkImagePriv.h"
+#include "src/core/SkThreadedBitmapDevice.h"
 #include "src/image/SkSurface_Base.h"
 
 class SkSurface_Raster : public SkSurface_Base {
@@ -18,7 +19,8 @@ public:
     SkSurface_Raster(const SkImageInfo&, void*, size_t rb,
                      void (*releaseProc)(void* pixels, void* context), void* context,
                      const SkSurfaceProps*);
-    SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef>, const SkSurfaceProps*);
+    SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef>, const SkSurfaceProps*,
+                     SkExecutor* executor = nullptr);
 
     SkImageInfo imageInfo() const override { return fBitmap.info(); }
 
@@ -32,8 +34,18 @@ public:
     sk_sp<const SkCapabilities> onCapabilities() override;
 
 private:
+    // Rasterizes any draws the threaded device is still holding on to.
+    void flushPendingDraws() {
+        if (fThreadedDevice) {
+            fThreadedDevice->flushPendingDraws();
+        }
+    }
+
     SkBitmap    fBitmap;
     bool        fWeOwnThePixels;
+    // When set, our canvas records draws and rasterizes them in tiles on this executor.
+    SkExecutor* fExecutor = nullptr;
+    sk_sp<SkThreadedBitmapDevice> fThreadedDevice;
 
     using INHERITED = SkSurface_Base;
 };
@@ -72,26 +84,38 @@ SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, void* pixels, size_t
 }
 
 SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef> pr,
-                                   const SkSurfaceProps* props)
+                                   const SkSurfaceProps* props, SkExecutor* executor)
     : INHERITED(pr->width(), pr->height(), props)
+    , fExecutor(executor)
 {
     fBitmap.setInfo(info, pr->rowBytes());
     fBitmap.setPixelRef(std::move(pr), 0, 0);
     fWeOwnThePixels = true;
 }
 
-SkCanvas* SkSurface_Raster::onNewCanvas() { return new SkCanvas(fBitmap, this->props()); }
+SkCanvas* SkSurface_Raster::onNewCanvas() {
+    if (fExecutor) {
+        fThreadedDevice = sk_make_sp<SkThreadedBitmapDevice>(fBitmap, this->props(), fExecutor);
+        return new SkCanvas(fThreadedDevice);
+    }
+    return new SkCanvas(fBitmap, this->props());
+}
 
 sk_sp<SkSurface> SkSurface_Raster::onNewSurface(const SkImageInfo& info) {
+    if (fExecutor) {
+        return SkSurface::MakeRasterThreaded(info, fExecutor, &this->props());
+    }
     return SkSurface::MakeRaster(info, &this->props());
 }
 
 void SkSurface_Raster::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
                               const SkSamplingOptions& sampling, const SkPaint* paint) {
+    this->flushPendingDraws();
     canvas->drawImage(fBitmap.asImage().get(), x, y, sampling, paint);
 }
 
 sk_sp<SkImage> SkSurface_Raster::onNewImageSnapshot(const SkIRect* subset) {
+    this->flushPendingDraws();
     if (subset) {
         SkASSERT(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()).contains(*subset));
         SkBitmap dst;
@@ -118,6 +142,7 @@ sk_sp<SkImage> SkSurface_Raster::onNewImageSnapshot(const SkIRect* subset) {
 }
 
 void SkSurface_Raster::onWritePixels(const SkPixmap& src, int x, int y) {
+    this->flushPendingDraws();
     fBitmap.writePixels(src, x, y);
 }
 
@@ -129,6 +154,7 @@ void SkSurface_Raster::onRestoreBackingMutability() {
 }
 
 bool SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
+    this->flushPendingDraws();
     // are we sharing pixelrefs with the image?
     sk_sp<SkImage> cached(this->refCachedImage());
     SkASSERT(cached);
@@ -200,6 +226,19 @@ sk_sp<SkSurface> SkSurface::MakeRaster(const SkImageInfo& info, size_t rowBytes,
     return sk_make_sp<SkSurface_Raster>(info, std::move(pr), props);
 }
 
+sk_sp<SkSurface> SkSurface::MakeRasterThreaded(const SkImageInfo& info, SkExecutor* executor,
+                                               const SkSurfaceProps* props) {
+    if (!SkSurfaceValidateRasterInfo(info)) {
+        return nullptr;
+    }
+
+    sk_sp<SkPixelRef> pr = SkMallocPixelRef::MakeAllocate(info, 0);
+    if (!pr) {
+        return nullptr;
+    }
+    return sk_make_sp<SkSurface_Raster>(info, std::move(pr), props, executor);
+}
+
 sk_sp<SkSurface> SkSurface::MakeRasterN32Premul(int width, int height,
                                                 const SkSurfaceProps* surfaceProps) {
     return MakeRaster(SkImageInfo::MakeN32Premul(width, height), surfaceProps);
@@ -14,22 +14,28 @@
 #include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkStream.h"
 #include "include/encode/SkEncoder.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/private/SkNoncopyable.h"
 #include "include/private/SkTemplates.h"
 #include "src/codec/SkJpegPriv.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/images/SkImageEncoderFns.h"
 #include "src/images/SkImageEncoderPriv.h"
 #include "src/images/SkJPEGWriteUtility.h"
 
+#include <algorithm>
+#include <atomic>
 #include <csetjmp>
 #include <cstdint>
 #include <cstring>
 #include <memory>
 #include <utility>
+#include <vector>
 
 extern "C" {
     #include "jpeglib.h"
@@ -177,28 +183,32 @@ bool SkJpegEncoderMgr::setParams(const SkImageInfo& srcInfo, const SkJpegEncoder
     return true;
 }
 
-std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& src,
-                                               const Options& options) {
-    if (!SkPixmapIsValid(src)) {
-        return nullptr;
-    }
-
-    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
-
-    skjpeg_error_mgr::AutoPushJmpBuf jmp(encoderMgr->errorMgr());
+// Sets up mgr to compress src and writes the markers that precede the frame header. A nonzero
+// restartInterval is for the bands of a multithreaded encode (see encode_bands()).
+static bool start_compress(SkJpegEncoderMgr* mgr, const SkPixmap& src,
+                           const SkJpegEncoder::Options& options, bool writeICC,
+                           unsigned restartInterval) {
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(mgr->errorMgr());
     if (setjmp(jmp)) {
-        return nullptr;
+        return false;
     }
 
-    if (!encoderMgr->setParams(src.info(), options)) {
-        return nullptr;
+    if (!mgr->setParams(src.info(), options)) {
+        return false;
     }
 
-    jpeg_set_quality(encoderMgr->cinfo(), options.fQuality, TRUE);
-    jpeg_start_compress(encoderMgr->cinfo(), TRUE);
+    jpeg_set_quality(mgr->cinfo(), options.fQuality, TRUE);
+    if (restartInterval) {
+        // Bands are entropy coded separately but must share Huffman tables, so they can't be
+        // optimized for each band's contents.
+        mgr->cinfo()->optimize_coding = FALSE;
+        mgr->cinfo()->restart_interval = restartInterval;
+    }
+    jpeg_start_compress(mgr->cinfo(), TRUE);
 
-    sk_sp<SkData> icc =
-            icc_from_color_space(src.info(), options.fICCProfile, options.fICCProfileDescription);
+    sk_sp<SkData> icc = writeICC ? icc_from_color_space(src.info(), options.fICCProfile,
+                                                        options.fICCProfileDescription)
+                                 : nullptr;
     if (icc) {
         // Create a contiguous block of memory with the icc signature followed by the profile.
         sk_sp<SkData> markerData =
@@ -210,7 +220,52 @@ std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& s
         *ptr++ = 1; // Out of one total markers.
         memcpy(ptr, icc->data(), icc->size());
 
-        jpeg_write_marker(encoderMgr->cinfo(), kICCMarker, markerData->bytes(), markerData->size());
+        jpeg_write_marker(mgr->cinfo(), kICCMarker, markerData->bytes(), markerData->size());
+    }
+    return true;
+}
+
+// Writes rows [firstRow, firstRow + numRows) of src, transforming them into storage first if
+// the mgr has a proc. The caller must have pushed a jmp_buf.
+static void write_rows(SkJpegEncoderMgr* mgr, const SkPixmap& src, int firstRow, int numRows,
+                       JSAMPLE* storage) {
+    const size_t srcBytes = SkColorTypeBytesPerPixel(src.colorType()) * src.width();
+    const size_t jpegSrcBytes = mgr->cinfo()->input_components * src.width();
+
+    const void* srcRow = src.addr(0, firstRow);
+    for (int i = 0; i < numRows; i++) {
+        JSAMPLE* jpegSrcRow = (JSAMPLE*) srcRow;
+        if (mgr->proc()) {
+            sk_msan_assert_initialized(srcRow, SkTAddOffset<const void>(srcRow, srcBytes));
+            mgr->proc()((char*)storage,
+                        (const char*)srcRow,
+                        src.width(),
+                        mgr->cinfo()->input_components);
+            jpegSrcRow = storage;
+            sk_msan_assert_initialized(jpegSrcRow,
+                                       SkTAddOffset<const void>(jpegSrcRow, jpegSrcBytes));
+        } else {
+            // Same as above, but this repetition allows determining whether a
+            // proc was used when msan asserts.
+            sk_msan_assert_initialized(jpegSrcRow,
+                                       SkTAddOffset<const void>(jpegSrcRow, jpegSrcBytes));
+        }
+
+        jpeg_write_scanlines(mgr->cinfo(), &jpegSrcRow, 1);
+        srcRow = SkTAddOffset<const void>(srcRow, src.rowBytes());
+    }
+}
+
+std::unique_ptr<SkEncoder> SkJpegEncoder::Make(SkWStream* dst, const SkPixmap& src,
+                                               const Options& options) {
+    if (!SkPixmapIsValid(src)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
+    if (!start_compress(encoderMgr.get(), src, options, /*writeICC=*/true,
+                        /*restartInterval=*/0)) {
+        return nullptr;
     }
 
     return std::unique_ptr<SkJpegEncoder>(new SkJpegEncoder(std::move(encoderMgr), src));
@@ -229,41 +284,159 @@ bool SkJpegEncoder::onEncodeRows(int numRows) {
         return false;
     }
 
-    const size_t srcBytes = SkColorTypeBytesPerPixel(fSrc.colorType()) * fSrc.width();
-    const size_t jpegSrcBytes = fEncoderMgr->cinfo()->input_components * fSrc.width();
+    write_rows(fEncoderMgr.get(), fSrc, fCurrRow, numRows, fStorage.get());
 
-    const void* srcRow = fSrc.addr(0, fCurrRow);
-    for (int i = 0; i < numRows; i++) {
-        JSAMPLE* jpegSrcRow = (JSAMPLE*) srcRow;
-        if (fEncoderMgr->proc()) {
-            sk_msan_assert_initialized(srcRow, SkTAddOffset<const void>(srcRow, srcBytes));
-            fEncoderMgr->proc()((char*)fStorage.get(),
-                                (const char*)srcRow,
-                                fSrc.width(),
-                                fEncoderMgr->cinfo()->input_components);
-            jpegSrcRow = fStorage.get();
-            sk_msan_assert_initialized(jpegSrcRow,
-                                       SkTAddOffset<const void>(jpegSrcRow, jpegSrcBytes));
-        } else {
-            // Same as above, but this repetition allows determining whether a
-            // proc was used when msan asserts.
-            sk_msan_assert_initialized(jpegSrcRow,
-                                       SkTAddOffset<const void>(jpegSrcRow, jpegSrcBytes));
+    fCurrRow += numRows;
+    if (fCurrRow == fSrc.height()) {
+        jpeg_finish_compress(fEncoderMgr->cinfo());
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Multithreaded encoding.
+//
+// A restart interval resets the DC predictors and byte aligns the entropy coded data, so every
+// interval can be coded on its own. We cut the image into bands of whole MCU rows, make each band
+// one restart interval, and compress each band as a separate jpeg with identical settings (and
+// so identical quantization and Huffman tables). Color conversion, downsampling and the DCT only
+// look within an MCU, so each band produces exactly the coefficients the whole image would.
+// The result is the first band's headers (with the frame height patched to the full image),
+// every band's entropy coded data separated by RSTn markers, and an EOI.
+
+// Bands smaller than this (in pixels) cost more to set up than their parallelism saves.
+static constexpr int kMinBandPixels = 64 * 1024;
+
+static constexpr uint8_t kMarkerSOF0 = 0xC0,
+                         kMarkerSOF1 = 0xC1,
+                         kMarkerRST0 = 0xD0,
+                         kMarkerEOI  = 0xD9,
+                         kMarkerSOS  = 0xDA;
+
+// Walks the marker segments of a compressed band. Returns the offset of the first byte of entropy
+// coded data (just past the SOS segment), and the offset of the frame height in the SOF segment,
+// or false if the data isn't laid out as expected.
+static bool find_entropy_data(const uint8_t* data, size_t size, size_t* entropyOffset,
+                              size_t* heightOffset) {
+    *heightOffset = 0;
+    size_t i = 2;  // skip SOI
+    while (i + 4 <= size) {
+        if (data[i] != 0xFF) {
+            return false;
+        }
+        const uint8_t marker  = data[i + 1];
+        const size_t  length  = (data[i + 2] << 8) | data[i + 3];
+        if (marker == kMarkerSOF0 || marker == kMarkerSOF1) {
+            *heightOffset = i + 5;  // after the length and the sample precision
         }
+        i += 2 + length;
+        if (marker == kMarkerSOS) {
+            *entropyOffset = i;
+            return *heightOffset != 0 && i + 2 <= size;
+        }
+    }
+    return false;
+}
 
-        jpeg_write_scanlines(fEncoderMgr->cinfo(), &jpegSrcRow, 1);
-        srcRow = SkTAddOffset<const void>(srcRow, fSrc.rowBytes());
+// Returns false if the image was too small to split, in which case nothing has been written.
+static bool encode_bands(SkWStream* dst, const SkPixmap& src,
+                         const SkJpegEncoder::Options& options, bool* success) {
+    const bool gray = kGray_8_SkColorType == src.colorType();
+    const int mcuWidth  = gray || options.fDownsample == SkJpegEncoder::Downsample::k444 ? 8 : 16;
+    const int mcuHeight = gray || options.fDownsample != SkJpegEncoder::Downsample::k420 ? 8 : 16;
+
+    // Restart intervals are counted in MCUs, in 16 bits.
+    const int mcusPerRow   = (src.width()  + mcuWidth  - 1) / mcuWidth;
+    const int mcuRowCount  = (src.height() + mcuHeight - 1) / mcuHeight;
+    const int maxBandRows  = 0xFFFF / mcusPerRow;
+    const int bandMcuRows  = std::min(maxBandRows,
+                                      std::max(1, kMinBandPixels / (src.width() * mcuHeight)));
+    if (bandMcuRows < 1) {
+        return false;
+    }
+    const int bandCount = (mcuRowCount + bandMcuRows - 1) / bandMcuRows;
+    if (bandCount < 2) {
+        return false;
     }
+    const int bandHeight = bandMcuRows * mcuHeight;
+
+    std::vector<SkDynamicMemoryWStream> bandStreams(bandCount);
+    std::atomic<bool> failed{false};
+    SkTaskGroup(*options.fExecutor).batch(bandCount, [&](int i) {
+        SkPixmap band;
+        SkAssertResult(src.extractSubset(&band, SkIRect::MakeLTRB(
+                0, i * bandHeight, src.width(), std::min(src.height(), (i + 1) * bandHeight))));
+
+        std::unique_ptr<SkJpegEncoderMgr> mgr = SkJpegEncoderMgr::Make(&bandStreams[i]);
+        if (!start_compress(mgr.get(), band, options, /*writeICC=*/i == 0,
+                            bandMcuRows * mcusPerRow)) {
+            failed = true;
+            return;
+        }
+        std::unique_ptr<JSAMPLE[]> storage(
+                mgr->proc() ? new JSAMPLE[mgr->cinfo()->input_components * src.width()]
+                            : nullptr);
+
+        skjpeg_error_mgr::AutoPushJmpBuf jmp(mgr->errorMgr());
+        if (setjmp(jmp)) {
+            failed = true;
+            return;
+        }
+        write_rows(mgr.get(), band, 0, band.height(), storage.get());
+        jpeg_finish_compress(mgr->cinfo());
+    });
 
-    fCurrRow += numRows;
-    if (fCurrRow == fSrc.height()) {
-        jpeg_finish_compress(fEncoderMgr->cinfo());
+    *success = false;
+    if (failed) {
+        return true;
+    }
+    std::vector<sk_sp<SkData>> bands(bandCount);
+    std::vector<size_t> entropyOffsets(bandCount);
+    size_t heightOffset = 0;
+    for (int i = 0; i < bandCount; i++) {
+        bands[i] = bandStreams[i].detachAsData();
+        size_t bandHeightOffset;
+        if (!find_entropy_data(bands[i]->bytes(), bands[i]->size(), &entropyOffsets[i],
+                               &bandHeightOffset)) {
+            return true;
+        }
+        if (i == 0) {
+            heightOffset = bandHeightOffset;
+        }
+    }
+
+    // The first band's headers, describing the whole image.
+    const uint8_t* header = bands[0]->bytes();
+    const uint8_t height[2] = {(uint8_t)(src.height() >> 8), (uint8_t)src.height()};
+    if (!dst->write(header, heightOffset) ||
+        !dst->write(height, sizeof(height)) ||
+        !dst->write(header + heightOffset + 2, entropyOffsets[0] - heightOffset - 2)) {
+        return true;
     }
 
+    for (int i = 0; i < bandCount; i++) {
+        // Each band ends with its EOI marker, which we leave off.
+        const uint8_t* entropy = bands[i]->bytes() + entropyOffsets[i];
+        const size_t entropySize = bands[i]->size() - entropyOffsets[i] - 2;
+        const uint8_t marker[2] = {0xFF, i == bandCount - 1 ? kMarkerEOI
+                                                            : (uint8_t)(kMarkerRST0 + (i & 7))};
+        if (!dst->write(entropy, entropySize) || !dst->write(marker, sizeof(marker))) {
+            return true;
+        }
+    }
+    *success = true;
     return true;
 }
 
 bool SkJpegEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
+    if (options.fExecutor && SkPixmapIsValid(src)) {
+        bool success;
+        if (encode_bands(dst, src, options, &success)) {
+            return success;
+        }
+    }
     auto encoder = SkJpegEncoder::Make(dst, src, options);
     return encoder.get() && encoder->encodeRows(src.height());
 }
@@ -26,12 +26,15 @@
 #include "modules/skcms/skcms.h"
 #include "src/codec/SkPngPriv.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/images/SkImageEncoderFns.h"
 #include "src/images/SkImageEncoderPriv.h"
 
 #include <algorithm>
 #include <csetjmp>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
@@ -39,6 +42,7 @@
 
 #include <png.h>
 #include <pngconf.h>
+#include <zlib.h>
 
 static_assert(PNG_FILTER_NONE  == (int)SkPngEncoder::FilterFlag::kNone,  "Skia libpng filter err.");
 static_assert(PNG_FILTER_SUB   == (int)SkPngEncoder::FilterFlag::kSub,   "Skia libpng filter err.");
@@ -483,9 +487,331 @@ bool SkPngEncoder::onEncodeRows(int numRows) {
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Multithreaded encoding, in the style of pigz.
+//
+// libpng has already written everything up to the image data. The rows are split into strips,
+// and each strip is filtered and deflated on its own: the raw deflate stream of every strip but
+// the last ends with a sync flush, so it stops on a byte boundary without a final block, and each
+// strip after the first is primed with the last 32K of filtered data above it, so matches can
+// still reach back across the seam. Concatenated behind a zlib header and followed by the
+// combined Adler-32 of every strip, they form one valid zlib stream. Each strip is written as its
+// own IDAT chunk, with its CRC computed alongside the deflate.
+
+// Strips smaller than this (in filtered bytes) cost more in flushes and lost context than their
+// parallelism saves.
+static constexpr size_t kMinStripBytes = 256 * 1024;
+
+// deflate's window, and so the most of the previous strip that is useful as a dictionary.
+static constexpr size_t kDeflateWindowBytes = 32 * 1024;
+
+// The filter type bytes that start each filtered row.
+enum : uint8_t {
+    kFilterNone  = 0,
+    kFilterSub   = 1,
+    kFilterUp    = 2,
+    kFilterAvg   = 3,
+    kFilterPaeth = 4,
+};
+
+static uint8_t paeth_predictor(int a, int b, int c) {
+    const int p  = a + b - c,
+              pa = std::abs(p - a),
+              pb = std::abs(p - b),
+              pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Filters row (whose unfiltered predecessor is prev) into dst with a single filter.
+static void filter_row(uint8_t type, uint8_t* dst, const uint8_t* row, const uint8_t* prev,
+                       size_t rowBytes, size_t bpp) {
+    const size_t lead = std::min(bpp, rowBytes);
+    switch (type) {
+        case kFilterNone:
+            memcpy(dst, row, rowBytes);
+            break;
+        case kFilterSub:
+            memcpy(dst, row, lead);
+            for (size_t i = lead; i < rowBytes; i++) {
+                dst[i] = row[i] - row[i - bpp];
+            }
+            break;
+        case kFilterUp:
+            for (size_t i = 0; i < rowBytes; i++) {
+                dst[i] = row[i] - prev[i];
+            }
+            break;
+        case kFilterAvg:
+            for (size_t i = 0; i < lead; i++) {
+                dst[i] = row[i] - (prev[i] >> 1);
+            }
+            for (size_t i = lead; i < rowBytes; i++) {
+                dst[i] = row[i] - ((row[i - bpp] + prev[i]) >> 1);
+            }
+            break;
+        case kFilterPaeth:
+            for (size_t i = 0; i < lead; i++) {
+                dst[i] = row[i] - prev[i];  // paeth_predictor(0, b, 0) is always b
+            }
+            for (size_t i = lead; i < rowBytes; i++) {
+                dst[i] = row[i] - paeth_predictor(row[i - bpp], prev[i], prev[i - bpp]);
+            }
+            break;
+    }
+}
+
+// Writes the filter type byte and filtered row to dst. Like libpng, when more than one filter is
+// allowed this picks the one whose output has the smallest sum of absolute (signed) values.
+static void choose_and_filter_row(int filterFlags, uint8_t* dst, const uint8_t* row,
+                                  const uint8_t* prev, size_t rowBytes, size_t bpp,
+                                  uint8_t* scratch) {
+    static constexpr struct { SkPngEncoder::FilterFlag flag; uint8_t type; } kFilters[] = {
+        {SkPngEncoder::FilterFlag::kNone,  kFilterNone},
+        {SkPngEncoder::FilterFlag::kSub,   kFilterSub},
+        {SkPngEncoder::FilterFlag::kUp,    kFilterUp},
+        {SkPngEncoder::FilterFlag::kAvg,   kFilterAvg},
+        {SkPngEncoder::FilterFlag::kPaeth, kFilterPaeth},
+    };
+
+    int allowed = 0;
+    uint8_t onlyType = kFilterNone;
+    for (const auto& f : kFilters) {
+        if (filterFlags & (int)f.flag) {
+            allowed++;
+            onlyType = f.type;
+        }
+    }
+    if (allowed <= 1) {
+        dst[0] = onlyType;
+        filter_row(onlyType, dst + 1, row, prev, rowBytes, bpp);
+        return;
+    }
+
+    uint64_t bestSum = UINT64_MAX;
+    for (const auto& f : kFilters) {
+        if (!(filterFlags & (int)f.flag)) {
+            continue;
+        }
+        filter_row(f.type, scratch, row, prev, rowBytes, bpp);
+        uint64_t sum = 0;
+        for (size_t i = 0; i < rowBytes; i++) {
+            sum += std::abs((int)(int8_t)scratch[i]);
+        }
+        if (sum < bestSum) {
+            bestSum = sum;
+            dst[0] = f.type;
+            memcpy(dst + 1, scratch, rowBytes);
+        }
+    }
+}
+
+static bool write_chunk_header(SkWStream* dst, const char type[4], size_t length) {
+    const uint8_t len[4] = {(uint8_t)(length >> 24), (uint8_t)(length >> 16),
+                            (uint8_t)(length >>  8), (uint8_t)(length      )};
+    return dst->write(len, 4) && dst->write(type, 4);
+}
+
+static bool write_u32_be(SkWStream* dst, uint32_t v) {
+    const uint8_t bytes[4] = {(uint8_t)(v >> 24), (uint8_t)(v >> 16),
+                              (uint8_t)(v >>  8), (uint8_t)(v      )};
+    return dst->write(bytes, 4);
+}
+
+// Returns false if the image was too small to split, in which case nothing has been written.
+static bool encode_strips(SkPngEncoderMgr* mgr, SkWStream* dst, const SkPixmap& src,
+                          const SkPngEncoder::Options& options, bool* success) {
+    png_structp pngPtr  = mgr->pngPtr();
+    png_infop   infoPtr = mgr->infoPtr();
+
+    const int    width        = src.width();
+    const int    height       = src.height();
+    const size_t pngRowBytes  = png_get_rowbytes(pngPtr, infoPtr);
+    const size_t pngBpp       = pngRowBytes / width;  // all our bit depths are whole bytes
+    const size_t transformBpp = mgr->pngBytesPerPixel();
+    const size_t filteredRowBytes = pngRowBytes + 1;
+
+    const int rowsPerStrip = (int)std::max<size_t>(1, kMinStripBytes / filteredRowBytes);
+    const int stripCount   = (height + rowsPerStrip - 1) / rowsPerStrip;
+    if (stripCount < 2) {
+        return false;
+    }
+
+    // The transforms produce 16-bit RGBA for every 16-bit format. Opaque images are written as
+    // RGB, so their alpha is dropped here (where the libpng path uses png_set_filler()).
+    SkASSERT(transformBpp == pngBpp || (transformBpp == 8 && pngBpp == 6));
+    const bool dropAlpha = transformBpp != pngBpp;
+
+    const int filterFlags = (int)options.fFilterFlags & (int)SkPngEncoder::FilterFlag::kAll;
+    const int zlibLevel   = std::min(std::max(0, options.fZLibLevel), 9);
+
+    struct Strip {
+        int                  fTop, fBottom;
+        std::vector<uint8_t> fFiltered;  // a filter type byte and a filtered row, for each row
+        std::vector<uint8_t> fDeflated;  // raw deflate data, ending on a byte boundary
+        uLong                fAdler = 0;
+        uLong                fCrc   = 0;
+        bool                 fOk    = false;
+    };
+    std::vector<Strip> strips(stripCount);
+    for (int i = 0; i < stripCount; i++) {
+        strips[i].fTop    = i * rowsPerStrip;
+        strips[i].fBottom = std::min(height, (i + 1) * rowsPerStrip);
+    }
+
+    SkTaskGroup group(*options.fExecutor);
+
+    // Filtering only looks up one row, so every strip can be filtered at once: a strip just
+    // transforms the row above it too.
+    group.batch(stripCount, [&](int i) {
+        Strip& strip = strips[i];
+        strip.fFiltered.resize((strip.fBottom - strip.fTop) * filteredRowBytes);
+
+        std::vector<uint8_t> storage(transformBpp * width);
+        std::vector<uint8_t> rows[2] = {std::vector<uint8_t>(pngRowBytes, 0),
+                                        std::vector<uint8_t>(pngRowBytes, 0)};
+        std::vector<uint8_t> scratch(pngRowBytes);
+
+        auto transform = [&](int y, uint8_t* out) {
+            const void* srcRow = src.addr(0, y);
+            sk_msan_assert_initialized(srcRow,
+                                       (const uint8_t*)srcRow + (width << src.shiftPerPixel()));
+            mgr->proc()((char*)(dropAlpha ? storage.data() : out), (const char*)srcRow, width,
+                        SkColorTypeBytesPerPixel(src.colorType()));
+            if (dropAlpha) {
+                for (int x = 0; x < width; x++) {
+                    memcpy(out + 6 * x, storage.data() + 8 * x, 6);
+                }
+            }
+        };
+
+        // rows[0] is the row above (all zero above the first row), rows[1] the current one.
+        if (strip.fTop > 0) {
+            transform(strip.fTop - 1, rows[0].data());
+        }
+        uint8_t* dstRow = strip.fFiltered.data();
+        for (int y = strip.fTop; y < strip.fBottom; y++) {
+            transform(y, rows[1].data());
+            choose_and_filter_row(filterFlags, dstRow, rows[1].data(), rows[0].data(),
+                                  pngRowBytes, pngBpp, scratch.data());
+            dstRow += filteredRowBytes;
+            std::swap(rows[0], rows[1]);
+        }
+    });
+    group.wait();
+
+    // The zlib header: deflate with a 32K window, at a compression level hint matching zlib's.
+    const int levelFlags = zlibLevel < 2 ? 0 : zlibLevel < 6 ? 1 : zlibLevel == 6 ? 2 : 3;
+    uint16_t zlibHeader = (0x78 << 8) | (levelFlags << 6);
+    zlibHeader += 31 - (zlibHeader % 31);
+    const uint8_t headerBytes[2] = {(uint8_t)(zlibHeader >> 8), (uint8_t)zlibHeader};
+
+    // Now each strip can be deflated, with the end of the one above as its dictionary.
+    group.batch(stripCount, [&](int i) {
+        Strip& strip = strips[i];
+        const bool last = i == stripCount - 1;
+
+        z_stream zs;
+        memset(&zs, 0, sizeof(zs));
+        // Negative window bits for a raw deflate stream; we write the zlib wrapper ourselves.
+        if (Z_OK != deflateInit2(&zs, zlibLevel, Z_DEFLATED, -15, 8,
+                                 filterFlags == (int)SkPngEncoder::FilterFlag::kNone
+                                        ? Z_DEFAULT_STRATEGY : Z_FILTERED)) {
+            return;
+        }
+        if (i > 0) {
+            const std::vector<uint8_t>& above = strips[i - 1].fFiltered;
+            const size_t dictSize = std::min(above.size(), kDeflateWindowBytes);
+            deflateSetDictionary(&zs, above.data() + above.size() - dictSize, (uInt)dictSize);
+        }
+
+        // Leave room for the flush marker beyond deflateBound()'s estimate.
+        strip.fDeflated.resize(deflateBound(&zs, strip.fFiltered.size()) + 16);
+        zs.next_in   = strip.fFiltered.data();
+        zs.avail_in  = (uInt)strip.fFiltered.size();
+        zs.next_out  = strip.fDeflated.data();
+        zs.avail_out = (uInt)strip.fDeflated.size();
+        const int result = deflate(&zs, last ? Z_FINISH : Z_SYNC_FLUSH);
+        const bool done = last ? result == Z_STREAM_END
+                               : result == Z_OK && zs.avail_in == 0 && zs.avail_out > 0;
+        strip.fDeflated.resize(zs.total_out);
+        deflateEnd(&zs);
+        if (!done) {
+            return;
+        }
+
+        // Each strip's IDAT chunk CRC covers the chunk type and, for the first, the zlib header.
+        strip.fAdler = adler32(adler32(0, nullptr, 0),
+                               strip.fFiltered.data(), (uInt)strip.fFiltered.size());
+        strip.fCrc = crc32(crc32(0, nullptr, 0), (const Bytef*)"IDAT", 4);
+        if (i == 0) {
+            strip.fCrc = crc32(strip.fCrc, headerBytes, sizeof(headerBytes));
+        }
+        strip.fCrc = crc32(strip.fCrc, strip.fDeflated.data(), (uInt)strip.fDeflated.size());
+        strip.fOk = true;
+    });
+    group.wait();
+
+    *success = false;
+    for (const Strip& strip : strips) {
+        if (!strip.fOk) {
+            return true;
+        }
+    }
+
+    uLong adler = strips[0].fAdler;
+    for (int i = 1; i < stripCount; i++) {
+        const Strip& strip = strips[i];
+        adler = adler32_combine(adler, strip.fAdler,
+                                (z_off_t)((strip.fBottom - strip.fTop) * filteredRowBytes));
+    }
+    const uint8_t trailerBytes[4] = {(uint8_t)(adler >> 24), (uint8_t)(adler >> 16),
+                                     (uint8_t)(adler >>  8), (uint8_t)(adler      )};
+
+    for (int i = 0; i < stripCount; i++) {
+        const Strip& strip = strips[i];
+        const bool first = i == 0,
+                   last  = i == stripCount - 1;
+        uLong crc = strip.fCrc;
+        size_t length = strip.fDeflated.size();
+        if (first) {
+            length += sizeof(headerBytes);
+        }
+        if (last) {
+            length += sizeof(trailerBytes);
+            crc = crc32(crc, trailerBytes, sizeof(trailerBytes));
+        }
+
+        if (!write_chunk_header(dst, "IDAT", length) ||
+            (first && !dst->write(headerBytes, sizeof(headerBytes))) ||
+            !dst->write(strip.fDeflated.data(), strip.fDeflated.size()) ||
+            (last && !dst->write(trailerBytes, sizeof(trailerBytes))) ||
+            !write_u32_be(dst, (uint32_t)crc)) {
+            return true;
+        }
+    }
+
+    // IEND has no data, so its CRC is always that of "IEND".
+    *success = write_chunk_header(dst, "IEND", 0) && write_u32_be(dst, 0xAE426082);
+    return true;
+}
+
 bool SkPngEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
     auto encoder = SkPngEncoder::Make(dst, src, options);
-    return encoder.get() && encoder->encodeRows(src.height());
+    if (!encoder) {
+        return false;
+    }
+    if (options.fExecutor) {
+        bool success;
+        auto png = static_cast<SkPngEncoder*>(encoder.get());
+        if (encode_strips(png->fEncoderMgr.get(), dst, src, options, &success)) {
+            return success;
+        }
+    }
+    return encoder->encodeRows(src.height());
 }
 
 #endif
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMipmap_opts_DEFINED
+#define SkMipmap_opts_DEFINED
+
+#include "include/private/SkVx.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// These are the 2x2 box filters SkMipmap uses for even-sized levels of its most common color
+// types. Each one averages pairs of source rows down to one row of count destination pixels,
+// producing the same results as the portable downsample_2_2<> in SkMipmap.cpp, but filtering
+// several destination pixels per iteration: each source row is loaded as one wide vector, and
+// the even and odd pixels are split apart with shuffles before they are added together.
+
+namespace SK_OPTS_NS {
+
+    /*not static*/ inline void downsample_2_2_8888(void* dst, const void* src, size_t srcRB,
+                                                   int count) {
+        auto p0 = static_cast<const uint8_t*>(src);
+        auto p1 = p0 + srcRB;
+        auto d  = static_cast<uint8_t*>(dst);
+
+        // 4 dst pixels at a time, from 8 src pixels in each row.
+        while (count >= 4) {
+            auto sum = skvx::cast<uint16_t>(skvx::Vec<32,uint8_t>::Load(p0)) +
+                       skvx::cast<uint16_t>(skvx::Vec<32,uint8_t>::Load(p1));
+            auto even = skvx::shuffle<0,1,2,3,  8, 9,10,11, 16,17,18,19, 24,25,26,27>(sum),
+                 odd  = skvx::shuffle<4,5,6,7, 12,13,14,15, 20,21,22,23, 28,29,30,31>(sum);
+            skvx::cast<uint8_t>((even + odd) >> 2).store(d);
+            p0    += 32;
+            p1    += 32;
+            d     += 16;
+            count -= 4;
+        }
+        while (count --> 0) {
+            auto sum = skvx::cast<uint16_t>(skvx::Vec<8,uint8_t>::Load(p0)) +
+                       skvx::cast<uint16_t>(skvx::Vec<8,uint8_t>::Load(p1));
+            auto even = skvx::shuffle<0,1,2,3>(sum),
+                 odd  = skvx::shuffle<4,5,6,7>(sum);
+            skvx::cast<uint8_t>((even + odd) >> 2).store(d);
+            p0 += 8;
+            p1 += 8;
+            d  += 4;
+        }
+    }
+
+    /*not static*/ inline void downsample_2_2_F16(void* dst, const void* src, size_t srcRB,
+                                                  int count) {
+        auto p0 = static_cast<const uint16_t*>(src);
+        auto p1 = (const uint16_t*)((const char*)p0 + srcRB);
+        auto d  = static_cast<uint16_t*>(dst);
+
+        // The sums are formed in the same order as the portable filter, so when to_half() and
+        // from_half() are exact (i.e. without F16C) the results match it bit for bit.
+        while (count >= 4) {
+            auto r0 = skvx::from_half(skvx::Vec<32,uint16_t>::Load(p0)),
+                 r1 = skvx::from_half(skvx::Vec<32,uint16_t>::Load(p1));
+            auto even0 = skvx::shuffle<0,1,2,3,  8, 9,10,11, 16,17,18,19, 24,25,26,27>(r0),
+                 odd0  = skvx::shuffle<4,5,6,7, 12,13,14,15, 20,21,22,23, 28,29,30,31>(r0),
+                 even1 = skvx::shuffle<0,1,2,3,  8, 9,10,11, 16,17,18,19, 24,25,26,27>(r1),
+                 odd1  = skvx::shuffle<4,5,6,7, 12,13,14,15, 20,21,22,23, 28,29,30,31>(r1);
+            skvx::to_half((even0 + even1 + odd0 + odd1) * 0.25f).store(d);
+            p0    += 32;
+            p1    += 32;
+            d     += 16;
+            count -= 4;
+        }
+        while (count --> 0) {
+            auto r0 = skvx::from_half(skvx::Vec<8,uint16_t>::Load(p0)),
+                 r1 = skvx::from_half(skvx::Vec<8,uint16_t>::Load(p1));
+            auto even0 = skvx::shuffle<0,1,2,3>(r0),
+                 odd0  = skvx::shuffle<4,5,6,7>(r0),
+                 even1 = skvx::shuffle<0,1,2,3>(r1),
+                 odd1  = skvx::shuffle<4,5,6,7>(r1);
+            skvx::to_half((even0 + even1 + odd0 + odd1) * 0.25f).store(d);
+            p0 += 8;
+            p1 += 8;
+            d  += 4;
+        }
+    }
+
+    /*not static*/ inline void downsample_2_2_A8(void* dst, const void* src, size_t srcRB,
+                                                 int count) {
+        auto p0 = static_cast<const uint8_t*>(src);
+        auto p1 = p0 + srcRB;
+        auto d  = static_cast<uint8_t*>(dst);
+
+        // 16 dst pixels at a time, from 32 src pixels in each row.
+        while (count >= 16) {
+            auto sum = skvx::cast<uint16_t>(skvx::Vec<32,uint8_t>::Load(p0)) +
+                       skvx::cast<uint16_t>(skvx::Vec<32,uint8_t>::Load(p1));
+            auto even = skvx::shuffle<0,2,4,6,8,10,12,14,16,18,20,22,24,26,28,30>(sum),
+                 odd  = skvx::shuffle<1,3,5,7,9,11,13,15,17,19,21,23,25,27,29,31>(sum);
+            skvx::cast<uint8_t>((even + odd) >> 2).store(d);
+            p0    += 32;
+            p1    += 32;
+            d     += 16;
+            count -= 16;
+        }
+        while (count --> 0) {
+            *d++ = (uint8_t)((p0[0] + p0[1] + p1[0] + p1[1]) >> 2);
+            p0 += 2;
+            p1 += 2;
+        }
+    }
+
+}  // namespace SK_OPTS_NS
+
+#endif  // SkMipmap_opts_DEFINED
@@ -13,6 +13,7 @@
 #include "src/core/SkCubicSolver.h"
 #include "src/opts/SkBitmapProcState_opts.h"
 #include "src/opts/SkBlitRow_opts.h"
+#include "src/opts/SkMipmap_opts.h"
 #include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkSwizzler_opts.h"
 #include "src/opts/SkUtils_opts.h"
@@ -27,12 +28,23 @@ namespace SkOpts {
 
         cubic_solver = SK_OPTS_NS::cubic_solver;
 
+        downsample_2_2_8888 = SK_OPTS_NS::downsample_2_2_8888;
+        downsample_2_2_F16  = SK_OPTS_NS::downsample_2_2_F16;
+        downsample_2_2_A8   = SK_OPTS_NS::downsample_2_2_A8;
+
         RGBA_to_BGRA          = SK_OPTS_NS::RGBA_to_BGRA;
         RGBA_to_rgbA          = SK_OPTS_NS::RGBA_to_rgbA;
         RGBA_to_bgrA          = SK_OPTS_NS::RGBA_to_bgrA;
         gray_to_RGB1          = SK_OPTS_NS::gray_to_RGB1;
         grayA_to_RGBA         = SK_OPTS_NS::grayA_to_RGBA;
         grayA_to_rgbA         = SK_OPTS_NS::grayA_to_rgbA;
+        RGBA16_to_RGBA        = SK_OPTS_NS::RGBA16_to_RGBA;
+        RGBA16_to_BGRA        = SK_OPTS_NS::RGBA16_to_BGRA;
+        RGBA16_to_rgbA        = SK_OPTS_NS::RGBA16_to_rgbA;
+        RGBA16_to_bgrA        = SK_OPTS_NS::RGBA16_to_bgrA;
+        index_to_8888         = SK_OPTS_NS::index_to_8888;
+        bitfields16_to_8888   = SK_OPTS_NS::bitfields16_to_8888;
+        bitfields32_to_8888   = SK_OPTS_NS::bitfields32_to_8888;
         inverted_CMYK_to_RGB1 = SK_OPTS_NS::inverted_CMYK_to_RGB1;
         inverted_CMYK_to_BGR1 = SK_OPTS_NS::inverted_CMYK_to_BGR1;
 
@@ -28,6 +28,14 @@ namespace SkOpts {
         gray_to_RGB1          = ssse3::gray_to_RGB1;
         grayA_to_RGBA         = ssse3::grayA_to_RGBA;
         grayA_to_rgbA         = ssse3::grayA_to_rgbA;
+        RGB16_to_RGB1         = ssse3::RGB16_to_RGB1;
+        RGB16_to_BGR1         = ssse3::RGB16_to_BGR1;
+        RGBA16_to_RGBA        = ssse3::RGBA16_to_RGBA;
+        RGBA16_to_BGRA        = ssse3::RGBA16_to_BGRA;
+        RGBA16_to_rgbA        = ssse3::RGBA16_to_rgbA;
+        RGBA16_to_bgrA        = ssse3::RGBA16_to_bgrA;
+        bitfields16_to_8888   = ssse3::bitfields16_to_8888;
+        bitfields32_to_8888   = ssse3::bitfields32_to_8888;
         inverted_CMYK_to_RGB1 = ssse3::inverted_CMYK_to_RGB1;
         inverted_CMYK_to_BGR1 = ssse3::inverted_CMYK_to_BGR1;
 
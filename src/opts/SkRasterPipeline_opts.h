@@ -347,7 +347,210 @@ namespace SK_OPTS_NS {
         }
     }
 
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#elif defined(JUMPER_IS_SKX)
+    // These are __m512 and __m512i, but friendlier and strongly-typed.
+    template <typename T> using V = T __attribute__((ext_vector_type(16)));
+    using F   = V<float   >;
+    using I32 = V< int32_t>;
+    using U64 = V<uint64_t>;
+    using U32 = V<uint32_t>;
+    using U16 = V<uint16_t>;
+    using U8  = V<uint8_t >;
+
+    SI F   mad(F f, F m, F a)  { return _mm512_fmadd_ps(f,m,a); }
+
+    SI F   min(F a, F b)     { return _mm512_min_ps(a,b);    }
+    SI I32 min(I32 a, I32 b) { return _mm512_min_epi32(a,b); }
+    SI U32 min(U32 a, U32 b) { return _mm512_min_epu32(a,b); }
+    SI F   max(F a, F b)     { return _mm512_max_ps(a,b);    }
+    SI I32 max(I32 a, I32 b) { return _mm512_max_epi32(a,b); }
+    SI U32 max(U32 a, U32 b) { return _mm512_max_epu32(a,b); }
+
+    SI F   abs_  (F v)   { return _mm512_abs_ps(v);                              }
+    SI I32 abs_  (I32 v) { return _mm512_abs_epi32(v);                           }
+    SI F   floor_(F v)   { return _mm512_roundscale_ps(v, _MM_FROUND_TO_NEG_INF); }
+    SI F   ceil_(F v)    { return _mm512_roundscale_ps(v, _MM_FROUND_TO_POS_INF); }
+    SI F   rcp_fast(F v) { return _mm512_rcp14_ps  (v);                          }
+    SI F   rsqrt (F v)   { return _mm512_rsqrt14_ps(v);                          }
+    SI F   sqrt_ (F v)   { return _mm512_sqrt_ps   (v);                          }
+    SI F rcp_precise (F v) {
+        F e = rcp_fast(v);
+        return _mm512_fnmadd_ps(v, e, _mm512_set1_ps(2.0f)) * e;
+    }
+
+    SI U32 round (F v, F scale) { return _mm512_cvtps_epi32(v*scale); }
+    SI U16 pack(U32 v) {
+        // Clamp negative values to zero first, to saturate like _mm_packus_epi32() does.
+        return _mm512_cvtusepi32_epi16(_mm512_max_epi32(v, _mm512_setzero_si512()));
+    }
+    SI U8 pack(U16 v) {
+        return _mm256_cvtusepi16_epi8(_mm256_max_epi16(v, _mm256_setzero_si256()));
+    }
+
+    SI F if_then_else(I32 c, F t, F e) {
+        return _mm512_mask_blend_ps(_mm512_movepi32_mask(c), e, t);
+    }
+    // NOTE: This version of 'all' only works with mask values (true == all bits set)
+    SI bool any(I32 c) { return _mm512_movepi32_mask(c) != 0;      }
+    SI bool all(I32 c) { return _mm512_movepi32_mask(c) == 0xffff; }
+
+    template <typename T>
+    SI V<T> gather(const T* p, U32 ix) {
+        return { p[ix[ 0]], p[ix[ 1]], p[ix[ 2]], p[ix[ 3]],
+                 p[ix[ 4]], p[ix[ 5]], p[ix[ 6]], p[ix[ 7]],
+                 p[ix[ 8]], p[ix[ 9]], p[ix[10]], p[ix[11]],
+                 p[ix[12]], p[ix[13]], p[ix[14]], p[ix[15]], };
+    }
+    SI F   gather(const float*    p, U32 ix) { return _mm512_i32gather_ps   (ix, p, 4); }
+    SI U32 gather(const uint32_t* p, U32 ix) { return _mm512_i32gather_epi32(ix, p, 4); }
+    SI U64 gather(const uint64_t* p, U32 ix) {
+        __m512i parts[] = {
+            _mm512_i32gather_epi64(_mm512_castsi512_si256     (ix   ), p, 8),
+            _mm512_i32gather_epi64(_mm512_extracti64x4_epi64  (ix, 1), p, 8),
+        };
+        return sk_bit_cast<U64>(parts);
+    }
+
+    // The interleaved load and store helpers below move whole pixels through one wide vector, W,
+    // with lanes channel-interleaved as in memory, and use __builtin_shufflevector() to transpose.
+    // Tails use AVX-512 byte-masked loads and stores, which never touch the masked-off bytes.
+    template <typename T, int K> using Wide = T __attribute__((ext_vector_type(K)));
+
+    SI uint64_t first_bytes(ptrdiff_t n) {
+        return n <= 0  ?  0
+             : n >= 64 ? ~0ull
+                       : (1ull << n) - 1;
+    }
+
+    // Loads the first `bytes` bytes of W from ptr, zeroing the rest of W.
+    template <typename W>
+    SI W load_masked(const void* ptr, size_t bytes) {
+        constexpr size_t kParts = (sizeof(W) + 63) / 64;
+        __m512i parts[kParts];
+        for (size_t i = 0; i < kParts; i++) {
+            parts[i] = _mm512_maskz_loadu_epi8(first_bytes((ptrdiff_t)bytes - 64*(ptrdiff_t)i),
+                                               (const char*)ptr + 64*i);
+        }
+        return sk_unaligned_load<W>(parts);
+    }
+
+    // Stores the first `bytes` bytes of v to ptr.
+    template <typename W>
+    SI void store_masked(void* ptr, size_t bytes, W v) {
+        constexpr size_t kParts = (sizeof(W) + 63) / 64;
+        __m512i parts[kParts] = {};
+        memcpy(parts, &v, sizeof(W));
+        for (size_t i = 0; i < kParts; i++) {
+            _mm512_mask_storeu_epi8((char*)ptr + 64*i,
+                                    first_bytes((ptrdiff_t)bytes - 64*(ptrdiff_t)i), parts[i]);
+        }
+    }
+
+    template <typename W>
+    SI W load_pixels(const void* ptr, size_t tail, size_t bytesPerPixel) {
+        size_t bytes = (tail ? tail : 16) * bytesPerPixel;
+        return __builtin_expect(bytes == sizeof(W), 1) ? sk_unaligned_load<W>(ptr)
+                                                       : load_masked<W>(ptr, bytes);
+    }
+
+    template <typename W>
+    SI void store_pixels(void* ptr, size_t tail, size_t bytesPerPixel, W v) {
+        size_t bytes = (tail ? tail : 16) * bytesPerPixel;
+        if (__builtin_expect(bytes == sizeof(W), 1)) {
+            sk_unaligned_store(ptr, v);
+        } else {
+            store_masked(ptr, bytes, v);
+        }
+    }
+
+    SI void load2(const uint16_t* ptr, size_t tail, U16* r, U16* g) {
+        auto v = load_pixels<Wide<uint16_t,32>>(ptr, tail, 2*sizeof(uint16_t));
+        *r = __builtin_shufflevector(v,v, 0, 2, 4, 6, 8,10,12,14,16,18,20,22,24,26,28,30);
+        *g = __builtin_shufflevector(v,v, 1, 3, 5, 7, 9,11,13,15,17,19,21,23,25,27,29,31);
+    }
+    SI void store2(uint16_t* ptr, size_t tail, U16 r, U16 g) {
+        Wide<uint16_t,32> v = __builtin_shufflevector(r,g, 0,16, 1,17, 2,18, 3,19,
+                                                           4,20, 5,21, 6,22, 7,23,
+                                                           8,24, 9,25,10,26,11,27,
+                                                          12,28,13,29,14,30,15,31);
+        store_pixels(ptr, tail, 2*sizeof(uint16_t), v);
+    }
+
+    SI void load3(const uint16_t* ptr, size_t tail, U16* r, U16* g, U16* b) {
+        // 16 RGB pixels are only 96 bytes; the upper lanes of v are masked off and left zero.
+        auto v = load_pixels<Wide<uint16_t,64>>(ptr, tail, 3*sizeof(uint16_t));
+        *r = __builtin_shufflevector(v,v, 0, 3, 6, 9,12,15,18,21,24,27,30,33,36,39,42,45);
+        *g = __builtin_shufflevector(v,v, 1, 4, 7,10,13,16,19,22,25,28,31,34,37,40,43,46);
+        *b = __builtin_shufflevector(v,v, 2, 5, 8,11,14,17,20,23,26,29,32,35,38,41,44,47);
+    }
+    SI void load4(const uint16_t* ptr, size_t tail, U16* r, U16* g, U16* b, U16* a) {
+        auto v = load_pixels<Wide<uint16_t,64>>(ptr, tail, 4*sizeof(uint16_t));
+        *r = __builtin_shufflevector(v,v, 0, 4, 8,12,16,20,24,28,32,36,40,44,48,52,56,60);
+        *g = __builtin_shufflevector(v,v, 1, 5, 9,13,17,21,25,29,33,37,41,45,49,53,57,61);
+        *b = __builtin_shufflevector(v,v, 2, 6,10,14,18,22,26,30,34,38,42,46,50,54,58,62);
+        *a = __builtin_shufflevector(v,v, 3, 7,11,15,19,23,27,31,35,39,43,47,51,55,59,63);
+    }
+    SI void store4(uint16_t* ptr, size_t tail, U16 r, U16 g, U16 b, U16 a) {
+        Wide<uint16_t,32> rg = __builtin_shufflevector(r,g, 0,16, 1,17, 2,18, 3,19,
+                                                            4,20, 5,21, 6,22, 7,23,
+                                                            8,24, 9,25,10,26,11,27,
+                                                           12,28,13,29,14,30,15,31),
+                          ba = __builtin_shufflevector(b,a, 0,16, 1,17, 2,18, 3,19,
+                                                            4,20, 5,21, 6,22, 7,23,
+                                                            8,24, 9,25,10,26,11,27,
+                                                           12,28,13,29,14,30,15,31);
+        Wide<uint16_t,64> v = __builtin_shufflevector(rg,ba,  0, 1,32,33,  2, 3,34,35,
+                                                              4, 5,36,37,  6, 7,38,39,
+                                                              8, 9,40,41, 10,11,42,43,
+                                                             12,13,44,45, 14,15,46,47,
+                                                             16,17,48,49, 18,19,50,51,
+                                                             20,21,52,53, 22,23,54,55,
+                                                             24,25,56,57, 26,27,58,59,
+                                                             28,29,60,61, 30,31,62,63);
+        store_pixels(ptr, tail, 4*sizeof(uint16_t), v);
+    }
+
+    SI void load2(const float* ptr, size_t tail, F* r, F* g) {
+        auto v = load_pixels<Wide<float,32>>(ptr, tail, 2*sizeof(float));
+        *r = __builtin_shufflevector(v,v, 0, 2, 4, 6, 8,10,12,14,16,18,20,22,24,26,28,30);
+        *g = __builtin_shufflevector(v,v, 1, 3, 5, 7, 9,11,13,15,17,19,21,23,25,27,29,31);
+    }
+    SI void store2(float* ptr, size_t tail, F r, F g) {
+        Wide<float,32> v = __builtin_shufflevector(r,g, 0,16, 1,17, 2,18, 3,19,
+                                                        4,20, 5,21, 6,22, 7,23,
+                                                        8,24, 9,25,10,26,11,27,
+                                                       12,28,13,29,14,30,15,31);
+        store_pixels(ptr, tail, 2*sizeof(float), v);
+    }
+
+    SI void load4(const float* ptr, size_t tail, F* r, F* g, F* b, F* a) {
+        auto v = load_pixels<Wide<float,64>>(ptr, tail, 4*sizeof(float));
+        *r = __builtin_shufflevector(v,v, 0, 4, 8,12,16,20,24,28,32,36,40,44,48,52,56,60);
+        *g = __builtin_shufflevector(v,v, 1, 5, 9,13,17,21,25,29,33,37,41,45,49,53,57,61);
+        *b = __builtin_shufflevector(v,v, 2, 6,10,14,18,22,26,30,34,38,42,46,50,54,58,62);
+        *a = __builtin_shufflevector(v,v, 3, 7,11,15,19,23,27,31,35,39,43,47,51,55,59,63);
+    }
+    SI void store4(float* ptr, size_t tail, F r, F g, F b, F a) {
+        Wide<float,32> rg = __builtin_shufflevector(r,g, 0,16, 1,17, 2,18, 3,19,
+                                                         4,20, 5,21, 6,22, 7,23,
+                                                         8,24, 9,25,10,26,11,27,
+                                                        12,28,13,29,14,30,15,31),
+                       ba = __builtin_shufflevector(b,a, 0,16, 1,17, 2,18, 3,19,
+                                                         4,20, 5,21, 6,22, 7,23,
+                                                         8,24, 9,25,10,26,11,27,
+                                                        12,28,13,29,14,30,15,31);
+        Wide<float,64> v = __builtin_shufflevector(rg,ba,  0, 1,32,33,  2, 3,34,35,
+                                                           4, 5,36,37,  6, 7,38,39,
+                                                           8, 9,40,41, 10,11,42,43,
+                                                          12,13,44,45, 14,15,46,47,
+                                                          16,17,48,49, 18,19,50,51,
+                                                          20,21,52,53, 22,23,54,55,
+                                                          24,25,56,57, 26,27,58,59,
+                                                          28,29,60,61, 30,31,62,63);
+        store_pixels(ptr, tail, 4*sizeof(float), v);
+    }
+
+#elif defined(JUMPER_IS_HSW)
     // These are __m256 and __m256i, but friendlier and strongly-typed.
     template <typename T> using V = T __attribute__((ext_vector_type(8)));
     using F   = V<float   >;
@@ -1053,7 +1256,10 @@ SI F from_half(U16 h) {
     && !defined(SK_BUILD_FOR_GOOGLE3)  // Temporary workaround for some Google3 builds.
     return vcvt_f32_f16(h);
 
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#elif defined(JUMPER_IS_SKX)
+    return _mm512_cvtph_ps(h);
+
+#elif defined(JUMPER_IS_HSW)
     return _mm256_cvtph_ps(h);
 
 #else
@@ -1074,7 +1280,10 @@ SI U16 to_half(F f) {
     && !defined(SK_BUILD_FOR_GOOGLE3)  // Temporary workaround for some Google3 builds.
     return vcvt_f16_f32(f);
 
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#elif defined(JUMPER_IS_SKX)
+    return _mm512_cvtps_ph(f, _MM_FROUND_CUR_DIRECTION);
+
+#elif defined(JUMPER_IS_HSW)
     return _mm256_cvtps_ph(f, _MM_FROUND_CUR_DIRECTION);
 
 #else
@@ -1328,7 +1537,11 @@ static void start_pipeline(size_t dx, size_t dy,
 
 template <typename V, typename T>
 SI V load(const T* src, size_t tail) {
-#if !defined(JUMPER_IS_SCALAR)
+#if defined(JUMPER_IS_SKX)
+    if (__builtin_expect(tail, 0)) {
+        return load_masked<V>(src, tail*sizeof(T));  // Any inactive lanes are zeroed.
+    }
+#elif !defined(JUMPER_IS_SCALAR)
     __builtin_assume(tail < N);
     if (__builtin_expect(tail, 0)) {
         V v{};  // Any inactive lanes are zeroed.
@@ -1349,7 +1562,12 @@ SI V load(const T* src, size_t tail) {
 
 template <typename V, typename T>
 SI void store(T* dst, V v, size_t tail) {
-#if !defined(JUMPER_IS_SCALAR)
+#if defined(JUMPER_IS_SKX)
+    if (__builtin_expect(tail, 0)) {
+        store_masked(dst, tail*sizeof(T), v);
+        return;
+    }
+#elif !defined(JUMPER_IS_SCALAR)
     __builtin_assume(tail < N);
     if (__builtin_expect(tail, 0)) {
         switch (tail) {
@@ -1561,7 +1779,7 @@ STAGE(seed_shader, NoCtx) {
 
 STAGE(dither, const float* rate) {
     // Get [(dx,dy), (dx+1,dy), (dx+2,dy), ...] loaded up in integer vectors.
-    uint32_t iota[] = {0,1,2,3,4,5,6,7};
+    uint32_t iota[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15};
     U32 X = dx + sk_unaligned_load<U32>(iota),
         Y = dy;
 
@@ -2833,7 +3051,18 @@ STAGE(matrix_perspective, const float* m) {
 SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         F* r, F* g, F* b, F* a) {
     F fr, br, fg, bg, fb, bb, fa, ba;
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    if (c->stopCount <= 16) {
+        fr = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->fs[0]));
+        br = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->bs[0]));
+        fg = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->fs[1]));
+        bg = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->bs[1]));
+        fb = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->fs[2]));
+        bb = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->bs[2]));
+        fa = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->fs[3]));
+        ba = _mm512_permutexvar_ps(idx, _mm512_loadu_ps(c->bs[3]));
+    } else
+#elif defined(JUMPER_IS_HSW)
     if (c->stopCount <=8) {
         fr = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->fs[0]), idx);
         br = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->bs[0]), idx);
@@ -3115,7 +3344,7 @@ STAGE(callback, SkRasterPipeline_CallbackCtx* c) {
                                                     sk_bit_cast<I32>(db))
 
 STAGE_TAIL(init_lane_masks, NoCtx) {
-    uint32_t iota[] = {0,1,2,3,4,5,6,7};
+    uint32_t iota[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15};
     I32 mask = tail ? cond_to_mask(sk_unaligned_load<U32>(iota) < tail) : I32(~0);
     dr = dg = db = da = sk_bit_cast<F>(mask);
 }
@@ -3700,7 +3929,16 @@ namespace lowp {
 
 #else  // We are compiling vector code with Clang... let's make some lowp stages!
 
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    using U8  = uint8_t  __attribute__((ext_vector_type(32)));
+    using U16 = uint16_t __attribute__((ext_vector_type(32)));
+    using I16 =  int16_t __attribute__((ext_vector_type(32)));
+    using I32 =  int32_t __attribute__((ext_vector_type(32)));
+    using U32 = uint32_t __attribute__((ext_vector_type(32)));
+    using I64 =  int64_t __attribute__((ext_vector_type(32)));
+    using U64 = uint64_t __attribute__((ext_vector_type(32)));
+    using F   = float    __attribute__((ext_vector_type(32)));
+#elif defined(JUMPER_IS_HSW)
     using U8  = uint8_t  __attribute__((ext_vector_type(16)));
     using U16 = uint16_t __attribute__((ext_vector_type(16)));
     using I16 =  int16_t __attribute__((ext_vector_type(16)));
@@ -3973,7 +4211,11 @@ SI U32 trunc_(F x) { return (U32)cast<I32>(x); }
 
 // Use approximate instructions and one Newton-Raphson step to calculate 1/x.
 SI F rcp_precise(F x) {
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(SK_OPTS_NS::rcp_precise(lo), SK_OPTS_NS::rcp_precise(hi));
+#elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(SK_OPTS_NS::rcp_precise(lo), SK_OPTS_NS::rcp_precise(hi));
@@ -3990,7 +4232,11 @@ SI F rcp_precise(F x) {
 #endif
 }
 SI F sqrt_(F x) {
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(_mm512_sqrt_ps(lo), _mm512_sqrt_ps(hi));
+#elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(_mm256_sqrt_ps(lo), _mm256_sqrt_ps(hi));
@@ -4025,7 +4271,12 @@ SI F floor_(F x) {
     float32x4_t lo,hi;
     split(x, &lo,&hi);
     return join<F>(vrndmq_f32(lo), vrndmq_f32(hi));
-#elif defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#elif defined(JUMPER_IS_SKX)
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(_mm512_roundscale_ps(lo, _MM_FROUND_TO_NEG_INF),
+                   _mm512_roundscale_ps(hi, _MM_FROUND_TO_NEG_INF));
+#elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(_mm256_floor_ps(lo), _mm256_floor_ps(hi));
@@ -4045,7 +4296,9 @@ SI F floor_(F x) {
 // The result is a number on [-1, 1).
 // Note: on neon this is a saturating multiply while the others are not.
 SI I16 scaled_mult(I16 a, I16 b) {
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    return _mm512_mulhrs_epi16(a, b);
+#elif defined(JUMPER_IS_HSW)
     return _mm256_mulhrs_epi16(a, b);
 #elif defined(JUMPER_IS_SSE41) || defined(JUMPER_IS_AVX)
     return _mm_mulhrs_epi16(a, b);
@@ -4084,8 +4337,10 @@ SI F abs_(F x) { return sk_bit_cast<F>( sk_bit_cast<I32>(x) & 0x7fffffff ); }
 
 STAGE_GG(seed_shader, NoCtx) {
     static const float iota[] = {
-        0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f,
-        8.5f, 9.5f,10.5f,11.5f,12.5f,13.5f,14.5f,15.5f,
+         0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f,
+         8.5f, 9.5f,10.5f,11.5f,12.5f,13.5f,14.5f,15.5f,
+        16.5f,17.5f,18.5f,19.5f,20.5f,21.5f,22.5f,23.5f,
+        24.5f,25.5f,26.5f,27.5f,28.5f,29.5f,30.5f,31.5f,
     };
     x = cast<F>(I32(dx)) + sk_unaligned_load<F>(iota);
     y = cast<F>(I32(dy)) + 0.5f;
@@ -4298,6 +4553,11 @@ SI U32 ix_and_ptr(T** ptr, const SkRasterPipeline_GatherCtx* ctx, I32 x, I32 y)
 
 template <typename V, typename T>
 SI V load(const T* ptr, size_t tail) {
+#if defined(JUMPER_IS_SKX)
+    if (__builtin_expect(tail, 0)) {
+        return SK_OPTS_NS::load_masked<V>(ptr, tail*sizeof(T));
+    }
+#endif
     V v = 0;
     switch (tail & (N-1)) {
         case  0: memcpy(&v, ptr, sizeof(v)); break;
@@ -4323,6 +4583,12 @@ SI V load(const T* ptr, size_t tail) {
 }
 template <typename V, typename T>
 SI void store(T* ptr, size_t tail, V v) {
+#if defined(JUMPER_IS_SKX)
+    if (__builtin_expect(tail, 0)) {
+        SK_OPTS_NS::store_masked(ptr, tail*sizeof(T), v);
+        return;
+    }
+#endif
     switch (tail & (N-1)) {
         case  0: memcpy(ptr, &v, sizeof(v)); break;
     #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
@@ -4345,7 +4611,37 @@ SI void store(T* ptr, size_t tail, V v) {
     }
 }
 
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    template <typename V, typename T>
+    SI V gather(const T* ptr, U32 ix) {
+        return V{ ptr[ix[ 0]], ptr[ix[ 1]], ptr[ix[ 2]], ptr[ix[ 3]],
+                  ptr[ix[ 4]], ptr[ix[ 5]], ptr[ix[ 6]], ptr[ix[ 7]],
+                  ptr[ix[ 8]], ptr[ix[ 9]], ptr[ix[10]], ptr[ix[11]],
+                  ptr[ix[12]], ptr[ix[13]], ptr[ix[14]], ptr[ix[15]],
+                  ptr[ix[16]], ptr[ix[17]], ptr[ix[18]], ptr[ix[19]],
+                  ptr[ix[20]], ptr[ix[21]], ptr[ix[22]], ptr[ix[23]],
+                  ptr[ix[24]], ptr[ix[25]], ptr[ix[26]], ptr[ix[27]],
+                  ptr[ix[28]], ptr[ix[29]], ptr[ix[30]], ptr[ix[31]], };
+    }
+
+    template<>
+    F gather(const float* ptr, U32 ix) {
+        __m512i lo, hi;
+        split(ix, &lo, &hi);
+
+        return join<F>(_mm512_i32gather_ps(lo, ptr, 4),
+                       _mm512_i32gather_ps(hi, ptr, 4));
+    }
+
+    template<>
+    U32 gather(const uint32_t* ptr, U32 ix) {
+        __m512i lo, hi;
+        split(ix, &lo, &hi);
+
+        return join<U32>(_mm512_i32gather_epi32(lo, ptr, 4),
+                         _mm512_i32gather_epi32(hi, ptr, 4));
+    }
+#elif defined(JUMPER_IS_HSW)
     template <typename V, typename T>
     SI V gather(const T* ptr, U32 ix) {
         return V{ ptr[ix[ 0]], ptr[ix[ 1]], ptr[ix[ 2]], ptr[ix[ 3]],
@@ -4383,7 +4679,14 @@ SI void store(T* ptr, size_t tail, V v) {
 // ~~~~~~ 32-bit memory loads and stores ~~~~~~ //
 
 SI void from_8888(U32 rgba, U16* r, U16* g, U16* b, U16* a) {
-#if 1 && defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if 1 && defined(JUMPER_IS_SKX)
+    // _mm512_cvtepi32_epi16() keeps lanes in order, so there's no shuffling to do here.
+    auto cast_U16 = [](U32 v) -> U16 {
+        __m512i lo,hi;
+        split(v, &lo,&hi);
+        return join<U16>(_mm512_cvtepi32_epi16(lo), _mm512_cvtepi32_epi16(hi));
+    };
+#elif 1 && defined(JUMPER_IS_HSW)
     // Swap the middle 128-bit lanes to make _mm256_packus_epi32() in cast_U16() work out nicely.
     __m256i _01,_23;
     split(rgba, &_01, &_23);
@@ -4860,7 +5163,29 @@ SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         U16* r, U16* g, U16* b, U16* a) {
 
     F fr, fg, fb, fa, br, bg, bb, ba;
-#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
+#if defined(JUMPER_IS_SKX)
+    if (c->stopCount <= 16) {
+        __m512i lo, hi;
+        split(idx, &lo, &hi);
+
+        fr = join<F>(_mm512_permutexvar_ps(lo, _mm512_loadu_ps(c->fs[0])),
+                     _mm512_permutexvar_ps(hi, _mm512_loadu_ps(c->fs[0])));
+        br = join<F>(_mm512_permutexvar_ps(lo, _mm512_loadu_ps(c->bs[0])),
+                     _mm512_permutexvar_ps(hi, _mm512_loadu_ps(c->bs[0])));
+        fg = join<F>(_mm512_permutexvar_ps(lo, _mm512_loadu_ps(c->fs[1])),
+                     _mm512_permutexvar_ps(hi, _mm512_loadu_ps(c->fs[1])));
+        bg = join<F>(_mm512_permutexvar_ps(lo, _mm512_loadu_ps(c->bs[1])),
+                     _mm512_permutexvar_ps(hi, _mm512_loadu_ps(c->bs[1])));
+        fb = join<F>(_mm512_permutexvar_ps(lo, _mm512_loadu_ps(c->fs[2])),
+                     _mm512_permutexvar_ps(hi, _mm512_loadu_ps(c->fs[2])));
+        bb = join<F>(_mm512_permutexvar_ps(lo, _mm512_loadu_ps(c->bs[2])),
+                     _mm512_permutexvar_ps(hi, _mm512_loadu_ps(c->bs[2])));
+        fa = join<F>(_mm512_permutexvar_ps(lo, _mm512_loadu_ps(c->fs[3])),
+                     _mm512_permutexvar_ps(hi, _mm512_loadu_ps(c->fs[3])));
+        ba = join<F>(_mm512_permutexvar_ps(lo, _mm512_loadu_ps(c->bs[3])),
+                     _mm512_permutexvar_ps(hi, _mm512_loadu_ps(c->bs[3])));
+    } else
+#elif defined(JUMPER_IS_HSW)
     if (c->stopCount <=8) {
         __m256i lo, hi;
         split(idx, &lo, &hi);
@@ -10,6 +10,8 @@
 
 #include "include/private/SkColorData.h"
 #include "include/private/SkVx.h"
+#include <algorithm>
+#include <cstring>
 #include <utility>
 
 #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
@@ -1384,6 +1386,151 @@ static void RGB_to_BGR1_portable(uint32_t dst[], const uint8_t* src, int count)
     }
 #endif
 
+// 16-bit components are big-endian, so the high byte we keep comes first. Loaded as
+// little-endian uint16_t lanes, that is the low byte of each lane, and a narrowing cast keeps it.
+// The 8-bit results then go through the swizzles above.
+static void strip_16_to_8(uint8_t dst[], const uint8_t* src, int components) {
+    while (components >= 16) {
+        skvx::cast<uint8_t>(skvx::Vec<16, uint16_t>::Load(src)).store(dst);
+        src += 2*16;
+        dst += 16;
+        components -= 16;
+    }
+    for (int i = 0; i < components; i++) {
+        dst[i] = src[2*i];
+    }
+}
+
+static void RGB16_to(void (*proc)(uint32_t[], const uint8_t*, int),
+                     uint32_t dst[], const uint8_t* src, int count) {
+    // RGB can't be stripped in place into 8888, so strip a few pixels at a time to the stack.
+    constexpr int kStride = 64;
+    uint8_t rgb[3*kStride];
+    while (count > 0) {
+        const int n = std::min(count, kStride);
+        strip_16_to_8(rgb, src, 3*n);
+        proc(dst, rgb, n);
+        src += 6*n;
+        dst += n;
+        count -= n;
+    }
+}
+
+/*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+    RGB16_to(RGB_to_RGB1, dst, src, count);
+}
+
+/*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+    RGB16_to(RGB_to_BGR1, dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const uint8_t* src, int count) {
+    strip_16_to_8((uint8_t*)dst, src, 4*count);
+}
+
+/*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const uint8_t* src, int count) {
+    strip_16_to_8((uint8_t*)dst, src, 4*count);
+    RGBA_to_BGRA(dst, dst, count);
+}
+
+/*not static*/ inline void RGBA16_to_rgbA(uint32_t dst[], const uint8_t* src, int count) {
+    strip_16_to_8((uint8_t*)dst, src, 4*count);
+    RGBA_to_rgbA(dst, dst, count);
+}
+
+/*not static*/ inline void RGBA16_to_bgrA(uint32_t dst[], const uint8_t* src, int count) {
+    strip_16_to_8((uint8_t*)dst, src, 4*count);
+    RGBA_to_bgrA(dst, dst, count);
+}
+
+static void index_to_8888_portable(uint32_t dst[], const uint8_t* src, int count,
+                                   const uint32_t ctable[]) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = ctable[src[i]];
+    }
+}
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    /*not static*/ inline void index_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                                             const uint32_t ctable[]) {
+        while (count >= 8) {
+            __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) src));
+            _mm256_storeu_si256((__m256i*) dst,
+                                _mm256_i32gather_epi32((const int*) ctable, indices, 4));
+            src += 8;
+            dst += 8;
+            count -= 8;
+        }
+        index_to_8888_portable(dst, src, count, ctable);
+    }
+#else
+    // Without a gather instruction, SSSE3 and NEON do no better than scalar loads.
+    /*not static*/ inline void index_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                                             const uint32_t ctable[]) {
+        index_to_8888_portable(dst, src, count, ctable);
+    }
+#endif
+
+// Each channel is (p & mask) >> shift, a value of size bits. We scale it to 8 bits in float,
+// which rounds exactly as SkMasks' lookup table does: c*255/(2^size - 1) is never within
+// 1/255 of a half.
+template <typename T>
+static void bitfields_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                              const uint32_t masks[4], uint32_t fill) {
+    int   shift[4];
+    float scale[4];
+    for (int c = 0; c < 4; c++) {
+        shift[c] = 0;
+        scale[c] = 0;
+        if (masks[c]) {
+            uint32_t m = masks[c];
+            for (; (m & 1) == 0; m >>= 1) {
+                shift[c]++;
+            }
+            int size = 0;
+            for (; m; m >>= 1) {
+                size++;
+            }
+            SkASSERT(size <= 8);
+            scale[c] = 255.0f / ((1 << size) - 1);
+        }
+    }
+
+    using U32 = skvx::Vec<8, uint32_t>;
+    using F   = skvx::Vec<8, float>;
+    while (count >= 8) {
+        U32 p = skvx::cast<uint32_t>(skvx::Vec<8, T>::Load(src)),
+            px = fill;
+        for (int c = 0; c < 4; c++) {
+            F v = skvx::cast<float>(skvx::cast<int>((p & masks[c]) >> shift[c]));
+            px |= skvx::cast<uint32_t>(skvx::cast<int>(v * scale[c] + 0.5f)) << (8*c);
+        }
+        px.store(dst);
+        src += 8*sizeof(T);
+        dst += 8;
+        count -= 8;
+    }
+    for (int i = 0; i < count; i++) {
+        T p;
+        memcpy(&p, src + i*sizeof(T), sizeof(T));
+        uint32_t px = fill;
+        for (int c = 0; c < 4; c++) {
+            float v = (float)(int)((p & masks[c]) >> shift[c]);
+            px |= (uint32_t)(int)(v * scale[c] + 0.5f) << (8*c);
+        }
+        dst[i] = px;
+    }
+}
+
+/*not static*/ inline void bitfields16_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                                               const uint32_t masks[4], uint32_t fill) {
+    bitfields_to_8888<uint16_t>(dst, src, count, masks, fill);
+}
+
+/*not static*/ inline void bitfields32_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                                               const uint32_t masks[4], uint32_t fill) {
+    bitfields_to_8888<uint32_t>(dst, src, count, masks, fill);
+}
+
 }  // namespace SK_OPTS_NS
 
 #endif // SkSwizzler_opts_DEFINED
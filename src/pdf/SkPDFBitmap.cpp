@@ -21,6 +21,7 @@
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFTypes.h"
 #include "src/pdf/SkPDFUtils.h"
+#include "src/pdf/SkPngInfo.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -68,7 +69,8 @@ static SkColor get_neighbor_avg_color(const SkPixmap& bm, int xOrig, int yOrig)
 }
 
 namespace {
-enum class SkPDFStreamFormat { DCT, Flate, Uncompressed };
+// PNG is Flate, with a PNG predictor on each row.
+enum class SkPDFStreamFormat { DCT, Flate, PNG, Uncompressed };
 }
 
 template <typename T>
@@ -95,6 +97,7 @@ static void emit_image_stream(SkPDFDocument* doc,
     switch (format) {
         case SkPDFStreamFormat::DCT: filters->appendName("DCTDecode"); break;
         case SkPDFStreamFormat::Flate: filters->appendName("FlateDecode"); break;
+        case SkPDFStreamFormat::PNG: SkUNREACHABLE;  // do_png() does not pass PNGs through.
         case SkPDFStreamFormat::Uncompressed: break;
     }
     pdfDict.insertObject("Filter", std::move(filters));
@@ -102,12 +105,21 @@ static void emit_image_stream(SkPDFDocument* doc,
     switch (format) {
         case SkPDFStreamFormat::DCT: pdfDict.insertName("Filter", "DCTDecode"); break;
         case SkPDFStreamFormat::Flate: pdfDict.insertName("Filter", "FlateDecode"); break;
+        case SkPDFStreamFormat::PNG: pdfDict.insertName("Filter", "FlateDecode"); break;
         case SkPDFStreamFormat::Uncompressed: break;
     }
     #endif
     if (format == SkPDFStreamFormat::DCT) {
         pdfDict.insertInt("ColorTransform", 0);
     }
+    if (format == SkPDFStreamFormat::PNG) {
+        auto decodeParms = SkPDFMakeDict();
+        decodeParms->insertInt("Predictor", 15);  // Each row says which PNG filter it uses.
+        decodeParms->insertInt("Colors", strcmp(colorSpace, "DeviceRGB") == 0 ? 3 : 1);
+        decodeParms->insertInt("BitsPerComponent", 8);
+        decodeParms->insertInt("Columns", size.width());
+        pdfDict.insertObject("DecodeParms", std::move(decodeParms));
+    }
     pdfDict.insertInt("Length", length);
     doc->emitStream(pdfDict, std::move(writeStream), ref);
 }
@@ -258,6 +270,27 @@ static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
     return true;
 }
 
+static bool do_png(const SkData& data, SkPDFDocument* doc, SkISize size,
+                   SkPDFIndirectReference ref) {
+    #ifdef SK_PDF_BASE85_BINARY
+    // The ASCII85Decode filter would need a null entry in /DecodeParms.
+    return false;
+    #else
+    SkISize pngSize;
+    int colors;
+    SkDynamicMemoryWStream idat;
+    if (!SkGetPngInfo(data.data(), data.size(), &pngSize, &colors, &idat)
+            || pngSize != size) {  // Safety check.
+        return false;
+    }
+    int length = SkToInt(idat.bytesWritten());
+    emit_image_stream(doc, ref, [&idat](SkWStream* dst) { idat.writeToAndReset(dst); },
+                      pngSize, colors == 3 ? "DeviceRGB" : "DeviceGray",
+                      SkPDFIndirectReference(), length, SkPDFStreamFormat::PNG);
+    return true;
+    #endif
+}
+
 static SkBitmap to_pixels(const SkImage* image) {
     SkBitmap bm;
     int w = image->width(),
@@ -291,7 +324,8 @@ void serialize_image(const SkImage* img,
     SkASSERT(encodingQuality >= 0);
     SkISize dimensions = img->dimensions();
     if (sk_sp<SkData> data = img->refEncodedData()) {
-        if (do_jpeg(std::move(data), doc, dimensions, ref)) {
+        // Pass JPEGs and PNGs through instead of decoding and compressing them again.
+        if (do_jpeg(data, doc, dimensions, ref) || do_png(*data, doc, dimensions, ref)) {
             return;
         }
     }
@@ -308,6 +342,30 @@ void serialize_image(const SkImage* img,
     do_deflated_image(pm, doc, isOpaque, ref);
 }
 
+bool SkPDFHashImage(const SkImage* img, SkMD5::Digest* digest) {
+    SkASSERT(img);
+    SkMD5 md5;
+    SkPixmap pm;
+    if (sk_sp<SkData> data = img->refEncodedData()) {
+        // Only whole images, not subsets of them, have their encoded data.
+        md5.write("E", 1);
+        md5.write(data->data(), data->size());
+    } else if (img->peekPixels(&pm)) {
+        const SkImageInfo& info = pm.info();
+        const int32_t header[] = {info.width(), info.height(),
+                                  info.colorType(), info.alphaType()};
+        md5.write("P", 1);
+        md5.write(header, sizeof(header));
+        for (int y = 0; y < pm.height(); ++y) {
+            md5.write(pm.addr(0, y), info.minRowBytes());
+        }
+    } else {
+        return false;
+    }
+    *digest = md5.finish();
+    return true;
+}
+
 SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
                                            SkPDFDocument* doc,
                                            int encodingQuality) {
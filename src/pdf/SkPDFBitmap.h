@@ -7,6 +7,8 @@
 #ifndef SkPDFBitmap_DEFINED
 #define SkPDFBitmap_DEFINED
 
+#include "src/core/SkMD5.h"
+
 class SkImage;
 class SkPDFDocument;
 struct SkPDFIndirectReference;
@@ -19,4 +21,11 @@ SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
                                            SkPDFDocument* doc,
                                            int encodingQuality = 101);
 
+/**
+ * If the image's pixels can be hashed without decoding it, from its encoded data or its raster
+ * pixels, sets digest to their hash and returns true.  Images with the same digest serialize
+ * to the same Image XObject.
+ */
+bool SkPDFHashImage(const SkImage* img, SkMD5::Digest* digest);
+
 #endif  // SkPDFBitmap_DEFINED
@@ -333,7 +333,7 @@ void SkPDFDevice::reset() {
 }
 
 void SkPDFDevice::drawAnnotation(const SkRect& rect, const char key[], SkData* value) {
-    if (!value) {
+    if (!value || SkPDFDrawAhead::Miss()) {
         return;
     }
     // Annotations are specified in absolute coordinates, so the page xform maps from device space
@@ -553,6 +553,9 @@ void SkPDFDevice::clearMaskOnGraphicState(SkDynamicMemoryWStream* contentStream)
     // The no-softmask graphic state is used to "turn off" the mask for later draw calls.
     SkPDFIndirectReference& noSMaskGS = fDocument->fNoSmaskGraphicState;
     if (!noSMaskGS) {
+        if (SkPDFDrawAhead::Miss()) {
+            return;
+        }
         SkPDFDict tmp("ExtGState");
         tmp.insertName("SMask", "None");
         noSMaskGS = fDocument->emit(tmp);
@@ -881,6 +884,7 @@ void SkPDFDevice::internalDrawGlyphRun(
     SK_AT_SCOPE_EXIT(if (clusterator.reversedChars()) { out->writeText("EMC\n"); } );
     GlyphPositioner glyphPositioner(out, glyphRunFont.getSkewX(), offset);
     SkPDFFont* font = nullptr;
+    SkPDFDrawAhead* drawAhead = SkPDFDrawAhead::Current();
 
     SkBulkGlyphMetricsAndPaths paths{strikeSpec};
     auto glyphs = paths.glyphs(glyphRun.glyphsIDs());
@@ -936,7 +940,10 @@ void SkPDFDevice::internalDrawGlyphRun(
             if (needs_new_font(font, glyphs[index], fontType)) {
                 // Not yet specified font or need to switch font.
                 font = SkPDFFont::GetFontResource(fDocument, glyphs[index], typeface);
-                SkASSERT(font);  // All preconditions for SkPDFFont::GetFontResource are met.
+                if (!font) {
+                    SkASSERT(drawAhead);  // Otherwise all its preconditions are met.
+                    return;
+                }
                 glyphPositioner.setFont(font);
                 SkPDFWriteResourceName(out, SkPDFResourceType::kFont,
                                        add_resource(fFontResources, font->indirectReference()));
@@ -945,7 +952,11 @@ void SkPDFDevice::internalDrawGlyphRun(
                 out->writeText(" Tf\n");
 
             }
-            font->noteGlyphUsage(gid);
+            if (drawAhead) {
+                drawAhead->noteGlyphUsage(*font, gid);
+            } else {
+                font->noteGlyphUsage(gid);
+            }
             SkGlyphID encodedGlyph = font->glyphToPDFFontEncoding(gid);
             SkScalar advance = advanceScale * glyphs[index]->advanceX();
             glyphPositioner.writeGlyph(encodedGlyph, advance, xy);
@@ -1680,10 +1691,27 @@ void SkPDFDevice::internalDrawImageRect(SkKeyedImage imageSubset,
     SkPDFIndirectReference pdfimage = pdfimagePtr ? *pdfimagePtr : SkPDFIndirectReference();
     if (!pdfimagePtr) {
         SkASSERT(imageSubset);
-        pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
-                                       fDocument->metadata().fEncodingQuality);
+        SkMD5::Digest digest;
+        const bool hashed = fDocument->metadata().fDeduplicateByContent &&
+                            SkPDFHashImage(imageSubset.image().get(), &digest);
+        SkPDFIndirectReference* samePixels =
+                hashed ? fDocument->fPDFImageDigestMap.find(digest) : nullptr;
+        if (samePixels) {
+            pdfimage = *samePixels;
+        } else {
+            if (SkPDFDrawAhead::Miss()) {
+                return;
+            }
+            pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
+                                           fDocument->metadata().fEncodingQuality);
+            if (hashed) {
+                fDocument->fPDFImageDigestMap.set(digest, pdfimage);
+            }
+        }
         SkASSERT((key != SkBitmapKey{{0, 0, 0, 0}, 0}));
-        fDocument->fPDFBitmapMap.set(key, pdfimage);
+        if (!SkPDFDrawAhead::Current()) {
+            fDocument->fPDFBitmapMap.set(key, pdfimage);
+        }
     }
     SkASSERT(pdfimage != SkPDFIndirectReference());
     this->drawFormXObject(pdfimage, content.stream());
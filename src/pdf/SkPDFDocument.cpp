@@ -8,9 +8,12 @@
 #include "include/docs/SkPDFDocument.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 
+#include "include/core/SkPicture.h"
 #include "include/core/SkStream.h"
 #include "include/docs/SkPDFDocument.h"
 #include "include/private/base/SkTo.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkPDFDevice.h"
 #include "src/pdf/SkPDFFont.h"
 #include "src/pdf/SkPDFGradientShader.h"
@@ -20,6 +23,7 @@
 #include "src/pdf/SkPDFUtils.h"
 #include "src/utils/SkUTF.h"
 
+#include <algorithm>
 #include <utility>
 
 // For use in SkCanvas::drawAnnotation
@@ -52,23 +56,44 @@ static SkString ToValidUtf8String(const SkData& d) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static thread_local SkPDFDrawAhead* gCurrentDrawAhead = nullptr;
+
+SkPDFDrawAhead* SkPDFDrawAhead::Current() { return gCurrentDrawAhead; }
+
+void SkPDFDrawAhead::noteGlyphUsage(const SkPDFFont& font, SkGlyphID glyph) {
+    fGlyphUsage.push_back({font.indirectReference(), glyph});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void SkPDFOffsetMap::markStartOfDocument(const SkWStream* s) { fBaseOffset = s->bytesWritten(); }
 
 static size_t difference(size_t minuend, size_t subtrahend) {
     return SkASSERT(minuend >= subtrahend), minuend - subtrahend;
 }
 
-void SkPDFOffsetMap::markStartOfObject(int referenceNumber, const SkWStream* s) {
+SkPDFOffsetMap::Location* SkPDFOffsetMap::location(int referenceNumber) {
     SkASSERT(referenceNumber > 0);
     size_t index = SkToSizeT(referenceNumber - 1);
-    if (index >= fOffsets.size()) {
-        fOffsets.resize(index + 1);
+    if (index >= fLocations.size()) {
+        fLocations.resize(index + 1);
     }
-    fOffsets[index] = SkToInt(difference(s->bytesWritten(), fBaseOffset));
+    return &fLocations[index];
+}
+
+void SkPDFOffsetMap::markStartOfObject(int referenceNumber, const SkWStream* s) {
+    this->location(referenceNumber)->fOffset = SkToInt(difference(s->bytesWritten(), fBaseOffset));
+}
+
+void SkPDFOffsetMap::markObjectInStream(int referenceNumber, int streamNumber, int index) {
+    SkASSERT(streamNumber > 0);
+    Location* location = this->location(referenceNumber);
+    location->fStream = streamNumber;
+    location->fIndex = index;
 }
 
 int SkPDFOffsetMap::objectCount() const {
-    return SkToInt(fOffsets.size() + 1); // Include the special zeroth object in the count.
+    return SkToInt(fLocations.size() + 1); // Include the special zeroth object in the count.
 }
 
 int SkPDFOffsetMap::emitCrossReferenceTable(SkWStream* s) const {
@@ -76,13 +101,71 @@ int SkPDFOffsetMap::emitCrossReferenceTable(SkWStream* s) const {
     s->writeText("xref\n0 ");
     s->writeDecAsText(this->objectCount());
     s->writeText("\n0000000000 65535 f \n");
-    for (int offset : fOffsets) {
-        SkASSERT(offset > 0);  // Offset was set.
-        s->writeBigDecAsText(offset, 10);
+    for (const Location& location : fLocations) {
+        SkASSERT(location.fOffset > 0);  // Offset was set.
+        SkASSERT(location.fStream == 0);
+        s->writeBigDecAsText(location.fOffset, 10);
         s->writeText(" 00000 n \n");
     }
     return xRefFileOffset;
 }
+
+int SkPDFOffsetMap::emitCrossReferenceStream(SkWStream* s,
+                                             SkPDFIndirectReference ref,
+                                             SkPDFDict* trailer,
+                                             SkPDF::Metadata::CompressionLevel compression) {
+    this->markStartOfObject(ref.fValue, s);
+    int xRefFileOffset = this->location(ref.fValue)->fOffset;
+
+    // Each entry is a 1 byte type, a 4 byte offset or object stream number, and a 2 byte
+    // generation number or index, all big-endian.
+    static constexpr int kWidths[] = {1, 4, 2};
+    SkDynamicMemoryWStream entries;
+    auto writeEntry = [&entries](uint8_t type, uint32_t field2, uint16_t field3) {
+        uint8_t entry[] = {type,
+                           (uint8_t)(field2 >> 24), (uint8_t)(field2 >> 16),
+                           (uint8_t)(field2 >>  8), (uint8_t)(field2 >>  0),
+                           (uint8_t)(field3 >>  8), (uint8_t)(field3 >>  0)};
+        static_assert(sizeof(entry) == kWidths[0] + kWidths[1] + kWidths[2], "");
+        entries.write(entry, sizeof(entry));
+    };
+    writeEntry(0, 0, 65535);
+    for (const Location& location : fLocations) {
+        if (location.fStream != 0) {
+            writeEntry(2, SkToU32(location.fStream), SkToU16(location.fIndex));
+        } else {
+            SkASSERT(location.fOffset > 0);  // Offset was set.
+            writeEntry(1, SkToU32(location.fOffset), 0);
+        }
+    }
+
+    std::unique_ptr<SkStreamAsset> data = entries.detachAsStream();
+    if (compression != SkPDF::Metadata::CompressionLevel::None) {
+        SkDynamicMemoryWStream compressed;
+        {
+            SkDeflateWStream deflate(&compressed, SkToInt(compression));
+            deflate.writeStream(data.get(), data->getLength());
+        }
+        data = compressed.detachAsStream();
+        trailer->insertName("Filter", "FlateDecode");
+    }
+    auto widths = SkPDFMakeArray();
+    for (int width : kWidths) {
+        widths->appendInt(width);
+    }
+    trailer->insertName("Type", "XRef");
+    trailer->insertInt("Size", this->objectCount());
+    trailer->insertObject("W", std::move(widths));
+    trailer->insertInt("Length", data->getLength());
+
+    s->writeDecAsText(ref.fValue);
+    s->writeText(" 0 obj\n");
+    trailer->emitObject(s);
+    s->writeText(" stream\n");
+    s->writeStream(data.get(), data->getLength());
+    s->writeText("\nendstream\nendobj\n");
+    return xRefFileOffset;
+}
 //
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -93,9 +176,11 @@ static_assert((SKPDF_MAGIC[1] & 0x7F) == "Skia"[1], "");
 static_assert((SKPDF_MAGIC[2] & 0x7F) == "Skia"[2], "");
 static_assert((SKPDF_MAGIC[3] & 0x7F) == "Skia"[3], "");
 #endif
-static void serializeHeader(SkPDFOffsetMap* offsetMap, SkWStream* wStream) {
+static void serializeHeader(SkPDFOffsetMap* offsetMap, SkWStream* wStream, bool objectStreams) {
     offsetMap->markStartOfDocument(wStream);
-    wStream->writeText("%PDF-1.4\n%" SKPDF_MAGIC "\n");
+    // Object streams and cross-reference streams are new in PDF 1.5.
+    wStream->writeText(objectStreams ? "%PDF-1.5\n%" SKPDF_MAGIC "\n"
+                                     : "%PDF-1.4\n%" SKPDF_MAGIC "\n");
     // The PDF spec recommends including a comment with four
     // bytes, all with their high bits set.  "\xD3\xEB\xE9\xE1" is
     // "Skia" with the high bits set.
@@ -112,15 +197,18 @@ static void begin_indirect_object(SkPDFOffsetMap* offsetMap,
 
 static void end_indirect_object(SkWStream* s) { s->writeText("\nendobj\n"); }
 
-// Xref table and footer
-static void serialize_footer(const SkPDFOffsetMap& offsetMap,
+// Xref table or stream, and footer
+static void serialize_footer(SkPDFOffsetMap* offsetMap,
                              SkWStream* wStream,
                              SkPDFIndirectReference infoDict,
                              SkPDFIndirectReference docCatalog,
-                             SkUUID uuid) {
-    int xRefFileOffset = offsetMap.emitCrossReferenceTable(wStream);
+                             SkUUID uuid,
+                             SkPDFIndirectReference xRefStream,
+                             SkPDF::Metadata::CompressionLevel compression) {
     SkPDFDict trailerDict;
-    trailerDict.insertInt("Size", offsetMap.objectCount());
+    if (xRefStream == SkPDFIndirectReference()) {
+        trailerDict.insertInt("Size", offsetMap->objectCount());
+    }
     SkASSERT(docCatalog != SkPDFIndirectReference());
     trailerDict.insertRef("Root", docCatalog);
     SkASSERT(infoDict != SkPDFIndirectReference());
@@ -128,9 +216,18 @@ static void serialize_footer(const SkPDFOffsetMap& offsetMap,
     if (SkUUID() != uuid) {
         trailerDict.insertObject("ID", SkPDFMetadata::MakePdfId(uuid, uuid));
     }
-    wStream->writeText("trailer\n");
-    trailerDict.emitObject(wStream);
-    wStream->writeText("\nstartxref\n");
+    int xRefFileOffset;
+    if (xRefStream != SkPDFIndirectReference()) {
+        // The cross-reference stream's dictionary holds the trailer's entries.
+        xRefFileOffset =
+                offsetMap->emitCrossReferenceStream(wStream, xRefStream, &trailerDict, compression);
+        wStream->writeText("startxref\n");
+    } else {
+        xRefFileOffset = offsetMap->emitCrossReferenceTable(wStream);
+        wStream->writeText("trailer\n");
+        trailerDict.emitObject(wStream);
+        wStream->writeText("\nstartxref\n");
+    }
     wStream->writeBigDecAsText(xRefFileOffset);
     wStream->writeText("\n%%EOF");
 }
@@ -228,12 +325,57 @@ SkPDFDocument::~SkPDFDocument() {
 }
 
 SkPDFIndirectReference SkPDFDocument::emit(const SkPDFObject& object, SkPDFIndirectReference ref){
+    if (SkPDFDrawAhead::Miss()) {
+        return ref;
+    }
+    if (fMetadata.fObjectStreams) {
+        SkDynamicMemoryWStream buffer;
+        object.emitObject(&buffer);
+        std::unique_ptr<SkPDFObjectStream> full;
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            if (!fObjectStream) {
+                fObjectStream = std::make_unique<SkPDFObjectStream>();
+            }
+            SkPDFObjectStream* objects = fObjectStream.get();
+            objects->fNumbers.push_back(ref.fValue);
+            objects->fHeader.writeDecAsText(ref.fValue);
+            objects->fHeader.writeText(" ");
+            objects->fHeader.writeBigDecAsText(objects->fObjects.bytesWritten());
+            objects->fHeader.writeText("\n");
+            buffer.writeToAndReset(&objects->fObjects);
+            objects->fObjects.writeText("\n");
+            // Readers load a whole object stream to find one object in it, so keep them small.
+            static constexpr size_t kMaxObjectsPerStream = 100;
+            if (objects->fNumbers.size() == kMaxObjectsPerStream) {
+                full = std::move(fObjectStream);
+            }
+        }
+        if (full) {
+            this->emitObjectStream(std::move(full));
+        }
+        return ref;
+    }
     SkAutoMutexExclusive lock(fMutex);
     object.emitObject(this->beginObject(ref));
     this->endObject();
     return ref;
 }
 
+void SkPDFDocument::emitObjectStream(std::unique_ptr<SkPDFObjectStream> objects) {
+    auto dict = SkPDFMakeDict("ObjStm");
+    dict->insertInt("N", SkToInt(objects->fNumbers.size()));
+    dict->insertInt("First", SkToInt(objects->fHeader.bytesWritten()));
+    objects->fObjects.writeToAndReset(&objects->fHeader);
+    SkPDFIndirectReference stream =
+            SkPDFStreamOut(std::move(dict), objects->fHeader.detachAsStream(), this);
+
+    SkAutoMutexExclusive lock(fMutex);
+    for (size_t i = 0; i < objects->fNumbers.size(); ++i) {
+        fOffsetMap.markObjectInStream(objects->fNumbers[i], stream.fValue, SkToInt(i));
+    }
+}
+
 SkWStream* SkPDFDocument::beginObject(SkPDFIndirectReference ref) SK_REQUIRES(fMutex) {
     begin_indirect_object(&fOffsetMap, ref, this->getStream());
     return this->getStream();
@@ -246,13 +388,34 @@ void SkPDFDocument::endObject() SK_REQUIRES(fMutex) {
 static SkSize operator*(SkISize u, SkScalar s) { return SkSize{u.width() * s, u.height() * s}; }
 static SkSize operator*(SkSize u, SkScalar s) { return SkSize{u.width() * s, u.height() * s}; }
 
+sk_sp<SkPDFDevice> SkPDFDocument::makePageDevice(SkScalar width, SkScalar height) const {
+    // By scaling the page at the device level, we will create bitmap layer
+    // devices at the rasterized scale, not the 72dpi scale.  Bitmap layer
+    // devices are created when saveLayer is called with an ImageFilter;  see
+    // SkPDFDevice::onCreateDevice().
+    SkISize pageSize = (SkSize{width, height} * fRasterScale).toRound();
+    SkMatrix initialTransform;
+    // Skia uses the top left as the origin but PDF natively has the origin at the
+    // bottom left. This matrix corrects for that, as well as the raster scale.
+    initialTransform.setScaleTranslate(fInverseRasterScale, -fInverseRasterScale,
+                                       0, fInverseRasterScale * pageSize.height());
+    return sk_make_sp<SkPDFDevice>(pageSize, const_cast<SkPDFDocument*>(this), initialTransform);
+}
+
 SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
+    this->startPage(this->makePageDevice(width, height));
+    reset_object(&fCanvas, fPageDevice);
+    fCanvas.scale(fRasterScale, fRasterScale);
+    return &fCanvas;
+}
+
+void SkPDFDocument::startPage(sk_sp<SkPDFDevice> device) {
     if (fPages.empty()) {
         // if this is the first page if the document.
         {
             SkAutoMutexExclusive autoMutexAcquire(fMutex);
-            serializeHeader(&fOffsetMap, this->getStream());
+            serializeHeader(&fOffsetMap, this->getStream(), fMetadata.fObjectStreams);
 
         }
 
@@ -267,21 +430,8 @@ SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
             fXMP = SkPDFMetadata::MakeXMPObject(fMetadata, fUUID, fUUID, this);
         }
     }
-    // By scaling the page at the device level, we will create bitmap layer
-    // devices at the rasterized scale, not the 72dpi scale.  Bitmap layer
-    // devices are created when saveLayer is called with an ImageFilter;  see
-    // SkPDFDevice::onCreateDevice().
-    SkISize pageSize = (SkSize{width, height} * fRasterScale).toRound();
-    SkMatrix initialTransform;
-    // Skia uses the top left as the origin but PDF natively has the origin at the
-    // bottom left. This matrix corrects for that, as well as the raster scale.
-    initialTransform.setScaleTranslate(fInverseRasterScale, -fInverseRasterScale,
-                                       0, fInverseRasterScale * pageSize.height());
-    fPageDevice = sk_make_sp<SkPDFDevice>(pageSize, this, initialTransform);
-    reset_object(&fCanvas, fPageDevice);
-    fCanvas.scale(fRasterScale, fRasterScale);
+    fPageDevice = std::move(device);
     fPageRefs.push_back(this->reserveRef());
-    return &fCanvas;
 }
 
 static void populate_link_annotation(SkPDFDict* annotation, const SkRect& r) {
@@ -354,6 +504,10 @@ std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations() {
 void SkPDFDocument::onEndPage() {
     SkASSERT(!fCanvas.imageInfo().dimensions().isZero());
     reset_object(&fCanvas);
+    this->finishPage();
+}
+
+void SkPDFDocument::finishPage() {
     SkASSERT(fPageDevice);
 
     auto page = SkPDFMakeDict("Page");
@@ -379,6 +533,83 @@ void SkPDFDocument::onEndPage() {
     fPages.emplace_back(std::move(page));
 }
 
+void SkPDFDocument::drawAhead(const SkPicture& picture, SkPDFDrawAhead* ahead) {
+    SkPDFDrawAhead* previous = std::exchange(gCurrentDrawAhead, ahead);
+    ahead->fMissed = false;
+    ahead->fAttempts++;
+    ahead->fGlyphUsage.clear();
+
+    // Draw exactly as SkDocument::onDrawPages() does through beginPage().
+    const SkRect cull = picture.cullRect();
+    ahead->fDevice = this->makePageDevice(cull.width(), cull.height());
+    {
+        SkCanvas canvas(ahead->fDevice);
+        canvas.scale(fRasterScale, fRasterScale);
+        canvas.translate(-cull.x(), -cull.y());
+        canvas.drawPicture(&picture);
+    }
+    gCurrentDrawAhead = previous;
+}
+
+void SkPDFDocument::onDrawPages(SkSpan<const sk_sp<SkPicture>> pages) {
+    if (!fExecutor) {
+        this->SkDocument::onDrawPages(pages);
+        return;
+    }
+
+    // Pages are drawn ahead a window at a time, then added in order. A page that missed is
+    // drawn in order instead, which adds what it missed to the document. Later pages that
+    // missed may only have needed the same, so they are drawn ahead once more first.
+    static constexpr size_t kPagesAhead = 16;
+    static constexpr int kMaxAttempts = 2;
+
+    std::vector<SkPDFDrawAhead> ahead(pages.size());
+    auto canDrawAhead = [&](size_t i) {
+        return pages[i] && !pages[i]->cullRect().isEmpty() && ahead[i].fAttempts < kMaxAttempts;
+    };
+    size_t next = 0;
+    while (next < pages.size()) {
+        const size_t end = std::min(pages.size(), next + kPagesAhead);
+        std::vector<size_t> toDraw;
+        for (size_t i = next; i < end; i++) {
+            if ((!ahead[i].fDevice || ahead[i].fMissed) && canDrawAhead(i)) {
+                toDraw.push_back(i);
+            }
+        }
+        SkTaskGroup tasks(*fExecutor);
+        tasks.batch(SkToInt(toDraw.size()), [&](int i) {
+            this->drawAhead(*pages[toDraw[i]], &ahead[toDraw[i]]);
+        });
+        tasks.wait();
+
+        bool drewInOrder = false;
+        while (next < end) {
+            SkPDFDrawAhead& page = ahead[next];
+            if (page.fDevice && !page.fMissed) {
+                this->startPage(std::move(page.fDevice));
+                fPagesDrawnAhead++;
+                if (!page.fGlyphUsage.empty()) {
+                    SkTHashMap<int, SkPDFFont*> fonts;
+                    fFontMap.foreach([&](uint64_t, SkPDFFont* font) {
+                        fonts.set(font->indirectReference().fValue, font);
+                    });
+                    for (const auto& [font, glyph] : page.fGlyphUsage) {
+                        (*fonts.find(font.fValue))->noteGlyphUsage(glyph);
+                    }
+                }
+                this->finishPage();
+            } else if (drewInOrder && canDrawAhead(next)) {
+                break;
+            } else {
+                this->SkDocument::onDrawPages(pages.subspan(next, 1));
+                drewInOrder = true;
+            }
+            page = SkPDFDrawAhead();
+            next++;
+        }
+    }
+}
+
 void SkPDFDocument::onAbort() {
     this->waitForJobs();
 }
@@ -528,10 +759,16 @@ const SkMatrix& SkPDFDocument::currentPageTransform() const {
 }
 
 int SkPDFDocument::createMarkIdForNodeId(int nodeId) {
+    if (SkPDFDrawAhead::Miss()) {
+        return -1;
+    }
     return fTagTree.createMarkIdForNodeId(nodeId, SkToUInt(this->currentPageIndex()));
 }
 
 int SkPDFDocument::createStructParentKeyForNodeId(int nodeId) {
+    if (SkPDFDrawAhead::Miss()) {
+        return -1;
+    }
     return fTagTree.createStructParentKeyForNodeId(nodeId, SkToUInt(this->currentPageIndex()));
 }
 
@@ -598,14 +835,34 @@ void SkPDFDocument::onClose(SkWStream* stream) {
 
     auto docCatalogRef = this->emit(*docCatalog);
 
-    for (const SkPDFFont* f : get_fonts(*this)) {
-        f->emitSubset(this);
+    std::vector<const SkPDFFont*> fonts = get_fonts(*this);
+    std::vector<sk_sp<SkData>> subsets(fonts.size());
+    if (fExecutor) {
+        // Subsetting is slow, so subset the fonts at once. They are still emitted in order.
+        SkTaskGroup subsetting(*fExecutor);
+        subsetting.batch(SkToInt(fonts.size()), [&](int i) {
+            subsets[i] = fonts[i]->makeSubsetFontData(this);
+        });
+        subsetting.wait();
+    }
+    for (size_t i = 0; i < fonts.size(); ++i) {
+        fonts[i]->emitSubset(this, fExecutor ? std::move(subsets[i])
+                                             : fonts[i]->makeSubsetFontData(this));
     }
 
     this->waitForJobs();
+    SkPDFIndirectReference xRefStream;
+    if (fMetadata.fObjectStreams) {
+        if (fObjectStream) {
+            this->emitObjectStream(std::move(fObjectStream));
+            this->waitForJobs();
+        }
+        xRefStream = this->reserveRef();
+    }
     {
         SkAutoMutexExclusive autoMutexAcquire(fMutex);
-        serialize_footer(fOffsetMap, this->getStream(), fInfoDict, docCatalogRef, fUUID);
+        serialize_footer(&fOffsetMap, this->getStream(), fInfoDict, docCatalogRef, fUUID,
+                         xRefStream, fMetadata.fCompressionLevel);
     }
 }
 
@@ -12,16 +12,19 @@
 #include "include/docs/SkPDFDocument.h"
 #include "include/private/SkTHash.h"
 #include "include/private/base/SkMutex.h"
+#include "src/core/SkMD5.h"
 #include "src/pdf/SkPDFMetadata.h"
 #include "src/pdf/SkPDFTag.h"
 
 #include <atomic>
 #include <vector>
 #include <memory>
+#include <utility>
 
 class SkExecutor;
 class SkPDFDevice;
 class SkPDFFont;
+class SkPicture;
 struct SkAdvancedTypefaceMetrics;
 struct SkBitmapKey;
 struct SkPDFFillGraphicState;
@@ -35,18 +38,71 @@ struct KeyHash;
 
 const char* SkPDFGetNodeIdKey();
 
+// A page drawn ahead of its turn by SkPDFDocument::onDrawPages(), on the document's executor.
+// Pages drawn ahead must make the same document as pages drawn one at a time, so the document
+// must not change while they are drawn: canonicalized objects may be found, but code about to
+// make or add anything calls Miss() first and gives up. A page that missed is drawn again when
+// its turn comes.
+class SkPDFDrawAhead {
+public:
+    // The page this thread is drawing ahead, or nullptr.
+    static SkPDFDrawAhead* Current();
+
+    // If this thread is drawing a page ahead, marks it as missed and returns true.
+    static bool Miss() {
+        if (SkPDFDrawAhead* current = Current()) {
+            current->fMissed = true;
+            return true;
+        }
+        return false;
+    }
+
+    // Fonts are shared, so their glyph usage is noted when the page is added to the document.
+    void noteGlyphUsage(const SkPDFFont&, SkGlyphID);
+
+private:
+    friend class SkPDFDocument;
+
+    bool fMissed = false;
+    int  fAttempts = 0;
+    sk_sp<SkPDFDevice> fDevice;
+    std::vector<std::pair<SkPDFIndirectReference, SkGlyphID>> fGlyphUsage;
+};
+
 // Logically part of SkPDFDocument, but separate to keep similar functionality together.
 class SkPDFOffsetMap {
 public:
     void markStartOfDocument(const SkWStream*);
     void markStartOfObject(int referenceNumber, const SkWStream*);
+    void markObjectInStream(int referenceNumber, int streamNumber, int index);
     int objectCount() const;
     int emitCrossReferenceTable(SkWStream* s) const;
+    // Writes a cross-reference stream, object number ref, with the entries of trailer.
+    int emitCrossReferenceStream(SkWStream* s,
+                                 SkPDFIndirectReference ref,
+                                 SkPDFDict* trailer,
+                                 SkPDF::Metadata::CompressionLevel);
 private:
-    std::vector<int> fOffsets;
+    // An object is at fOffset in the document or, if fStream is not 0, it is object number
+    // fIndex in object stream number fStream.
+    struct Location {
+        int fOffset = 0;
+        int fStream = 0;
+        int fIndex = 0;
+    };
+    Location* location(int referenceNumber);
+
+    std::vector<Location> fLocations;
     size_t fBaseOffset = SIZE_MAX;
 };
 
+// Objects waiting to be packed into an object stream.
+struct SkPDFObjectStream {
+    std::vector<int> fNumbers;
+    SkDynamicMemoryWStream fHeader;   // Each object's number and offset into fObjects.
+    SkDynamicMemoryWStream fObjects;
+};
+
 
 struct SkPDFNamedDestination {
     sk_sp<SkData> fName;
@@ -84,6 +140,7 @@ public:
     ~SkPDFDocument() override;
     SkCanvas* onBeginPage(SkScalar, SkScalar) override;
     void onEndPage() override;
+    void onDrawPages(SkSpan<const sk_sp<SkPicture>>) override;
     void onClose(SkWStream*) override;
     void onAbort() override;
 
@@ -101,6 +158,9 @@ public:
 
     template <typename T>
     void emitStream(const SkPDFDict& dict, T writeStream, SkPDFIndirectReference ref) {
+        if (SkPDFDrawAhead::Miss()) {
+            return;
+        }
         SkAutoMutexExclusive lock(fMutex);
         SkWStream* stream = this->beginObject(ref);
         dict.emitObject(stream);
@@ -127,7 +187,13 @@ public:
 
     std::unique_ptr<SkPDFArray> getAnnotations();
 
-    SkPDFIndirectReference reserveRef() { return SkPDFIndirectReference{fNextObjectNumber++}; }
+    SkPDFIndirectReference reserveRef() {
+        if (SkPDFDrawAhead::Miss()) {
+            // Nothing is kept from a page that missed, so any valid number will do.
+            return SkPDFIndirectReference{1};
+        }
+        return SkPDFIndirectReference{fNextObjectNumber++};
+    }
 
     // Returns a tag to prepend to a PostScript name of a subset font. Includes the '+'.
     SkString nextFontSubsetTag();
@@ -137,6 +203,8 @@ public:
     void signalJobComplete();
     size_t currentPageIndex() { return fPages.size(); }
     size_t pageCount() { return fPageRefs.size(); }
+    // How many pages onDrawPages() has added from a drawn ahead device.
+    int pagesDrawnAheadForTesting() const { return fPagesDrawnAhead; }
 
     const SkMatrix& currentPageTransform() const;
 
@@ -145,6 +213,9 @@ public:
     SkTHashMap<SkPDFGradientShader::Key, SkPDFIndirectReference, SkPDFGradientShader::KeyHash>
         fGradientPatternMap;
     SkTHashMap<SkBitmapKey, SkPDFIndirectReference> fPDFBitmapMap;
+    // By content, if fMetadata.fDeduplicateByContent.
+    SkTHashMap<SkMD5::Digest, SkPDFIndirectReference> fPDFImageDigestMap;
+    SkTHashMap<SkMD5::Digest, SkPDFIndirectReference> fFormXObjectDigestMap;
     SkTHashMap<uint32_t, std::unique_ptr<SkAdvancedTypefaceMetrics>> fTypefaceMetrics;
     SkTHashMap<uint32_t, std::vector<SkString>> fType1GlyphNames;
     SkTHashMap<uint32_t, std::vector<SkUnichar>> fToUnicodeMap;
@@ -160,6 +231,7 @@ public:
 
 private:
     SkPDFOffsetMap fOffsetMap;
+    std::unique_ptr<SkPDFObjectStream> fObjectStream;  // If fMetadata.fObjectStreams.
     SkCanvas fCanvas;
     std::vector<std::unique_ptr<SkPDFDict>> fPages;
     std::vector<SkPDFIndirectReference> fPageRefs;
@@ -175,6 +247,7 @@ private:
     SkScalar fRasterScale = 1;
     SkScalar fInverseRasterScale = 1;
     SkExecutor* fExecutor = nullptr;
+    int fPagesDrawnAhead = 0;
 
     // For tagged PDFs.
     SkPDFTagTree fTagTree;
@@ -183,8 +256,13 @@ private:
     SkSemaphore fSemaphore;
 
     void waitForJobs();
+    sk_sp<SkPDFDevice> makePageDevice(SkScalar width, SkScalar height) const;
+    void startPage(sk_sp<SkPDFDevice>);
+    void finishPage();
+    void drawAhead(const SkPicture&, SkPDFDrawAhead*);
     SkWStream* beginObject(SkPDFIndirectReference);
     void endObject();
+    void emitObjectStream(std::unique_ptr<SkPDFObjectStream>);
 };
 
 #endif  // SkPDFDocumentPriv_DEFINED
@@ -110,6 +110,9 @@ const SkAdvancedTypefaceMetrics* SkPDFFont::GetMetrics(const SkTypeface* typefac
     if (std::unique_ptr<SkAdvancedTypefaceMetrics>* ptr = canon->fTypefaceMetrics.find(id)) {
         return ptr->get();  // canon retains ownership.
     }
+    if (SkPDFDrawAhead::Miss()) {
+        return nullptr;
+    }
     int count = typeface->countGlyphs();
     if (count <= 0 || count > 1 + SkTo<int>(UINT16_MAX)) {
         // Cache nullptr to skip this check.  Use SkSafeUnref().
@@ -163,6 +166,10 @@ const std::vector<SkUnichar>& SkPDFFont::GetUnicodeMap(const SkTypeface* typefac
     if (std::vector<SkUnichar>* ptr = canon->fToUnicodeMap.find(id)) {
         return *ptr;
     }
+    if (SkPDFDrawAhead::Miss()) {
+        static const std::vector<SkUnichar> kEmpty;
+        return kEmpty;
+    }
     std::vector<SkUnichar> buffer(typeface->countGlyphs());
     typeface->getGlyphToUnicodeMap(buffer.data());
     return *canon->fToUnicodeMap.set(id, std::move(buffer));
@@ -215,6 +222,9 @@ SkPDFFont* SkPDFFont::GetFontResource(SkPDFDocument* doc,
         SkASSERT(multibyte == found->multiByteGlyphs());
         return found;
     }
+    if (SkPDFDrawAhead::Miss()) {
+        return nullptr;
+    }
 
     sk_sp<SkTypeface> typeface(sk_ref_sp(face));
     SkASSERT(typeface);
@@ -280,21 +290,8 @@ void SkPDFFont::PopulateCommonFontDescriptor(SkPDFDict* descriptor,
 //  Type0Font
 ///////////////////////////////////////////////////////////////////////////////
 
-// if possible, make no copy.
-static sk_sp<SkData> stream_to_data(std::unique_ptr<SkStreamAsset> stream) {
-    SkASSERT(stream);
-    (void)stream->rewind();
-    SkASSERT(stream->hasLength());
-    size_t size = stream->getLength();
-    if (const void* base = stream->getMemoryBase()) {
-        SkData::ReleaseProc proc =
-            [](const void*, void* ctx) { delete (SkStreamAsset*)ctx; };
-        return SkData::MakeWithProc(base, size, proc, stream.release());
-    }
-    return SkData::MakeFromStream(stream.get(), size);
-}
-
-static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
+static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc,
+                              sk_sp<SkData> subsetFontData) {
     const SkAdvancedTypefaceMetrics* metricsPtr =
         SkPDFFont::GetMetrics(font.typeface(), doc);
     SkASSERT(metricsPtr);
@@ -319,29 +316,17 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
     } else {
         switch (type) {
             case SkAdvancedTypefaceMetrics::kTrueType_Font: {
-                if (!SkToBool(metrics.fFlags &
-                              SkAdvancedTypefaceMetrics::kNotSubsettable_FontFlag)) {
-                    SkASSERT(font.firstGlyphID() == 1);
-                    sk_sp<SkData> subsetFontData = SkPDFSubsetFont(
-                            stream_to_data(std::move(fontAsset)), font.glyphUsage(),
-                            doc->metadata().fSubsetter,
-                            metrics.fFontName.c_str(), ttcIndex);
-                    if (subsetFontData) {
-                        std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
-                        tmp->insertInt("Length1", SkToInt(subsetFontData->size()));
-                        descriptor->insertRef(
-                                "FontFile2",
-                                SkPDFStreamOut(std::move(tmp),
-                                               SkMemoryStream::Make(std::move(subsetFontData)),
-                                               doc, SkPDFSteamCompressionEnabled::Yes));
-                        break;
-                    }
-                    // If subsetting fails, fall back to original font data.
-                    fontAsset = face->openStream(&ttcIndex);
-                    SkASSERT(fontAsset);
-                    SkASSERT(fontAsset->getLength() == fontSize);
-                    if (!fontAsset || fontAsset->getLength() == 0) { break; }
+                if (subsetFontData) {
+                    std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
+                    tmp->insertInt("Length1", SkToInt(subsetFontData->size()));
+                    descriptor->insertRef(
+                            "FontFile2",
+                            SkPDFStreamOut(std::move(tmp),
+                                           SkMemoryStream::Make(std::move(subsetFontData)),
+                                           doc, SkPDFSteamCompressionEnabled::Yes));
+                    break;
                 }
+                // If the font can't be subset, or subsetting fails, use the original font data.
                 std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
                 tmp->insertInt("Length1", fontSize);
                 descriptor->insertRef("FontFile2",
@@ -681,11 +666,26 @@ static void emit_subset_type3(const SkPDFFont& pdfFont, SkPDFDocument* doc) {
     doc->emit(font, pdfFont.indirectReference());
 }
 
-void SkPDFFont::emitSubset(SkPDFDocument* doc) const {
+sk_sp<SkData> SkPDFFont::makeSubsetFontData(SkPDFDocument* doc) const {
+    if (fFontType != SkAdvancedTypefaceMetrics::kTrueType_Font) {
+        return nullptr;
+    }
+    // The font's metrics were found when it was made, so this only reads the document.
+    const SkAdvancedTypefaceMetrics* metrics = SkPDFFont::GetMetrics(this->typeface(), doc);
+    if (!metrics ||
+        SkToBool(metrics->fFlags & SkAdvancedTypefaceMetrics::kNotSubsettable_FontFlag)) {
+        return nullptr;
+    }
+    SkASSERT(this->firstGlyphID() == 1);
+    return SkPDFSubsetFont(*this->typeface(), this->glyphUsage(), doc->metadata().fSubsetter,
+                           metrics->fFontName.c_str());
+}
+
+void SkPDFFont::emitSubset(SkPDFDocument* doc, sk_sp<SkData> subsetFontData) const {
     switch (fFontType) {
         case SkAdvancedTypefaceMetrics::kType1CID_Font:
         case SkAdvancedTypefaceMetrics::kTrueType_Font:
-            return emit_subset_type0(*this, doc);
+            return emit_subset_type0(*this, doc, std::move(subsetFontData));
 #ifndef SK_PDF_DO_NOT_SUPPORT_TYPE_1_FONTS
         case SkAdvancedTypefaceMetrics::kType1_Font:
             return SkPDFEmitType1Font(*this, doc);
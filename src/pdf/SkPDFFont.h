@@ -86,6 +86,7 @@ public:
      *  is new and has no other references.
      *  @param typeface  The typeface to find, not nullptr.
      *  @param glyphID   Specify which section of a large font is of interest.
+     *  @return nullptr only when drawing a page ahead, if the font is new.
      */
     static SkPDFFont* GetFontResource(SkPDFDocument* doc,
                                       const SkGlyph* glyphs,
@@ -93,7 +94,8 @@ public:
 
     /** Gets SkAdvancedTypefaceMetrics, and caches the result.
      *  @param typeface can not be nullptr.
-     *  @return nullptr only when typeface is bad.
+     *  @return nullptr only when typeface is bad, or when drawing a page
+     *          ahead, if the typeface is new.
      */
     static const SkAdvancedTypefaceMetrics* GetMetrics(const SkTypeface* typeface,
                                                        SkPDFDocument* canon);
@@ -106,7 +108,14 @@ public:
                                              uint16_t emSize,
                                              int16_t defaultWidth);
 
-    void emitSubset(SkPDFDocument*) const;
+    /** Returns the subset of this TrueType font's data to embed, or nullptr if it is not a
+        TrueType font that can be subset, or subsetting fails. Does not change the document, so
+        several fonts may be subset at once.
+     */
+    sk_sp<SkData> makeSubsetFontData(SkPDFDocument*) const;
+
+    /** Emits the font, embedding subsetFontData, from makeSubsetFontData(), if not null. */
+    void emitSubset(SkPDFDocument*, sk_sp<SkData> subsetFontData) const;
 
     /**
      *  Return false iff the typeface has its NotEmbeddable flag set.
@@ -7,6 +7,10 @@
 
 
 #include "src/pdf/SkPDFFormXObject.h"
+
+#include "src/core/SkMD5.h"
+#include "src/core/SkStreamPriv.h"
+#include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFUtils.h"
 
 SkPDFIndirectReference SkPDFMakeFormXObject(SkPDFDocument* doc,
@@ -35,5 +39,21 @@ SkPDFIndirectReference SkPDFMakeFormXObject(SkPDFDocument* doc,
     }
     group->insertBool("I", true);  // Isolated.
     dict->insertObject("Group", std::move(group));
-    return SkPDFStreamOut(std::move(dict), std::move(content), doc);
+
+    if (!doc->metadata().fDeduplicateByContent) {
+        return SkPDFStreamOut(std::move(dict), std::move(content), doc);
+    }
+    SkMD5 md5;
+    dict->emitObject(&md5);
+    SkStreamCopy(&md5, content.get());
+    SkAssertResult(content->rewind());
+    SkMD5::Digest digest = md5.finish();
+    if (SkPDFIndirectReference* same = doc->fFormXObjectDigestMap.find(digest)) {
+        return *same;
+    }
+    SkPDFIndirectReference ref = SkPDFStreamOut(std::move(dict), std::move(content), doc);
+    if (!SkPDFDrawAhead::Current()) {
+        doc->fFormXObjectDigestMap.set(digest, ref);
+    }
+    return ref;
 }
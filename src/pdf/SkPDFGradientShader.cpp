@@ -989,6 +989,9 @@ static SkPDFIndirectReference find_pdf_shader(SkPDFDocument* doc,
     if (SkPDFIndirectReference* ptr = gradientPatternMap.find(key)) {
         return *ptr;
     }
+    if (SkPDFDrawAhead::Miss()) {
+        return SkPDFIndirectReference();
+    }
     SkPDFIndirectReference pdfShader;
     if (keyHasAlpha) {
         pdfShader = make_alpha_function_shader(doc, key);
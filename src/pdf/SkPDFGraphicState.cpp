@@ -64,6 +64,9 @@ SkPDFIndirectReference SkPDFGraphicState::GetGraphicStateForPaint(SkPDFDocument*
         if (SkPDFIndirectReference* statePtr = fillMap.find(fillKey)) {
             return *statePtr;
         }
+        if (SkPDFDrawAhead::Miss()) {
+            return SkPDFIndirectReference();
+        }
         SkPDFDict state;
         state.reserve(2);
         state.insertColorComponentF("ca", fillKey.fAlpha);
@@ -84,6 +87,9 @@ SkPDFIndirectReference SkPDFGraphicState::GetGraphicStateForPaint(SkPDFDocument*
         if (SkPDFIndirectReference* statePtr = sMap.find(strokeKey)) {
             return *statePtr;
         }
+        if (SkPDFDrawAhead::Miss()) {
+            return SkPDFIndirectReference();
+        }
         SkPDFDict state;
         state.reserve(8);
         state.insertColorComponentF("CA", strokeKey.fAlpha);
@@ -122,6 +128,9 @@ SkPDFIndirectReference SkPDFGraphicState::GetSMaskGraphicState(SkPDFIndirectRefe
                                                                SkPDFDocument* doc) {
     // The practical chances of using the same mask more than once are unlikely
     // enough that it's not worth canonicalizing.
+    if (SkPDFDrawAhead::Miss()) {
+        return SkPDFIndirectReference();
+    }
     auto sMaskDict = SkPDFMakeDict("Mask");
     if (sMaskMode == kAlpha_SMaskMode) {
         sMaskDict->insertName("S", "Alpha");
@@ -351,6 +351,9 @@ SkPDFIndirectReference SkPDFMakeShader(SkPDFDocument* doc,
         if (shaderPtr) {
             return *shaderPtr;
         }
+        if (SkPDFDrawAhead::Miss()) {
+            return SkPDFIndirectReference();
+        }
         SkPDFIndirectReference pdfShader =
                 make_image_shader(doc,
                                   finalMatrix,
@@ -363,5 +366,8 @@ SkPDFIndirectReference SkPDFMakeShader(SkPDFDocument* doc,
         return pdfShader;
     }
     // Don't bother to de-dup fallback shader.
+    if (SkPDFDrawAhead::Miss()) {
+        return SkPDFIndirectReference();
+    }
     return make_fallback_shader(doc, shader, canvasTransform, surfaceBBox, paintColor);
 }
@@ -3,6 +3,12 @@
 
 #include "src/pdf/SkPDFSubsetFont.h"
 
+#include "include/core/SkStream.h"
+#include "include/core/SkTypeface.h"
+#include "include/private/base/SkTo.h"
+#include "src/core/SkMD5.h"
+#include "src/core/SkResourceCache.h"
+
 #if defined(SK_PDF_USE_HARFBUZZ_SUBSET)
 
 #include "include/private/SkTemplates.h"
@@ -201,3 +207,94 @@ sk_sp<SkData> SkPDFSubsetFont(sk_sp<SkData>, const SkPDFGlyphUse&, SkPDF::Metada
     return nullptr;
 }
 #endif  // defined(SK_PDF_USE_SFNTLY)
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+static unsigned gSubsetFontKeyNamespaceLabel;
+
+struct SubsetFontKey : public SkResourceCache::Key {
+    SubsetFontKey(SkTypefaceID typefaceID,
+                  SkPDF::Metadata::Subsetter subsetter,
+                  const SkMD5::Digest& glyphs)
+        : fTypefaceID(typefaceID)
+        , fSubsetter(subsetter)
+        , fGlyphs(glyphs)
+    {
+        this->init(&gSubsetFontKeyNamespaceLabel, 0,
+                   sizeof(fTypefaceID) + sizeof(fSubsetter) + sizeof(fGlyphs));
+    }
+
+    uint32_t      fTypefaceID;
+    int32_t       fSubsetter;
+    SkMD5::Digest fGlyphs;
+};
+
+struct SubsetFontRec : public SkResourceCache::Rec {
+    SubsetFontRec(const SubsetFontKey& key, sk_sp<SkData> subset)
+        : fKey(key)
+        , fSubset(std::move(subset))
+    {}
+
+    SubsetFontKey fKey;
+    sk_sp<SkData> fSubset;  // nullptr if subsetting failed.
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + (fSubset ? fSubset->size() : 0); }
+    const char* getCategory() const override { return "pdf-font-subset"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextSubset) {
+        const SubsetFontRec& rec = static_cast<const SubsetFontRec&>(baseRec);
+        *static_cast<sk_sp<SkData>*>(contextSubset) = rec.fSubset;
+        return true;
+    }
+};
+
+}  // namespace
+
+// If possible, make no copy.
+static sk_sp<SkData> stream_to_data(std::unique_ptr<SkStreamAsset> stream) {
+    SkASSERT(stream);
+    (void)stream->rewind();
+    SkASSERT(stream->hasLength());
+    size_t size = stream->getLength();
+    if (const void* base = stream->getMemoryBase()) {
+        SkData::ReleaseProc proc =
+            [](const void*, void* ctx) { delete (SkStreamAsset*)ctx; };
+        return SkData::MakeWithProc(base, size, proc, stream.release());
+    }
+    return SkData::MakeFromStream(stream.get(), size);
+}
+
+sk_sp<SkData> SkPDFSubsetFont(const SkTypeface& typeface,
+                              const SkPDFGlyphUse& glyphUsage,
+                              SkPDF::Metadata::Subsetter subsetter,
+                              const char* fontName,
+                              SkResourceCache* localCache) {
+    SkMD5 glyphs;
+    glyphUsage.getSetValues([&glyphs](unsigned gid) {
+        uint16_t glyph = SkToU16(gid);
+        glyphs.write(&glyph, sizeof(glyph));
+    });
+    SubsetFontKey key(typeface.uniqueID(), subsetter, glyphs.finish());
+
+    sk_sp<SkData> subset;
+    if (localCache ? localCache->find(key, SubsetFontRec::Visitor, &subset)
+                   : SkResourceCache::Find(key, SubsetFontRec::Visitor, &subset)) {
+        return subset;
+    }
+    int ttcIndex;
+    std::unique_ptr<SkStreamAsset> fontAsset = typeface.openStream(&ttcIndex);
+    if (!fontAsset || 0 == fontAsset->getLength()) {
+        return nullptr;
+    }
+    subset = SkPDFSubsetFont(stream_to_data(std::move(fontAsset)), glyphUsage, subsetter,
+                             fontName, ttcIndex);
+    if (localCache) {
+        localCache->add(new SubsetFontRec(key, subset));
+    } else {
+        SkResourceCache::Add(new SubsetFontRec(key, subset));
+    }
+    return subset;
+}
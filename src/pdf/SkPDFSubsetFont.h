@@ -7,10 +7,22 @@
 #include "include/docs/SkPDFDocument.h"
 #include "src/pdf/SkPDFGlyphUse.h"
 
+class SkResourceCache;
+class SkTypeface;
+
 sk_sp<SkData> SkPDFSubsetFont(sk_sp<SkData> fontData,
                               const SkPDFGlyphUse& glyphUsage,
                               SkPDF::Metadata::Subsetter subsetter,
                               const char* fontName,
                               int ttcIndex);
 
+// Subsets the typeface's data, as above. Subsets are kept in SkResourceCache (or localCache, if
+// not null), keyed by the typeface's unique ID, the subsetter and a hash of the glyphs, so
+// documents that use the same glyphs of a typeface share one. Thread-safe.
+sk_sp<SkData> SkPDFSubsetFont(const SkTypeface& typeface,
+                              const SkPDFGlyphUse& glyphUsage,
+                              SkPDF::Metadata::Subsetter subsetter,
+                              const char* fontName,
+                              SkResourceCache* localCache = nullptr);
+
 #endif  // SkPDFSubsetFont_DEFINED
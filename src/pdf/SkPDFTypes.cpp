@@ -583,6 +583,9 @@ SkPDFIndirectReference SkPDFStreamOut(std::unique_ptr<SkPDFDict> dict,
                                       SkPDFDocument* doc,
                                       SkPDFSteamCompressionEnabled compress) {
     SkPDFIndirectReference ref = doc->reserveRef();
+    if (SkPDFDrawAhead::Current()) {
+        return ref;  // reserveRef() missed; don't bother compressing.
+    }
     if (SkExecutor* executor = doc->executor()) {
         SkPDFDict* dictPtr = dict.release();
         SkStreamAsset* contentPtr = content.release();
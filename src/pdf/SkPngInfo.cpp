@@ -0,0 +1,93 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/pdf/SkPngInfo.h"
+
+#include "include/core/SkStream.h"
+#include "include/private/base/SkTo.h"
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+static uint32_t get_bigendian_uint32(const uint8_t* ptr) {
+    return (uint32_t)ptr[0] << 24 | (uint32_t)ptr[1] << 16 | (uint32_t)ptr[2] << 8 | ptr[3];
+}
+
+bool SkGetPngInfo(const void* data, size_t len, SkISize* size, int* colors, SkWStream* idat) {
+    static const uint8_t kSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    if (!bytes || len < sizeof(kSignature) ||
+        0 != memcmp(bytes, kSignature, sizeof(kSignature))) {
+        return false;
+    }
+
+    SkISize pngSize = {0, 0};
+    int pngColors = 0;
+    std::vector<std::pair<size_t, size_t>> idatChunks;  // Offset and length of each.
+    size_t offset = sizeof(kSignature);
+    bool sawIEND = false;
+    while (!sawIEND) {
+        if (len - offset < 8) {
+            return false;
+        }
+        const uint32_t length = get_bigendian_uint32(bytes + offset);
+        const uint8_t* type = bytes + offset + 4;
+        offset += 8;
+        if (length > len - offset || len - offset - length < 4) {  // Data, then a CRC.
+            return false;
+        }
+        const uint8_t* chunk = bytes + offset;
+        offset += length + 4;
+
+        if (0 == memcmp(type, "IHDR", 4)) {
+            if (length != 13 || !pngSize.isZero()) {
+                return false;
+            }
+            const uint32_t width  = get_bigendian_uint32(chunk + 0),
+                           height = get_bigendian_uint32(chunk + 4);
+            const uint8_t bitDepth    = chunk[8],
+                          colorType   = chunk[9],
+                          compression = chunk[10],
+                          filter      = chunk[11],
+                          interlace   = chunk[12];
+            if (width == 0 || height == 0 || width > INT32_MAX || height > INT32_MAX ||
+                bitDepth != 8 || compression != 0 || filter != 0 || interlace != 0) {
+                return false;
+            }
+            switch (colorType) {
+                case 0: pngColors = 1; break;  // Gray
+                case 2: pngColors = 3; break;  // RGB
+                default: return false;         // Palette, or with alpha.
+            }
+            pngSize = {SkToInt(width), SkToInt(height)};
+        } else if (pngSize.isZero()) {
+            return false;  // IHDR must come first.
+        } else if (0 == memcmp(type, "IDAT", 4)) {
+            idatChunks.push_back({SkToSizeT(chunk - bytes), length});
+        } else if (0 == memcmp(type, "IEND", 4)) {
+            sawIEND = true;
+        } else if (0 == memcmp(type, "tRNS", 4) || 0 == memcmp(type, "eXIf", 4)) {
+            return false;  // Transparency, or an orientation to apply.
+        } else if (0 == (type[0] & 0x20) && 0 != memcmp(type, "PLTE", 4)) {
+            return false;  // An unknown critical chunk.
+        }
+    }
+    if (idatChunks.empty()) {
+        return false;
+    }
+
+    *size = pngSize;
+    *colors = pngColors;
+    if (idat) {
+        for (auto [chunkOffset, chunkLength] : idatChunks) {
+            idat->write(bytes + chunkOffset, chunkLength);
+        }
+    }
+    return true;
+}
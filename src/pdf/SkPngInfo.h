@@ -0,0 +1,27 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkPngInfo_DEFINED
+#define SkPngInfo_DEFINED
+
+#include "include/core/SkSize.h"
+
+#include <cstddef>
+
+class SkWStream;
+
+/** Returns true if the data seems to be a valid PNG image whose compressed pixels can be copied
+    into a PDF image as is: 8 bits per component, not interlaced, gray or RGB with no
+    transparency, and no EXIF orientation.
+
+    @param [out] size    Image size in pixels
+    @param [out] colors  Components per pixel, 1 for gray or 3 for RGB.
+    @param [out] idat    If not null, receives the image's IDAT chunks, concatenated: a zlib
+                         stream of rows that each start with their PNG filter type.
+*/
+bool SkGetPngInfo(const void* data, size_t len, SkISize* size, int* colors, SkWStream* idat);
+
+#endif  // SkPngInfo_DEFINED
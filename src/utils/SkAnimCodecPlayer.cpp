@@ -22,6 +22,8 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/core/SkNextID.h"
+#include "src/core/SkResourceCache.h"
 
 #include <algorithm>
 #include <cstddef>
@@ -29,10 +31,68 @@
 #include <utility>
 #include <vector>
 
+namespace {
+
+// Seeking to a frame decodes at most this many frames, as long as its keyframe is cached.
+static constexpr int kKeyframeInterval = 4;
+
+static unsigned gAnimFrameKeyNamespaceLabel;
+
+uint64_t make_shared_id(uint32_t cacheID) {
+    uint64_t sharedID = SkSetFourByteTag('a', 'n', 'i', 'm');
+    return (sharedID << 32) | cacheID;
+}
+
+struct AnimFrameKey : public SkResourceCache::Key {
+    AnimFrameKey(uint32_t cacheID, int index)
+        : fCacheID(cacheID)
+        , fIndex(index)
+    {
+        this->init(&gAnimFrameKeyNamespaceLabel, make_shared_id(cacheID),
+                   sizeof(fCacheID) + sizeof(fIndex));
+    }
+
+    uint32_t fCacheID;
+    int32_t  fIndex;
+};
+
+struct AnimFrameRec : public SkResourceCache::Rec {
+    AnimFrameRec(const AnimFrameKey& key, sk_sp<SkImage> image)
+        : fKey(key)
+        , fImage(std::move(image))
+    {}
+
+    AnimFrameKey   fKey;
+    sk_sp<SkImage> fImage;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fImage->imageInfo().computeMinByteSize();
+    }
+    const char* getCategory() const override { return "anim-frame"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextImage) {
+        const AnimFrameRec& rec = static_cast<const AnimFrameRec&>(baseRec);
+        *static_cast<sk_sp<SkImage>*>(contextImage) = rec.fImage;
+        return true;
+    }
+};
+
+}  // namespace
+
 SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(std::move(codec)) {
     fImageInfo = fCodec->getInfo();
     fFrameInfos = fCodec->getFrameInfo();
-    fImages.resize(fFrameInfos.size());
+
+    // A frame's required frame always precedes it, so its depth in the chain is already known.
+    std::vector<int> depths(fFrameInfos.size());
+    fKeyframes.resize(fFrameInfos.size());
+    for (size_t i = 0; i < fFrameInfos.size(); ++i) {
+        const int requiredFrame = fFrameInfos[i].fRequiredFrame;
+        depths[i] = requiredFrame == SkCodec::kNoFrame ? 0 : depths[requiredFrame] + 1;
+        fKeyframes[i] = depths[i] % kKeyframeInterval == 0;
+    }
+    fCacheID = SkNextID::ImageID();
 
     // change the interpretation of fDuration to a end-time for that frame
     size_t dur = 0;
@@ -45,18 +105,22 @@ SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(st
     if (!fTotalDuration) {
         // Static image -- may or may not have returned a single frame info.
         fFrameInfos.clear();
-        fImages.clear();
-        fImages.push_back(SkImage::MakeFromGenerator(
-                              SkCodecImageGenerator::MakeFromCodec(std::move(fCodec))));
+        fKeyframes.clear();
+        fImage = SkImage::MakeFromGenerator(
+                SkCodecImageGenerator::MakeFromCodec(std::move(fCodec)));
+        fImageIndex = 0;
     }
 }
 
-SkAnimCodecPlayer::~SkAnimCodecPlayer() {}
+SkAnimCodecPlayer::~SkAnimCodecPlayer() {
+    if (fTotalDuration) {
+        SkResourceCache::PostPurgeSharedID(make_shared_id(fCacheID));
+    }
+}
 
 SkISize SkAnimCodecPlayer::dimensions() const {
     if (!fCodec) {
-        auto image = fImages.front();
-        return image ? image->dimensions() : SkISize::MakeEmpty();
+        return fImage ? fImage->dimensions() : SkISize::MakeEmpty();
     }
     if (SkEncodedOriginSwapsWidthHeight(fCodec->getOrigin())) {
         return { fImageInfo.height(), fImageInfo.width() };
@@ -67,10 +131,42 @@ SkISize SkAnimCodecPlayer::dimensions() const {
 sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
     SkASSERT((unsigned)index < fFrameInfos.size());
 
-    if (fImages[index]) {
-        return fImages[index];
+    if (index == fImageIndex) {
+        return fImage;
+    }
+
+    // Walk back through the required frames until one is already composited, either because it
+    // was the last frame returned or because it is a cached keyframe. The frames in between are
+    // then decoded forward, each on top of the one it requires.
+    std::vector<int> chain;
+    sk_sp<SkImage> image;
+    for (int i = index; i != SkCodec::kNoFrame; i = fFrameInfos[i].fRequiredFrame) {
+        if (i == fImageIndex) {
+            image = fImage;
+            break;
+        }
+        if (fKeyframes[i] && SkResourceCache::Find(AnimFrameKey(fCacheID, i),
+                                                   AnimFrameRec::Visitor, &image)) {
+            break;
+        }
+        chain.push_back(i);
     }
 
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        image = this->decodeFrame(*it, image);
+        if (!image) {
+            return nullptr;
+        }
+        if (fKeyframes[*it]) {
+            SkResourceCache::Add(new AnimFrameRec(AnimFrameKey(fCacheID, *it), image));
+        }
+    }
+
+    fImageIndex = index;
+    return fImage = std::move(image);
+}
+
+sk_sp<SkImage> SkAnimCodecPlayer::decodeFrame(int index, const sk_sp<SkImage>& requiredImage) {
     size_t rb = fImageInfo.minRowBytes();
     size_t size = fImageInfo.computeByteSize(rb);
     auto data = SkData::MakeUninitialized(size);
@@ -91,8 +187,8 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
         imageInfo = imageInfo.makeAlphaType(kPremul_SkAlphaType);
     }
     const int requiredFrame = fFrameInfos[index].fRequiredFrame;
-    if (requiredFrame != SkCodec::kNoFrame && fImages[requiredFrame]) {
-        auto requiredImage = fImages[requiredFrame];
+    if (requiredFrame != SkCodec::kNoFrame) {
+        SkASSERT(requiredImage);
         auto canvas = SkCanvas::MakeRasterDirect(imageInfo, data->writable_data(), rb);
         if (origin != kDefault_SkEncodedOrigin) {
             // The required frame is stored after applying the origin. Undo that,
@@ -125,15 +221,13 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
         canvas->drawImage(image, 0, 0, SkSamplingOptions(), &paint);
         image = SkImage::MakeRasterData(imageInfo, std::move(data), rb);
     }
-    return fImages[index] = image;
+    return image;
 }
 
 sk_sp<SkImage> SkAnimCodecPlayer::getFrame() {
-    SkASSERT(fTotalDuration > 0 || fImages.size() == 1);
-
     return fTotalDuration > 0
         ? this->getFrameAt(fCurrIndex)
-        : fImages.front();
+        : fImage;
 }
 
 bool SkAnimCodecPlayer::seek(uint32_t msec) {
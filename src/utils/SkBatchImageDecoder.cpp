@@ -0,0 +1,175 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkBatchImageDecoder.h"
+
+#include "include/codec/SkAndroidCodec.h"
+#include "include/codec/SkCodec.h"
+#include "include/codec/SkEncodedOrigin.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPixmap.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkSemaphore.h"
+#include "src/core/SkPixmapPriv.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Job {
+    int                             fIndex;
+    std::unique_ptr<SkAndroidCodec> fCodec;
+    SkImageInfo                     fInfo;        // after orientation
+    SkEncodedOrigin                 fOrigin;
+    int                             fSampleSize;
+    size_t                          fBytes;       // including an unoriented copy, if needed
+};
+
+// Returns the sample size that decodes codec to at least target, after orientation.
+int sample_size(SkAndroidCodec* codec, SkISize target, SkEncodedOrigin origin) {
+    if (target.isEmpty()) {
+        return 1;
+    }
+    if (SkEncodedOriginSwapsWidthHeight(origin)) {
+        target = {target.height(), target.width()};
+    }
+
+    const SkISize size = codec->getInfo().dimensions();
+    const float scale = std::min((float)target.width()  / size.width(),
+                                 (float)target.height() / size.height());
+    if (scale >= 1) {
+        return 1;
+    }
+    SkISize fitted = {std::max(1, (int)(size.width()  * scale)),
+                      std::max(1, (int)(size.height() * scale))};
+    return codec->computeSampleSize(&fitted);
+}
+
+bool make_job(int index, sk_sp<SkData> data, const SkBatchImageDecoder::Options& options,
+              Job* job) {
+    auto codec = SkAndroidCodec::MakeFromData(std::move(data));
+    if (!codec) {
+        return false;
+    }
+
+    const SkEncodedOrigin origin = codec->codec()->getOrigin();
+    const int sampleSize = sample_size(codec.get(), options.fTargetSize, origin);
+    const SkColorType colorType = codec->computeOutputColorType(options.fColorType);
+    SkImageInfo info = SkImageInfo::Make(codec->getSampledDimensions(sampleSize), colorType,
+                                         codec->computeOutputAlphaType(false),
+                                         codec->computeOutputColorSpace(colorType));
+    if (SkEncodedOriginSwapsWidthHeight(origin)) {
+        info = SkPixmapPriv::SwapWidthHeight(info);
+    }
+
+    size_t bytes = info.computeMinByteSize();
+    if (SkImageInfo::ByteSizeOverflowed(bytes)) {
+        return false;
+    }
+    if (origin != kTopLeft_SkEncodedOrigin) {
+        bytes *= 2;
+    }
+
+    *job = {index, std::move(codec), info, origin, sampleSize, bytes};
+    return true;
+}
+
+sk_sp<SkImage> decode(const Job& job) {
+    SkBitmap bitmap;
+    if (!bitmap.tryAllocPixels(job.fInfo)) {
+        return nullptr;
+    }
+
+    SkAndroidCodec::AndroidOptions options;
+    options.fSampleSize = job.fSampleSize;
+    options.fBoxFilter = true;
+    const bool success = SkPixmapPriv::Orient(bitmap.pixmap(), job.fOrigin,
+            [&](const SkPixmap& pm) {
+        switch (job.fCodec->getAndroidPixels(pm.info(), pm.writable_addr(), pm.rowBytes(),
+                                             &options)) {
+            case SkCodec::kSuccess:
+            case SkCodec::kIncompleteInput:
+            case SkCodec::kErrorInInput:
+                return true;
+            default:
+                return false;
+        }
+    });
+    if (!success) {
+        return nullptr;
+    }
+
+    bitmap.setImmutable();
+    return bitmap.asImage();
+}
+
+}  // namespace
+
+void SkBatchImageDecoder::Decode(SkSpan<const sk_sp<SkData>> encoded, SkExecutor* executor,
+                                 const Options& options, const Callback& callback) {
+    // Read every header first. It is cheap, and tells us how many bytes each decode needs.
+    std::vector<Job> jobs;
+    jobs.reserve(encoded.size());
+    for (size_t i = 0; i < encoded.size(); i++) {
+        Job job;
+        if (make_job((int)i, encoded[i], options, &job)) {
+            jobs.push_back(std::move(job));
+        } else {
+            callback((int)i, nullptr);
+        }
+    }
+
+    struct Finished {
+        size_t         fJob;
+        sk_sp<SkImage> fImage;
+    };
+    SkMutex mutex;
+    std::deque<Finished> finished;  // guarded by mutex
+    SkSemaphore ready;
+
+    // Only this thread starts decodes and hands back their images, so only it tracks the budget.
+    SkTaskGroup tasks(executor ? *executor : SkExecutor::GetDefault());
+    size_t next = 0,
+           inFlight = 0;
+    for (size_t delivered = 0; delivered < jobs.size(); delivered++) {
+        while (next < jobs.size() &&
+               (inFlight == 0 || inFlight + jobs[next].fBytes <= options.fByteBudget)) {
+            inFlight += jobs[next].fBytes;
+            tasks.add([&, n = next] {
+                sk_sp<SkImage> image = decode(jobs[n]);
+                {
+                    SkAutoMutexExclusive lock(mutex);
+                    finished.push_back({n, std::move(image)});
+                }
+                ready.signal();
+            });
+            next++;
+        }
+
+        ready.wait();
+        Finished done;
+        {
+            SkAutoMutexExclusive lock(mutex);
+            done = std::move(finished.front());
+            finished.pop_front();
+        }
+        inFlight -= jobs[done.fJob].fBytes;
+        // The codec's buffers can go now, too.
+        jobs[done.fJob].fCodec.reset();
+        callback(jobs[done.fJob].fIndex, std::move(done.fImage));
+    }
+    tasks.wait();
+}
@@ -7,14 +7,19 @@
 
 #include "include/codec/SkAndroidCodec.h"
 #include "include/codec/SkCodec.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColor.h"
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkEncodedImageFormat.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkStream.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypes.h"
+#include "include/encode/SkPngEncoder.h"
 #include "modules/skcms/skcms.h"
 #include "src/core/SkMD5.h"
 #include "tests/Test.h"
@@ -237,3 +242,111 @@ DEF_TEST(AndroidCodec_xmpMetadata, r) {
         }
     }
 }
+
+DEF_TEST(AndroidCodec_boxFilter, r) {
+    // A single pixel checkerboard, which point sampling turns solid black or white.
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeN32Premul(64, 64));
+    for (int y = 0; y < bm.height(); ++y) {
+        for (int x = 0; x < bm.width(); ++x) {
+            *bm.getAddr32(x, y) = (x + y) % 2 ? SkPreMultiplyColor(SK_ColorWHITE)
+                                              : SkPreMultiplyColor(SK_ColorBLACK);
+        }
+    }
+
+    SkDynamicMemoryWStream stream;
+    REPORTER_ASSERT(r, SkPngEncoder::Encode(&stream, bm.pixmap(), SkPngEncoder::Options()));
+    sk_sp<SkData> data = stream.detachAsData();
+
+    for (int sampleSize : { 2, 3, 4, 7 }) {
+        auto codec = SkAndroidCodec::MakeFromData(data);
+        if (!codec) {
+            ERRORF(r, "Failed to create codec");
+            return;
+        }
+
+        const SkISize size = codec->getSampledDimensions(sampleSize);
+        SkBitmap dst;
+        dst.allocPixels(codec->getInfo().makeDimensions(size).makeColorType(kN32_SkColorType));
+
+        SkAndroidCodec::AndroidOptions options;
+        options.fSampleSize = sampleSize;
+        options.fBoxFilter = true;
+        const auto result = codec->getAndroidPixels(dst.info(), dst.getPixels(), dst.rowBytes(),
+                                                    &options);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == result, "sampleSize %i: %s", sampleSize,
+                        SkCodec::ResultToString(result));
+
+        // Every box is at least half black and half white, to within one pixel.
+        for (int y = 0; y < dst.height(); ++y) {
+            for (int x = 0; x < dst.width(); ++x) {
+                const SkColor c = dst.getColor(x, y);
+                REPORTER_ASSERT(r, SkColorGetA(c) == 0xFF);
+                REPORTER_ASSERT(r, SkColorGetR(c) > 0x60 && SkColorGetR(c) < 0xA0,
+                                "sampleSize %i: (%i, %i) is %x", sampleSize, x, y, c);
+            }
+        }
+    }
+}
+
+DEF_TEST(AndroidCodec_boxFilter_scanline, r) {
+    // An 8x8 bottom up BMP, which is box filtered through the scanline decoder.
+    auto data = GetResourceAsData("images/randPixels.bmp");
+    if (!data) {
+        return;
+    }
+    auto codec = SkAndroidCodec::MakeFromData(data);
+    if (!codec) {
+        ERRORF(r, "Failed to create codec");
+        return;
+    }
+
+    SkBitmap full;
+    full.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType));
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(full.info(),
+                                                                    full.getPixels(),
+                                                                    full.rowBytes()));
+
+    constexpr int kSampleSize = 2;
+    SkAndroidCodec::AndroidOptions options;
+    options.fSampleSize = kSampleSize;
+    options.fBoxFilter = true;
+
+    SkBitmap dst;
+    dst.allocPixels(full.info().makeDimensions(codec->getSampledDimensions(kSampleSize)));
+    const auto result = codec->getAndroidPixels(dst.info(), dst.getPixels(), dst.rowBytes(),
+                                                &options);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == result, "%s", SkCodec::ResultToString(result));
+
+    // Each pixel is the average of its 2x2 box, to within rounding.
+    for (int y = 0; y < dst.height(); ++y) {
+        for (int x = 0; x < dst.width(); ++x) {
+            int sums[3] = {0, 0, 0};
+            for (int sy = 0; sy < kSampleSize; ++sy) {
+                for (int sx = 0; sx < kSampleSize; ++sx) {
+                    const SkColor c = full.getColor(x * kSampleSize + sx, y * kSampleSize + sy);
+                    sums[0] += SkColorGetR(c);
+                    sums[1] += SkColorGetG(c);
+                    sums[2] += SkColorGetB(c);
+                }
+            }
+            const SkColor c = dst.getColor(x, y);
+            const int got[3] = {(int)SkColorGetR(c), (int)SkColorGetG(c), (int)SkColorGetB(c)};
+            for (int i = 0; i < 3; ++i) {
+                const int want = sums[i] / (kSampleSize * kSampleSize);
+                REPORTER_ASSERT(r, got[i] >= want - 1 && got[i] <= want + 1,
+                                "(%i, %i) channel %i is %i, want %i", x, y, i, got[i], want);
+            }
+        }
+    }
+
+    // Dimensions that sampling wouldn't produce are rejected rather than box filtered.
+    for (SkISize size : { SkISize{3, 4}, SkISize{4, 3}, SkISize{3, 3} }) {
+        SkBitmap bad;
+        bad.allocPixels(full.info().makeDimensions(size));
+        REPORTER_ASSERT(r, SkCodec::kInvalidScale == codec->getAndroidPixels(bad.info(),
+                                                                             bad.getPixels(),
+                                                                             bad.rowBytes(),
+                                                                             &options));
+    }
+}
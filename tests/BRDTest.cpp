@@ -12,8 +12,15 @@
 #include "client_utils/android/BitmapRegionDecoder.h"
 #include "include/codec/SkAndroidCodec.h"
 #include "include/codec/SkCodec.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkStream.h"
+#include "include/encode/SkJpegEncoder.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
+#include "tools/ToolUtils.h"
 
 DEF_TEST(BRD_types, r) {
     static const struct {
@@ -47,4 +54,73 @@ DEF_TEST(BRD_types, r) {
         }
     }
 }
+
+#if defined(SK_CODEC_DECODES_JPEG) && defined(SK_ENCODE_JPEG)
+DEF_TEST(BRD_jpegRegionIndex, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(700, 900, /*isOpaque=*/true);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    SkPaint paint;
+    for (int i = 0; i < 40; ++i) {
+        paint.setColor(SkColorSetRGB(17 * i, 255 - 5 * i, 31 * i));
+        canvas.drawCircle(15.0f * i, 20.0f * i, 10.0f + 4 * i, paint);
+    }
+
+    // Encoding on an executor splits the image into bands separated by restart markers.
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    SkJpegEncoder::Options options;
+    options.fExecutor = executor.get();
+    SkDynamicMemoryWStream stream;
+    REPORTER_ASSERT(r, SkJpegEncoder::Encode(&stream, bitmap.pixmap(), options));
+    sk_sp<SkData> data = stream.detachAsData();
+
+    auto plain = android::skia::BitmapRegionDecoder::Make(data);
+    auto indexed = android::skia::BitmapRegionDecoder::Make(data);
+    auto reloaded = android::skia::BitmapRegionDecoder::Make(data);
+    REPORTER_ASSERT(r, plain && indexed && reloaded);
+    if (!plain || !indexed || !reloaded) {
+        return;
+    }
+    sk_sp<SkData> index = indexed->buildRegionIndex();
+    REPORTER_ASSERT(r, index);
+    if (!index) {
+        return;
+    }
+    REPORTER_ASSERT(r, reloaded->setRegionIndex(*index));
+
+    const struct {
+        SkIRect fSubset;
+        int     fSampleSize;
+    } recs[] = {
+        { SkIRect::MakeXYWH(  0,   0, 256, 256), 1 },
+        { SkIRect::MakeXYWH(200, 333, 256, 256), 1 },
+        { SkIRect::MakeXYWH(444, 644, 256, 256), 1 },
+        { SkIRect::MakeXYWH(101, 517, 300, 383), 2 },
+        { SkIRect::MakeXYWH(  0, 400, 700, 500), 4 },
+    };
+    for (const auto& rec : recs) {
+        SkBitmap expected, actual, actualReloaded;
+        for (auto [brd, bm] : { std::make_pair(plain.get(), &expected),
+                                std::make_pair(indexed.get(), &actual),
+                                std::make_pair(reloaded.get(), &actualReloaded) }) {
+            REPORTER_ASSERT(r, brd->decodeRegion(bm, nullptr, rec.fSubset, rec.fSampleSize,
+                                                 kN32_SkColorType, false, nullptr));
+        }
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual));
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actualReloaded));
+    }
+
+    // Without restart markers there's nothing to index, and someone else's index doesn't fit.
+    SkDynamicMemoryWStream serialStream;
+    REPORTER_ASSERT(r, SkJpegEncoder::Encode(&serialStream, bitmap.pixmap(), {}));
+    auto serial = android::skia::BitmapRegionDecoder::Make(serialStream.detachAsData());
+    REPORTER_ASSERT(r, serial);
+    if (serial) {
+        REPORTER_ASSERT(r, !serial->buildRegionIndex());
+        REPORTER_ASSERT(r, !serial->setRegionIndex(*index));
+    }
+}
+#endif
+
 #endif // SK_ENABLE_ANDROID_UTILS
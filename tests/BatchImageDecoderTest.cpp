@@ -0,0 +1,89 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkStream.h"
+#include "include/encode/SkPngEncoder.h"
+#include "include/utils/SkBatchImageDecoder.h"
+#include "tests/Test.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+static sk_sp<SkData> encode_solid_png(int width, int height, SkColor color) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeN32Premul(width, height));
+    bm.eraseColor(color);
+
+    SkDynamicMemoryWStream stream;
+    if (!SkPngEncoder::Encode(&stream, bm.pixmap(), SkPngEncoder::Options())) {
+        return nullptr;
+    }
+    return stream.detachAsData();
+}
+
+DEF_TEST(BatchImageDecoder, r) {
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, SK_ColorWHITE };
+    const SkISize sizes[] = { {400, 300}, {64, 640}, {40, 30}, {1000, 1000} };
+
+    std::vector<sk_sp<SkData>> encoded;
+    for (int i = 0; i < 4; i++) {
+        encoded.push_back(encode_solid_png(sizes[i].width(), sizes[i].height(), colors[i]));
+        REPORTER_ASSERT(r, encoded.back());
+    }
+    // Not an image.
+    encoded.push_back(SkData::MakeWithCString("not an image"));
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // A budget smaller than any one image still decodes them all, one at a time.
+    for (size_t budget : { (size_t)1, (size_t)64 * 1024 * 1024 }) {
+        SkBatchImageDecoder::Options options;
+        options.fTargetSize = {100, 100};
+        options.fByteBudget = budget;
+
+        std::vector<int> calls(encoded.size(), 0);
+        SkBatchImageDecoder::Decode(encoded, executor.get(), options,
+                                    [&](int index, sk_sp<SkImage> image) {
+            calls[index]++;
+            if (index == 4) {
+                REPORTER_ASSERT(r, !image);
+                return;
+            }
+            if (!image) {
+                ERRORF(r, "image %d failed to decode", index);
+                return;
+            }
+
+            // Sampling only reaches sizes at least as large as the target, and never scales up.
+            const SkISize full = sizes[index];
+            REPORTER_ASSERT(r, image->width()  <= full.width());
+            REPORTER_ASSERT(r, image->height() <= full.height());
+            REPORTER_ASSERT(r, image->width()  >= std::min(100, full.width()) ||
+                               image->height() >= std::min(100, full.height()));
+            if (full.width() > 200 && full.height() > 200) {
+                REPORTER_ASSERT(r, image->width() < full.width());
+            }
+
+            SkBitmap bm;
+            REPORTER_ASSERT(r, image->asLegacyBitmap(&bm));
+            REPORTER_ASSERT(r, bm.getColor(bm.width() / 2, bm.height() / 2) == colors[index]);
+        });
+
+        for (size_t i = 0; i < calls.size(); i++) {
+            REPORTER_ASSERT(r, calls[i] == 1, "image %zu called back %d times", i, calls[i]);
+        }
+    }
+}
@@ -21,6 +21,7 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypes.h"
+#include "include/private/base/SkTo.h"
 #include "include/utils/SkAnimCodecPlayer.h"
 #include "tests/CodecPriv.h"
 #include "tests/Test.h"
@@ -626,3 +627,60 @@ DEF_TEST(AnimCodecPlayer, r) {
                         "Mismatched size for frame at 500 ms of %s", test.fFile);
     }
 }
+
+DEF_TEST(AnimCodecPlayer_seek, r) {
+    for (const char* file : { "images/alphabetAnim.gif",
+                              "images/required.gif",
+                              "images/required.webp",
+                              "images/stoplight.webp" }) {
+        auto data = GetResourceAsData(file);
+        if (!data) {
+            continue;
+        }
+        auto codec = SkCodec::MakeFromData(data);
+        REPORTER_ASSERT(r, codec);
+        if (!codec) {
+            continue;
+        }
+
+        std::vector<uint32_t> startTimes;
+        uint32_t time = 0;
+        for (const auto& frameInfo : codec->getFrameInfo()) {
+            startTimes.push_back(time);
+            time += frameInfo.fDuration;
+        }
+        const int frameCount = SkToInt(startTimes.size());
+
+        // Play forward, from a player that only ever needs the previous frame.
+        std::vector<sk_sp<SkImage>> expected;
+        SkAnimCodecPlayer forward(std::move(codec));
+        for (int i = 0; i < frameCount; ++i) {
+            forward.seek(startTimes[i]);
+            expected.push_back(forward.getFrame());
+            REPORTER_ASSERT(r, expected.back());
+        }
+
+        // Seek backward, and then around, from a player that has to rebuild frames from its
+        // keyframes. Part of the way through, a fresh player, which has none of its keyframes
+        // cached yet, takes over and starts from scratch.
+        auto seeking = std::make_unique<SkAnimCodecPlayer>(SkCodec::MakeFromData(data));
+        std::vector<int> order;
+        for (int i = frameCount - 1; i >= 0; --i) {
+            order.push_back(i);
+        }
+        for (int i = 0; i < frameCount; ++i) {
+            order.push_back((i * 5 + 3) % frameCount);
+        }
+        for (size_t i = 0; i < order.size(); ++i) {
+            if (i == order.size() / 2) {
+                seeking = std::make_unique<SkAnimCodecPlayer>(SkCodec::MakeFromData(data));
+            }
+            const int index = order[i];
+            seeking->seek(startTimes[index]);
+            auto frame = seeking->getFrame();
+            REPORTER_ASSERT(r, frame && expected[index] &&
+                               ToolUtils::equal_pixels(frame.get(), expected[index].get()),
+                            "Mismatched frame %d of %s", index, file);
+        }
+    }
+}
@@ -15,10 +15,12 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkPngChunkReader.h"
 #include "include/core/SkRect.h"
@@ -1937,3 +1939,55 @@ DEF_TEST(Codec_noConversion, r) {
         REPORTER_ASSERT(r, bm.getColor(0, 0) == rec.color);
     }
 }
+
+DEF_TEST(Codec_jpegExecutor, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    SkBitmap src;
+    src.allocN32Pixels(1200, 1600, /*isOpaque=*/true);
+    src.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(src);
+    SkPaint paint;
+    for (int i = 0; i < 60; ++i) {
+        paint.setColor(SkColorSetRGB(17 * i, 255 - 5 * i, 31 * i));
+        canvas.drawCircle(20.0f * i, 27.0f * i, 10.0f + 5 * i, paint);
+    }
+    SkBitmap gray;
+    gray.allocPixels(src.info().makeColorType(kGray_8_SkColorType));
+    REPORTER_ASSERT(r, src.readPixels(gray.pixmap()));
+
+    for (const SkBitmap& bitmap : {src, gray}) {
+        // Encoding on an executor separates bands of the image with restart markers.
+        SkJpegEncoder::Options encodeOptions;
+        encodeOptions.fExecutor = executor.get();
+        SkDynamicMemoryWStream stream;
+        REPORTER_ASSERT(r, SkJpegEncoder::Encode(&stream, bitmap.pixmap(), encodeOptions));
+        sk_sp<SkData> data = stream.detachAsData();
+
+        auto codec = SkCodec::MakeFromData(data);
+        REPORTER_ASSERT(r, codec);
+        if (!codec) {
+            return;
+        }
+        const SkImageInfo infos[] = {
+            codec->getInfo(),
+            codec->getInfo().makeColorType(kRGB_565_SkColorType),
+            codec->getInfo().makeColorType(kRGBA_F16_SkColorType)
+                            .makeColorSpace(SkColorSpace::MakeSRGBLinear()),
+            codec->getInfo().makeDimensions(codec->getScaledDimensions(0.5f)),
+        };
+        for (const SkImageInfo& info : infos) {
+            SkBitmap expected, actual;
+            expected.allocPixels(info);
+            actual.allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                               codec->getPixels(info, expected.getPixels(), expected.rowBytes()));
+
+            SkCodec::Options options;
+            options.fExecutor = executor.get();
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, actual.getPixels(),
+                                                                     actual.rowBytes(), &options));
+            REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual));
+        }
+    }
+}
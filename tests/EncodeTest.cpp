@@ -15,9 +15,11 @@
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkStream.h"
@@ -230,6 +232,59 @@ DEF_TEST(Encode_JpegDownsample, r) {
     REPORTER_ASSERT(r, almost_equals(bm1, bm2, 60));
 }
 
+DEF_TEST(Encode_JpegExecutor, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // Large enough to be split into several bands, with sizes that aren't a multiple of any MCU.
+    const SkImageInfo infos[] = {
+        SkImageInfo::MakeN32(700, 900, kOpaque_SkAlphaType),
+        SkImageInfo::Make(517, 999, kGray_8_SkColorType, kOpaque_SkAlphaType),
+    };
+    const SkJpegEncoder::Downsample downsamples[] = {
+        SkJpegEncoder::Downsample::k420,
+        SkJpegEncoder::Downsample::k422,
+        SkJpegEncoder::Downsample::k444,
+    };
+    for (const SkImageInfo& info : infos) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(info);
+        bitmap.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        for (int i = 0; i < 40; ++i) {
+            paint.setColor(SkColorSetRGB(17 * i, 255 - 5 * i, 31 * i));
+            canvas.drawCircle(15.0f * i, 20.0f * i, 10.0f + 4 * i, paint);
+        }
+
+        for (SkJpegEncoder::Downsample downsample : downsamples) {
+            SkJpegEncoder::Options options;
+            options.fQuality = 90;
+            options.fDownsample = downsample;
+
+            SkDynamicMemoryWStream serial, threaded;
+            REPORTER_ASSERT(r, SkJpegEncoder::Encode(&serial, bitmap.pixmap(), options));
+            options.fExecutor = executor.get();
+            REPORTER_ASSERT(r, SkJpegEncoder::Encode(&threaded, bitmap.pixmap(), options));
+
+            // The bands use the standard Huffman tables rather than optimized ones, but the
+            // coefficients, and so the decoded pixels, are the same.
+            SkBitmap expected, actual;
+            auto serialImage = SkImage::MakeFromEncoded(serial.detachAsData());
+            auto threadedImage = SkImage::MakeFromEncoded(threaded.detachAsData());
+            REPORTER_ASSERT(r, serialImage && threadedImage);
+            if (!serialImage || !threadedImage) {
+                return;
+            }
+            // Gray jpegs decode to kGray_8, so compare them as N32.
+            expected.allocN32Pixels(info.width(), info.height());
+            actual.allocN32Pixels(info.width(), info.height());
+            REPORTER_ASSERT(r, serialImage->readPixels(nullptr, expected.pixmap(), 0, 0));
+            REPORTER_ASSERT(r, threadedImage->readPixels(nullptr, actual.pixmap(), 0, 0));
+            REPORTER_ASSERT(r, almost_equals(expected, actual, 0));
+        }
+    }
+}
+
 static inline void pushComment(
         std::vector<std::string>& comments, const char* keyword, const char* text) {
     comments.push_back(keyword);
@@ -344,6 +399,56 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+// Encoding in strips on an executor must still produce a png that decodes to the same pixels.
+DEF_TEST(Encode_PngExecutor, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // Tall enough to be split into several strips, and for the F16 opaque case to test dropping
+    // alpha from 16-bit rows.
+    const SkImageInfo infos[] = {
+        SkImageInfo::MakeN32(600, 900, kPremul_SkAlphaType),
+        SkImageInfo::MakeN32(600, 900, kOpaque_SkAlphaType),
+        SkImageInfo::Make(300, 700, kRGBA_F16_SkColorType, kOpaque_SkAlphaType),
+    };
+    const SkPngEncoder::FilterFlag filters[] = {
+        SkPngEncoder::FilterFlag::kAll,
+        SkPngEncoder::FilterFlag::kNone,
+        SkPngEncoder::FilterFlag::kPaeth,
+    };
+    for (const SkImageInfo& info : infos) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(info);
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        for (int i = 0; i < 40; ++i) {
+            paint.setColor(SkColorSetARGB(0x80 + 3 * i, 17 * i, 255 - 5 * i, 31 * i));
+            canvas.drawCircle(15.0f * i, 20.0f * i, 10.0f + 4 * i, paint);
+        }
+
+        for (SkPngEncoder::FilterFlag filter : filters) {
+            SkPngEncoder::Options options;
+            options.fFilterFlags = filter;
+
+            SkDynamicMemoryWStream serial, threaded;
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, bitmap.pixmap(), options));
+            options.fExecutor = executor.get();
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&threaded, bitmap.pixmap(), options));
+
+            SkBitmap expected, actual;
+            auto serialImage = SkImage::MakeFromEncoded(serial.detachAsData());
+            auto threadedImage = SkImage::MakeFromEncoded(threaded.detachAsData());
+            REPORTER_ASSERT(r, serialImage && threadedImage);
+            if (!serialImage || !threadedImage) {
+                return;
+            }
+            serialImage->asLegacyBitmap(&expected);
+            threadedImage->asLegacyBitmap(&actual);
+            REPORTER_ASSERT(r, almost_equals(expected, actual, 0));
+        }
+    }
+}
+
 #ifndef SK_BUILD_FOR_GOOGLE3
 DEF_TEST(Encode_WebpQuality, r) {
     SkBitmap bm;
@@ -14,6 +14,7 @@
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkImage.h"
@@ -868,6 +869,57 @@ DEF_TEST(ImageFilterDrawTiled, reporter) {
     }
 }
 
+// Draws a filter result into a bitmap covering 'bounds', so results with different origins and
+// sizes can be compared pixel by pixel.
+static SkBitmap draw_filter_result(const skif::FilterResult& result, const SkIRect& bounds) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(bounds.width(), bounds.height());
+    SkCanvas canvas(bitmap);
+    canvas.clear(SK_ColorTRANSPARENT);
+    SkIPoint offset;
+    if (sk_sp<SkSpecialImage> image = result.imageAndOffset(&offset)) {
+        image->draw(&canvas, offset.fX - bounds.fLeft, offset.fY - bounds.fTop);
+    }
+    return bitmap;
+}
+
+DEF_TEST(ImageFilterExecutorTilesMatchSerial, reporter) {
+    // Check that filter DAGs evaluated in tiles on an executor exactly match the same DAGs
+    // evaluated serially, including DAGs that mix tileable and non-tileable nodes.
+    static constexpr int kWidth = 700, kHeight = 530;
+    sk_sp<SkImage> gradient = make_gradient_circle(kWidth, kHeight).asImage();
+    sk_sp<SkSpecialImage> source = SkSpecialImage::MakeFromImage(
+            nullptr, SkIRect::MakeWH(kWidth, kHeight), gradient, SkSurfaceProps());
+
+    sk_sp<SkImageFilter> blur = SkImageFilters::Blur(6, 9, nullptr);
+    sk_sp<SkColorFilter> cf = SkColorFilters::Blend(SK_ColorRED, SkBlendMode::kSrcIn);
+    sk_sp<SkImageFilter> filters[] = {
+        blur,
+        SkImageFilters::Dilate(4, 2, blur),
+        SkImageFilters::DisplacementMap(SkColorChannel::kR, SkColorChannel::kG, 30, nullptr,
+                                        SkImageFilters::Erode(3, 3, nullptr)),
+        SkImageFilters::ColorFilter(
+                cf, SkImageFilters::Merge(blur, SkImageFilters::Erode(2, 5, nullptr))),
+        // Lighting can't be tiled, but its blurred input still can be.
+        SkImageFilters::DistantLitDiffuse({1, 1, 1}, SK_ColorWHITE, 2, 1, blur),
+    };
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    const SkIRect clip = SkIRect::MakeLTRB(13, 7, kWidth - 20, kHeight - 3);
+    for (const sk_sp<SkImageFilter>& filter : filters) {
+        SkImageFilter_Base::Context ctx(SkMatrix::I(), clip, nullptr, kN32_SkColorType, nullptr,
+                                        source.get());
+        skif::FilterResult serial = as_IFB(filter)->filterImage(ctx);
+        skif::FilterResult tiled =
+                as_IFB(filter)->filterImage(ctx.withExecutor(executor.get()));
+        REPORTER_ASSERT(reporter, SkToBool(serial) == SkToBool(tiled));
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(draw_filter_result(serial, clip),
+                                                          draw_filter_result(tiled, clip)));
+    }
+    REPORTER_ASSERT(reporter, as_IFB(filters[1])->canFilterInTiles());
+    REPORTER_ASSERT(reporter, !as_IFB(filters[4])->canFilterInTiles());
+}
+
 static void draw_saveLayer_picture(int width, int height, int tileSize,
                                    SkBBHFactory* factory, SkBitmap* result) {
 
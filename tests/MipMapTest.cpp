@@ -10,8 +10,10 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkPixelRef.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
@@ -27,6 +29,9 @@
 #include "tests/Test.h"
 #include "tools/Resources.h"
 
+#include <cstring>
+#include <memory>
+
 static void make_bitmap(SkBitmap* bm, int width, int height) {
     bm->allocN32Pixels(width, height);
     bm->eraseColor(SK_ColorWHITE);
@@ -227,6 +232,104 @@ DEF_TEST(MipMap_F16, reporter) {
     sk_sp<SkMipmap> mipmap(SkMipmap::Build(bmp, nullptr));
 }
 
+static bool levels_equal(const SkMipmap::Level& a, const SkMipmap::Level& b) {
+    if (a.fPixmap.dimensions() != b.fPixmap.dimensions()) {
+        return false;
+    }
+    const size_t rowBytes = a.fPixmap.info().minRowBytes();
+    for (int y = 0; y < a.fPixmap.height(); ++y) {
+        if (0 != memcmp(a.fPixmap.addr(0, y), b.fPixmap.addr(0, y), rowBytes)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Filtering levels in bands on an executor, or lazily as they're asked for, must produce exactly
+// the same pixels as building the whole chain serially.
+DEF_TEST(MipMap_BandedAndLazy, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // Big enough that the first few levels are split into several bands.
+    const SkISize sizes[] = {{1200, 1100}, {1025, 1023}};
+    const SkColorType colorTypes[] = {kRGBA_8888_SkColorType, kRGBA_F16_SkColorType,
+                                      kAlpha_8_SkColorType};
+    for (SkISize size : sizes) {
+        for (SkColorType ct : colorTypes) {
+            SkBitmap bm;
+            bm.allocPixels(SkImageInfo::Make(size, ct, kPremul_SkAlphaType));
+            bm.eraseColor(SK_ColorTRANSPARENT);  // an odd-width A8 row has one byte left over
+            SkRandom rand;
+            for (int y = 0; y < bm.height(); ++y) {
+                auto row = static_cast<uint16_t*>(bm.pixmap().writable_addr(0, y));
+                for (size_t i = 0; i < bm.info().minRowBytes() / 2; ++i) {
+                    // For F16, keep every half finite and normal.
+                    row[i] = ct == kRGBA_F16_SkColorType ? 0x3000 | (rand.nextU() & 0x0FFF)
+                                                         : rand.nextU() & 0xFFFF;
+                }
+            }
+
+            sk_sp<SkMipmap> serial(SkMipmap::Build(bm, nullptr));
+
+            SkMipmap::BuildOptions bandedOptions;
+            bandedOptions.fExecutor = executor.get();
+            sk_sp<SkMipmap> banded(SkMipmap::Build(bm, nullptr, bandedOptions));
+
+            SkMipmap::BuildOptions lazyOptions;
+            lazyOptions.fLazy = true;
+            sk_sp<SkMipmap> lazy(SkMipmap::Build(bm, nullptr, lazyOptions));
+
+            REPORTER_ASSERT(reporter, serial && banded && lazy);
+            REPORTER_ASSERT(reporter, lazy->countLevels() == serial->countLevels());
+
+            // Ask for the lazy levels smallest first, so each request fills the chain above it.
+            for (int i = serial->countLevels() - 1; i >= 0; --i) {
+                SkMipmap::Level expected, actual;
+                REPORTER_ASSERT(reporter, serial->getLevel(i, &expected));
+                REPORTER_ASSERT(reporter, banded->getLevel(i, &actual));
+                REPORTER_ASSERT(reporter, levels_equal(expected, actual), "banded level %d", i);
+                REPORTER_ASSERT(reporter, lazy->getLevel(i, &actual));
+                REPORTER_ASSERT(reporter, levels_equal(expected, actual), "lazy level %d", i);
+            }
+
+            // The 2x2 filters are vectorized; check one against a plain box filter.
+            if (ct == kRGBA_8888_SkColorType && size.width() % 2 == 0 && size.height() % 2 == 0) {
+                SkMipmap::Level level;
+                REPORTER_ASSERT(reporter, serial->getLevel(0, &level));
+                bool matches = true;
+                for (int y = 0; y < level.fPixmap.height(); ++y)
+                for (int x = 0; x < level.fPixmap.width(); ++x) {
+                    auto dst = static_cast<const uint8_t*>(level.fPixmap.addr(x, y));
+                    auto p0 = static_cast<const uint8_t*>(bm.pixmap().addr(2 * x, 2 * y));
+                    auto p1 = static_cast<const uint8_t*>(bm.pixmap().addr(2 * x, 2 * y + 1));
+                    for (int c = 0; c < 4; ++c) {
+                        matches &= dst[c] == ((p0[c] + p0[4 + c] + p1[c] + p1[4 + c]) >> 2);
+                    }
+                }
+                REPORTER_ASSERT(reporter, matches);
+            }
+        }
+    }
+}
+
+// A lazy mipmap only holds on to the base pixels until level 0 has been filtered from them.
+DEF_TEST(MipMap_LazyReleasesBase, reporter) {
+    SkBitmap bm;
+    bm.allocN32Pixels(64, 64);
+    bm.eraseColor(SK_ColorRED);
+
+    SkMipmap::BuildOptions options;
+    options.fLazy = true;
+    sk_sp<SkMipmap> mipmap(SkMipmap::Build(bm, nullptr, options));
+    REPORTER_ASSERT(reporter, mipmap);
+    REPORTER_ASSERT(reporter, !bm.pixelRef()->unique());
+
+    SkMipmap::Level level;
+    REPORTER_ASSERT(reporter, mipmap->getLevel(0, &level));
+    REPORTER_ASSERT(reporter, bm.pixelRef()->unique());
+    REPORTER_ASSERT(reporter, level.fPixmap.getColor(0, 0) == SK_ColorRED);
+}
+
 static void fill_in_mips(SkMipmapBuilder* builder, sk_sp<SkImage> img) {
     int count = builder->countLevels();
     for (int i = 0; i < count; ++i) {
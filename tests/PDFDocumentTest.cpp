@@ -4,6 +4,7 @@
  * Use of this source code is governed by a BSD-style license that can be
  * found in the LICENSE file.
  */
+#include "include/core/SkAnnotation.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
@@ -13,17 +14,27 @@
 #include "include/core/SkFont.h"
 #include "include/core/SkImage.h" // IWYU pragma: keep
 #include "include/core/SkPaint.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/docs/SkPDFDocument.h"
+#include "include/effects/SkGradientShader.h"
+#include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/utils/SkOSPath.h"
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
 
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <memory>
+#include <vector>
 
 static void test_empty(skiatest::Reporter* reporter) {
     SkDynamicMemoryWStream stream;
@@ -264,3 +275,182 @@ DEF_TEST(SkPDF_abort_jobs, rep) {
     doc->abort();
 }
 
+
+namespace {
+// Runs each task as soon as it is added, so the document's output does not depend on timing.
+class InlineExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> work) override { work(); }
+};
+}  // namespace
+
+static std::vector<sk_sp<SkPicture>> make_pages(int n) {
+    SkBitmap bm;
+    bm.allocN32Pixels(64, 64);
+    bm.eraseColor(0xFF3366CC);
+    sk_sp<SkImage> image = bm.asImage();
+    SkFont font(ToolUtils::create_portable_typeface(), 24);
+
+    std::vector<sk_sp<SkPicture>> pages;
+    for (int i = 0; i < n; ++i) {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(612, 792));
+        SkPaint paint;
+        paint.setColor(SkColorSetARGB(0x80, 0x00, (uint8_t)(255.0f * i / (n - 1)), 0x00));
+        canvas->drawRect({36, 36, 576, 300}, paint);
+        SkString text;
+        text.printf("Page %d", i % 3);
+        canvas->drawString(text, 72, 400, font, SkPaint());
+        canvas->drawImage(image, 72, 500);
+        if (i % 4 == 3) {
+            const SkPoint points[] = {{0, 0}, {612, 0}};
+            const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+            SkPaint gradient;
+            gradient.setShader(SkGradientShader::MakeLinear(points, colors, nullptr, 2,
+                                                            SkTileMode::kClamp));
+            canvas->drawRect({36, 600, 576, 700}, gradient);
+        }
+        if (i % 5 == 4) {
+            sk_sp<SkData> url = SkData::MakeWithCString("https://skia.org/");
+            SkAnnotateRectWithURL(canvas, {72, 380, 200, 410}, url.get());
+        }
+        pages.push_back(recorder.finishRecordingAsPicture());
+    }
+    return pages;
+}
+
+// Drawing pages at once on an executor writes the same objects, with the same numbers, as drawing
+// them one at a time.
+DEF_TEST(SkPDF_drawPages, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_drawPages, r);
+    const std::vector<sk_sp<SkPicture>> pages = make_pages(40);
+
+    SkDynamicMemoryWStream serial;
+    {
+        auto doc = SkPDF::MakeDocument(&serial);
+        for (const sk_sp<SkPicture>& page : pages) {
+            doc->beginPage(612, 792)->drawPicture(page);
+            doc->endPage();
+        }
+    }
+    sk_sp<SkData> expected = serial.detachAsData();
+
+    InlineExecutor inlineExecutor;
+    std::unique_ptr<SkExecutor> pool = SkExecutor::MakeFIFOThreadPool(4);
+    for (SkExecutor* executor : {(SkExecutor*)&inlineExecutor, pool.get()}) {
+        SkPDF::Metadata metadata;
+        metadata.fExecutor = executor;
+        SkDynamicMemoryWStream stream;
+        {
+            auto doc = SkPDF::MakeDocument(&stream, metadata);
+            doc->drawPages(pages);
+            // At least some pages must be drawn ahead, or this only tests the serial path.
+            REPORTER_ASSERT(r, static_cast<SkPDFDocument*>(doc.get())
+                                       ->pagesDrawnAheadForTesting() > 0);
+        }
+        sk_sp<SkData> data = stream.detachAsData();
+        // Streams compressed on a thread pool are written in the order they finish.
+        REPORTER_ASSERT(r, data->size() == expected->size());
+        if (executor == &inlineExecutor) {
+            REPORTER_ASSERT(r, data->equals(expected.get()));
+        }
+    }
+}
+
+DEF_TEST(SkPDF_object_streams, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_object_streams, r);
+    const std::vector<sk_sp<SkPicture>> pages = make_pages(40);
+
+    auto write = [&](bool objectStreams, SkExecutor* executor) {
+        SkPDF::Metadata metadata;
+        metadata.fObjectStreams = objectStreams;
+        metadata.fExecutor = executor;
+        SkDynamicMemoryWStream stream;
+        {
+            auto doc = SkPDF::MakeDocument(&stream, metadata);
+            for (const sk_sp<SkPicture>& page : pages) {
+                doc->beginPage(612, 792)->drawPicture(page);
+                doc->endPage();
+            }
+        }
+        return stream.detachAsData();
+    };
+    sk_sp<SkData> table = write(false, nullptr);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (SkExecutor* e : {(SkExecutor*)nullptr, executor.get()}) {
+        sk_sp<SkData> data = write(true, e);
+        REPORTER_ASSERT(r, data->size() < table->size());
+        for (const char* expectation : {"%PDF-1.5\n", "/Type /ObjStm", "/Type /XRef"}) {
+            if (!contains(data->bytes(), data->size(), expectation)) {
+                ERRORF(r, "PDF expectation missing: '%s'.", expectation);
+            }
+        }
+        REPORTER_ASSERT(r, !contains(data->bytes(), data->size(), "\ntrailer\n"));
+
+        // startxref points at the cross-reference stream.
+        const char* text = (const char*)data->data();
+        const char kStartXRef[] = "startxref\n";
+        const char* startXRef = nullptr;
+        for (size_t i = data->size() - strlen(kStartXRef); i-- > 0;) {
+            if (0 == memcmp(text + i, kStartXRef, strlen(kStartXRef))) {
+                startXRef = text + i;
+                break;
+            }
+        }
+        if (!startXRef) {
+            ERRORF(r, "startxref missing.");
+            continue;
+        }
+        size_t offset = (size_t)atol(startXRef + strlen(kStartXRef));
+        REPORTER_ASSERT(r, offset < data->size());
+        const char* object = text + offset;
+        const char* objectEnd = strstr(object, " 0 obj\n");
+        REPORTER_ASSERT(r, objectEnd && objectEnd < startXRef);
+        REPORTER_ASSERT(r, objectEnd && 0 == strncmp(objectEnd + strlen(" 0 obj\n"), "<</", 3));
+    }
+}
+
+static int count(const SkData& data, const char needle[]) {
+    int n = 0;
+    const size_t len = strlen(needle);
+    for (size_t i = 0; i + len <= data.size(); ++i) {
+        n += 0 == memcmp(data.bytes() + i, needle, len);
+    }
+    return n;
+}
+
+DEF_TEST(SkPDF_deduplicate_by_content, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_deduplicate_by_content, r);
+    constexpr int kPages = 10;
+    auto write = [&](bool deduplicate) {
+        SkPDF::Metadata metadata;
+        metadata.fDeduplicateByContent = deduplicate;
+        SkDynamicMemoryWStream stream;
+        {
+            auto doc = SkPDF::MakeDocument(&stream, metadata);
+            for (int i = 0; i < kPages; ++i) {
+                // The same logo, but a new SkImage on every page.
+                SkBitmap logo;
+                logo.allocN32Pixels(32, 32);
+                logo.eraseColor(SK_ColorBLUE);
+                logo.erase(SK_ColorYELLOW, SkIRect::MakeXYWH(8, 8, 16, 16));
+
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                canvas->drawImage(logo.asImage(), 36, 36);
+                canvas->saveLayerAlphaf(nullptr, 0.5f);
+                canvas->drawRect({100, 100, 200, 200}, SkPaint());
+                canvas->restore();
+                doc->endPage();
+            }
+        }
+        return stream.detachAsData();
+    };
+
+    sk_sp<SkData> each = write(false);
+    sk_sp<SkData> once = write(true);
+    REPORTER_ASSERT(r, count(*each, "/Subtype /Image") == kPages);
+    REPORTER_ASSERT(r, count(*once, "/Subtype /Image") == 1);
+    REPORTER_ASSERT(r, count(*once, "/Subtype /Form") < count(*each, "/Subtype /Form"));
+    REPORTER_ASSERT(r, once->size() < each->size());
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkData.h"
+#include "include/core/SkDocument.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkStream.h"
+#include "include/docs/SkPDFDocument.h"
+#include "include/encode/SkPngEncoder.h"
+#include "src/pdf/SkPngInfo.h"
+#include "tests/Test.h"
+
+#include <cstring>
+
+static sk_sp<SkData> encode_png(const SkImageInfo& info, SkColor color) {
+    SkBitmap bm;
+    bm.allocPixels(info);
+    bm.eraseColor(color);
+    bm.erase(SK_ColorBLACK, SkIRect::MakeXYWH(8, 8, 16, 16));
+
+    SkDynamicMemoryWStream stream;
+    if (!SkPngEncoder::Encode(&stream, bm.pixmap(), SkPngEncoder::Options())) {
+        return nullptr;
+    }
+    return stream.detachAsData();
+}
+
+static bool contains(const SkData* data, const void* bytes, size_t size) {
+    for (size_t i = 0; i + size <= data->size(); ++i) {
+        if (0 == memcmp(data->bytes() + i, bytes, size)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+DEF_TEST(SkPDF_PngInfo, r) {
+    struct {
+        SkImageInfo fInfo;
+        bool        fPassThrough;
+        int         fColors;
+    } tests[] = {
+        {SkImageInfo::MakeN32(64, 48, kOpaque_SkAlphaType),                   true,  3},
+        {SkImageInfo::Make(64, 48, kGray_8_SkColorType, kOpaque_SkAlphaType), true,  1},
+        {SkImageInfo::MakeN32Premul(64, 48),                                  false, 0},
+    };
+    for (const auto& test : tests) {
+        sk_sp<SkData> png = encode_png(test.fInfo, 0x80336699);
+        if (!png) {
+            ERRORF(r, "Could not encode PNG.");
+            continue;
+        }
+        SkISize size;
+        int colors;
+        SkDynamicMemoryWStream idat;
+        bool passThrough = SkGetPngInfo(png->data(), png->size(), &size, &colors, &idat);
+        REPORTER_ASSERT(r, passThrough == test.fPassThrough);
+        if (passThrough) {
+            REPORTER_ASSERT(r, size == test.fInfo.dimensions());
+            REPORTER_ASSERT(r, colors == test.fColors);
+            REPORTER_ASSERT(r, idat.bytesWritten() > 0);
+        }
+
+        // Truncated PNGs are never passed through.
+        REPORTER_ASSERT(r, !SkGetPngInfo(png->data(), png->size() - 12, &size, &colors, nullptr));
+    }
+    REPORTER_ASSERT(r, !SkGetPngInfo("not a png", 9, nullptr, nullptr, nullptr));
+}
+
+/**
+ *  Test that opaque 8-bit PNGs are embedded in the PDF without being decoded and compressed
+ *  again, and that PNGs with alpha still are.
+ */
+DEF_TEST(SkPDF_PngEmbedTest, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_PngEmbedTest, r);
+    sk_sp<SkData> opaque = encode_png(SkImageInfo::MakeN32(64, 48, kOpaque_SkAlphaType),
+                                      SK_ColorCYAN);
+    sk_sp<SkData> alpha = encode_png(SkImageInfo::MakeN32Premul(64, 48), 0x80336699);
+    if (!opaque || !alpha) {
+        ERRORF(r, "Could not encode PNG.");
+        return;
+    }
+
+    SkDynamicMemoryWStream pdf;
+    auto document = SkPDF::MakeDocument(&pdf);
+    SkCanvas* canvas = document->beginPage(200, 200);
+    canvas->drawImage(SkImage::MakeFromEncoded(opaque), 0, 0);
+    canvas->drawImage(SkImage::MakeFromEncoded(alpha), 0, 100);
+    document->endPage();
+    document->close();
+    sk_sp<SkData> pdfData = pdf.detachAsData();
+
+    SkISize size;
+    int colors;
+    SkDynamicMemoryWStream idat;
+    REPORTER_ASSERT(r, SkGetPngInfo(opaque->data(), opaque->size(), &size, &colors, &idat));
+    sk_sp<SkData> idatData = idat.detachAsData();
+    REPORTER_ASSERT(r, contains(pdfData.get(), idatData->data(), idatData->size()));
+    const char kDecodeParms[] =
+            "/DecodeParms <</Predictor 15\n/Colors 3\n/BitsPerComponent 8\n/Columns 64>>";
+    REPORTER_ASSERT(r, contains(pdfData.get(), kDecodeParms, strlen(kDecodeParms)));
+
+    // The image with alpha is split into color and an SMask, without predictors.
+    REPORTER_ASSERT(r, contains(pdfData.get(), "/SMask", 6));
+    const char kPredictor[] = "/Predictor";
+    size_t predictors = 0;
+    for (size_t i = 0; i + strlen(kPredictor) <= pdfData->size(); ++i) {
+        if (0 == memcmp(pdfData->bytes() + i, kPredictor, strlen(kPredictor))) {
+            predictors++;
+        }
+    }
+    REPORTER_ASSERT(r, predictors == 1);
+}
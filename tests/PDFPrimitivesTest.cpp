@@ -12,6 +12,7 @@
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkData.h"
 #include "include/core/SkDocument.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkFont.h"
@@ -27,6 +28,7 @@
 #include "include/core/SkSpan.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
+#include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
 #include "include/docs/SkPDFDocument.h"
 #include "include/effects/SkImageFilters.h"
@@ -36,10 +38,13 @@
 #include "include/utils/SkRandom.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkResourceCache.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/pdf/SkClusterator.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFFont.h"
+#include "src/pdf/SkPDFGlyphUse.h"
+#include "src/pdf/SkPDFSubsetFont.h"
 #include "src/pdf/SkPDFTypes.h"
 #include "src/pdf/SkPDFUnion.h"
 #include "src/pdf/SkPDFUtils.h"
@@ -342,6 +347,50 @@ DEF_TEST(SkPDF_FontCanEmbedTypeface, reporter) {
                     SkPDFFont::CanEmbedTypeface(portableTypeface.get(), &doc));
 }
 
+// Subsets of a typeface with the same glyphs are shared, even across documents.
+DEF_TEST(SkPDF_SubsetFontCache, reporter) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        INFOF(reporter, "Resource 'fonts/Roboto-Regular.ttf' can not be found.");
+        return;
+    }
+    const auto subsetter = SkPDF::Metadata().fSubsetter;
+    SkPDFGlyphUse glyphs(1, SkToU16(typeface->countGlyphs() - 1));
+    glyphs.set(36);
+    glyphs.set(37);
+
+    SkResourceCache cache(1024 * 1024);
+    sk_sp<SkData> subset = SkPDFSubsetFont(*typeface, glyphs, subsetter, "Roboto", &cache);
+    if (!subset) {
+        INFOF(reporter, "No PDF font subsetter.");
+        return;
+    }
+    REPORTER_ASSERT(reporter, cache.stats().fMisses == 1);
+    REPORTER_ASSERT(reporter, cache.stats().fHits == 0);
+
+    // The cached subset is the same one subsetting the font's data makes.
+    int ttcIndex;
+    std::unique_ptr<SkStreamAsset> fontAsset = typeface->openStream(&ttcIndex);
+    REPORTER_ASSERT(reporter, fontAsset);
+    sk_sp<SkData> uncached = SkPDFSubsetFont(SkData::MakeFromStream(fontAsset.get(),
+                                                                    fontAsset->getLength()),
+                                             glyphs, subsetter, "Roboto", ttcIndex);
+    REPORTER_ASSERT(reporter, uncached && uncached->equals(subset.get()));
+
+    sk_sp<SkData> again = SkPDFSubsetFont(*typeface, glyphs, subsetter, "Roboto", &cache);
+    REPORTER_ASSERT(reporter, cache.stats().fHits == 1);
+    REPORTER_ASSERT(reporter, again == subset);
+
+    glyphs.set(38);
+    sk_sp<SkData> larger = SkPDFSubsetFont(*typeface, glyphs, subsetter, "Roboto", &cache);
+    REPORTER_ASSERT(reporter, cache.stats().fMisses == 2);
+    REPORTER_ASSERT(reporter, larger && !larger->equals(subset.get()));
+
+    // The global cache may purge at any time, but always hands back the same bytes.
+    sk_sp<SkData> global = SkPDFSubsetFont(*typeface, glyphs, subsetter, "Roboto");
+    REPORTER_ASSERT(reporter, global && global->equals(larger.get()));
+}
+
 
 // test to see that all finite scalars round trip via scanf().
 static void check_pdf_scalar_serialization(
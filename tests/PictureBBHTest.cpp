@@ -111,7 +111,8 @@ DEF_TEST(PictureNegativeSpace, r) {
             canvas->drawRect({-20,-20,-10,-10}, SkPaint{});
             canvas->restore();
         auto pic = recorder.finishRecordingAsPicture();
-        REPORTER_ASSERT(r, pic->approximateOpCount() == 5);
+        // The first drawRect is hidden by the second and optimized away.
+        REPORTER_ASSERT(r, pic->approximateOpCount() == 4);
         REPORTER_ASSERT(r, pic->cullRect() == (SkRect{-20,-20,-10,-10}));
     }
 
@@ -121,7 +122,7 @@ DEF_TEST(PictureNegativeSpace, r) {
             canvas->drawRect({-20,-20,-10,-10}, SkPaint{});
             canvas->drawRect({-20,-20,-10,-10}, SkPaint{});
         auto pic = recorder.finishRecordingAsPicture();
-        REPORTER_ASSERT(r, pic->approximateOpCount() == 3);
+        REPORTER_ASSERT(r, pic->approximateOpCount() == 2);
         REPORTER_ASSERT(r, pic->cullRect() == (SkRect{-20,-20,-10,-10}));
     }
 }
@@ -11,9 +11,11 @@
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkImage.h" // IWYU pragma: keep
+#include "include/core/SkImageGenerator.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
@@ -35,7 +37,10 @@
 #include "src/core/SkRectPriv.h"
 #include "tests/Test.h"
 
+#include <atomic>
 #include <cstddef>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -921,7 +926,8 @@ DEF_TEST(Picture_nested_op_count, r) {
             if (pic) {
                 c->drawPicture(pic);
             } else {
-                c->drawRect({0,0, 100,100}, SkPaint{});
+                // Translucent, so SkRecordOptimize() can't drop rects hidden by later ones.
+                c->drawRect({0,0, 100,100}, SkPaint{SkColor4f{0, 0, 0, 0.5f}});
             }
         }
         return rec.finishRecordingAsPicture();
@@ -945,3 +951,192 @@ DEF_TEST(Picture_nested_op_count, r) {
     check(make_pic(10, leaf1),  10,  10);
     check(make_pic(10, leaf10), 10, 100);
 }
+
+DEF_TEST(Picture_playbackInBands, r) {
+    // Lines of anti-aliased shapes with gaps between them, like lines of text on a page, over a
+    // background and a few axis-aligned rects and clips that span the whole page.
+    auto record = [](bool withLayer) {
+        SkRTreeFactory factory;
+        SkPictureRecorder rec;
+        SkCanvas* c = rec.beginRecording({0,0, 200,300}, &factory);
+        c->drawColor(SK_ColorWHITE);
+        c->drawRect({20, 0, 30, 300}, SkPaint(SkColors::kGreen));
+        c->clipRect({5.5f, 0, 195.5f, 300}, /*doAntiAlias=*/true);
+
+        SkRandom rand;
+        for (int line = 0; line < 10; line++) {
+            const SkScalar top = line * 30.0f;
+            for (int i = 0; i < 12; i++) {
+                SkPaint paint;
+                paint.setColor(rand.nextU() | 0x80000000);
+                paint.setAntiAlias(true);
+                const SkScalar x = rand.nextRangeScalar(0, 190);
+                const SkRect rect = SkRect::MakeXYWH(x, top + rand.nextRangeScalar(0, 4),
+                                                     rand.nextRangeScalar(2, 12),
+                                                     rand.nextRangeScalar(4, 12));
+                if (i % 3 == 0) {
+                    c->drawOval(rect, paint);
+                } else if (i % 3 == 1) {
+                    paint.setStyle(SkPaint::kStroke_Style);
+                    paint.setStrokeWidth(rand.nextRangeScalar(0, 2));
+                    c->drawRect(rect, paint);
+                } else {
+                    c->save();
+                    c->rotate(rand.nextRangeScalar(0, 90), rect.centerX(), rect.centerY());
+                    c->drawRect(rect, paint);
+                    c->restore();
+                }
+            }
+        }
+        // One shape that crosses several lines.
+        c->drawCircle(100, 150, 45, SkPaint(SkColor4f{0, 0, 1, 0.5f}));
+
+        if (withLayer) {
+            c->saveLayerAlphaf(nullptr, 0.5f);
+            c->drawRect({10, 10, 190, 290}, SkPaint{});
+            c->restore();
+        }
+        return rec.finishRecordingAsPicture();
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const SkMatrix matrix = SkMatrix::Scale(1.25f, 0.8f);
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(250, 240);
+
+    for (bool withLayer : {false, true}) {
+        sk_sp<SkPicture> pic = record(withLayer);
+        const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(pic);
+        REPORTER_ASSERT(r, big);
+        REPORTER_ASSERT(r, big->drawsLayers() == withLayer);
+
+        // The page splits between the lines, but not through the circle.
+        std::vector<int> cuts = big->bandCuts(matrix, info.dimensions(), 8);
+        REPORTER_ASSERT(r, cuts.size() >= 4);
+        for (int cut : cuts) {
+            REPORTER_ASSERT(r, cut <= 84 || cut >= 156, "cut at %d", cut);
+        }
+
+        SkBitmap serial;
+        serial.allocPixels(info);
+        SkCanvas canvas(serial);
+        canvas.concat(matrix);
+        pic->playback(&canvas);
+
+        for (int bands : {1, 3, 8, 1000}) {
+            SkBitmap banded;
+            banded.allocPixels(info);
+            REPORTER_ASSERT(r, pic->playbackInBands(banded.pixmap(), &matrix,
+                                                    executor.get(), bands));
+            REPORTER_ASSERT(r, !memcmp(serial.getPixels(), banded.getPixels(),
+                                       serial.computeByteSize()),
+                            "withLayer=%d bands=%d", withLayer, bands);
+        }
+    }
+
+    SkPixmap unknown(SkImageInfo::MakeUnknown(10, 10), nullptr, 0);
+    REPORTER_ASSERT(r, !record(false)->playbackInBands(unknown, nullptr, executor.get(), 4));
+}
+
+namespace {
+// Fills with a solid color, counting how many times it has been asked for pixels.
+class CountingGenerator : public SkImageGenerator {
+public:
+    CountingGenerator(SkColor color, std::atomic<int>* calls, int size = 20)
+        : SkImageGenerator(SkImageInfo::MakeN32Premul(size, size))
+        , fColor(color)
+        , fCalls(calls) {}
+
+protected:
+    bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                     const Options&) override {
+        (*fCalls)++;
+        SkBitmap bm;
+        bm.installPixels(info, pixels, rowBytes);
+        bm.eraseColor(fColor);
+        return true;
+    }
+
+private:
+    SkColor           fColor;
+    std::atomic<int>* fCalls;
+};
+
+// Runs work on the calling thread as soon as it is added, counting how much it was given.
+class InlineExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> work) override {
+        fAdded++;
+        work();
+    }
+
+    int fAdded = 0;
+};
+}  // namespace
+
+DEF_TEST(Picture_decodeImagesAhead, r) {
+    std::atomic<int> calls[2] = {{0}, {0}};
+    sk_sp<SkImage> images[2];
+    for (int i = 0; i < 2; i++) {
+        images[i] = SkImage::MakeFromGenerator(std::make_unique<CountingGenerator>(
+                i ? SK_ColorBLUE : SK_ColorRED, &calls[i]));
+        REPORTER_ASSERT(r, images[i] && images[i]->isLazyGenerated());
+    }
+
+    // images[1] is only drawn by a nested picture, and images[0] by both.
+    SkPictureRecorder rec;
+    SkCanvas* c = rec.beginRecording({0, 0, 40, 20});
+    c->drawImage(images[0], 0, 0);
+    c->drawImage(images[1], 20, 0);
+    sk_sp<SkPicture> inner = rec.finishRecordingAsPicture();
+
+    c = rec.beginRecording({0, 0, 40, 20});
+    c->drawPicture(inner);
+    c->drawImageRect(images[0], SkRect::MakeWH(20, 20), SkSamplingOptions());
+    sk_sp<SkPicture> outer = rec.finishRecordingAsPicture();
+
+    // Each image is decoded once, however many times the pictures draw it.
+    InlineExecutor executor;
+    outer->decodeImagesAhead(&executor);
+    REPORTER_ASSERT(r, executor.fAdded == 2, "%d decodes started", executor.fAdded);
+    for (int i = 0; i < 2; i++) {
+        REPORTER_ASSERT(r, calls[i] == 1, "image %d decoded %d times", i, calls[i].load());
+    }
+
+    // Images that are not lazy are left alone.
+    SkBitmap raster;
+    raster.allocPixels(SkImageInfo::MakeN32Premul(4, 4));
+    raster.asImage()->decodeAhead(&executor);
+    REPORTER_ASSERT(r, executor.fAdded == 2, "%d decodes started", executor.fAdded);
+}
+
+// A draw that starts while decodeAhead() is generating the same image waits for its pixels rather
+// than generating them again, and vice versa. The cache is global, so another test may purge the
+// pixels between the decode and the draw; then the draw generates them once more.
+DEF_TEST(Image_decodeAhead_racesDraw, r) {
+    constexpr int kImages = 16;
+    std::atomic<int> calls[kImages];
+    sk_sp<SkImage> images[kImages];
+    for (int i = 0; i < kImages; i++) {
+        calls[i] = 0;
+        images[i] = SkImage::MakeFromGenerator(
+                std::make_unique<CountingGenerator>(SK_ColorGREEN, &calls[i], 256));
+    }
+
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeN32Premul(1, 1));
+    SkCanvas canvas(bm);
+    {
+        // Destroying the pool waits for the decodes to finish.
+        std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+        for (int i = 0; i < kImages; i++) {
+            images[i]->decodeAhead(executor.get());
+            bm.eraseColor(SK_ColorTRANSPARENT);
+            canvas.drawImage(images[i], 0, 0);
+            REPORTER_ASSERT(r, bm.getColor(0, 0) == SK_ColorGREEN);
+        }
+    }
+    for (int i = 0; i < kImages; i++) {
+        REPORTER_ASSERT(r, calls[i] >= 1 && calls[i] <= 2,
+                        "image %d decoded %d times", i, calls[i].load());
+    }
+}
@@ -14,6 +14,7 @@
 
 #include <cmath>
 #include <cstddef>
+#include <iterator>
 #include <vector>
 
 static const int NUM_RECTS = 200;
@@ -52,11 +53,19 @@ static bool verify_query(SkRect query, SkRect rects[], const std::vector<int>& f
 
 static void run_queries(skiatest::Reporter* reporter, SkRandom& rand, SkRect rects[],
                         const SkRTree& tree) {
+    SkRect queries[NUM_QUERIES];
+    std::vector<int> hits[NUM_QUERIES];
     for (size_t i = 0; i < NUM_QUERIES; ++i) {
-        std::vector<int> hits;
-        SkRect query = random_rect(rand);
-        tree.search(query, &hits);
-        REPORTER_ASSERT(reporter, verify_query(query, rects, hits));
+        queries[i] = random_rect(rand);
+        tree.search(queries[i], &hits[i]);
+        REPORTER_ASSERT(reporter, verify_query(queries[i], rects, hits[i]));
+    }
+
+    // A batched search finds the same ops, in the same order.
+    std::vector<int> batchHits[NUM_QUERIES];
+    tree.search(queries, NUM_QUERIES, batchHits);
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+        REPORTER_ASSERT(reporter, batchHits[i] == hits[i]);
     }
 }
 
@@ -96,3 +105,28 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(RTree_EmptyAndInvertedQueries, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (int j = 0; j < NUM_RECTS; j++) {
+        rects[j] = random_rect(rand);
+    }
+    SkRTree rtree;
+    rtree.insert(rects.get(), NUM_RECTS);
+
+    const SkRect queries[] = {
+        SkRect::MakeEmpty(),
+        SkRect::MakeLTRB(600, 600, 400, 400),   // inverted
+        SkRect::MakeLTRB(500, 400, 500, 600),   // zero width
+        SkRect::MakeLTRB(0, 0, 1000, 1000),     // everything
+    };
+    std::vector<int> batchHits[std::size(queries)];
+    rtree.search(queries, SkToInt(std::size(queries)), batchHits);
+    for (size_t i = 0; i < std::size(queries); ++i) {
+        std::vector<int> hits;
+        rtree.search(queries[i], &hits);
+        REPORTER_ASSERT(reporter, verify_query(queries[i], rects, hits));
+        REPORTER_ASSERT(reporter, batchHits[i] == hits);
+    }
+}
@@ -5,10 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPaint.h"
@@ -16,10 +18,12 @@
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkImageFilters.h"
 #include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecordOpts.h"
 #include "src/core/SkRecorder.h"
 #include "src/core/SkRecords.h"
@@ -28,6 +32,7 @@
 
 #include <array>
 #include <cstddef>
+#include <cstring>
 
 static const int W = 1920, H = 1080;
 
@@ -375,6 +380,180 @@ static void do_draw(SkCanvas* canvas, SkColor color, bool doLayer) {
     }
 }
 
+static sk_sp<SkImage> make_image(SkAlphaType alphaType, SkColor color) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeN32(8, 8, alphaType));
+    bm.eraseColor(color);
+    bm.setImmutable();
+    return bm.asImage();
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint aa;
+    aa.setAntiAlias(true);
+    SkPaint translucent;
+    translucent.setAlphaf(0.5f);
+    SkPaint stroke;
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(4);
+
+    // Non-AA draws inside a later opaque, non-AA rect go away, even with other draws between.
+    recorder.drawRect(SkRect::MakeWH(100, 100), SkPaint());   // 0: removed
+    recorder.drawOval(SkRect::MakeLTRB(10, 10, 50, 50), stroke);  // 1: removed
+    recorder.drawRect(SkRect::MakeWH(50, 50), aa);            // 2: AA, kept
+    recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());   // 3: the occluder
+
+    // Clips end the run.
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());     // 4: kept
+    recorder.clipRect(SkRect::MakeWH(300, 300));              // 5
+    recorder.drawRect(SkRect::MakeWH(300, 300), SkPaint());   // 6: the occluder
+
+    // Translucent, AA, and partially covering draws don't occlude anything.
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());     // 7: kept
+    recorder.drawRect(SkRect::MakeWH(20, 20), translucent);   // 8
+    recorder.drawRect(SkRect::MakeWH(20, 20), aa);            // 9
+    recorder.drawRect(SkRect::MakeLTRB(5, 5, 20, 20), SkPaint());  // 10
+
+    // Opaque images occlude, others don't.
+    recorder.translate(500, 500);                             // 11
+    recorder.drawRect(SkRect::MakeWH(8, 8), SkPaint());       // 12: removed
+    recorder.drawImage(make_image(kOpaque_SkAlphaType, SK_ColorBLUE), 0, 0);  // 13
+    recorder.drawRect(SkRect::MakeWH(8, 8), translucent);     // 14: kept
+    recorder.drawImage(make_image(kPremul_SkAlphaType, SK_ColorBLUE), 0, 0);  // 15
+
+    REPORTER_ASSERT(r, 3 == SkRecordNoopOccludedDraws(&record));
+
+    assert_type<SkRecords::NoOp>(r, record, 0);
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    assert_type<SkRecords::DrawRect>(r, record, 2);
+    assert_type<SkRecords::DrawRect>(r, record, 3);
+    assert_type<SkRecords::DrawRect>(r, record, 4);
+    assert_type<SkRecords::DrawRect>(r, record, 7);
+    assert_type<SkRecords::NoOp>(r, record, 12);
+    assert_type<SkRecords::DrawImage>(r, record, 13);
+    assert_type<SkRecords::DrawRect>(r, record, 14);
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws_ImageRectSrcOverhang, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    sk_sp<SkImage> image = make_image(kOpaque_SkAlphaType, SK_ColorBLUE);
+    const SkRect dst = SkRect::MakeWH(100, 100);
+
+    // A src inside the image covers all of dst.
+    recorder.drawRect(SkRect::MakeLTRB(60, 10, 90, 90), SkPaint());   // 0: removed
+    recorder.drawImageRect(image, SkRect::MakeLTRB(0, 0, 8, 8), dst, SkSamplingOptions(),
+                           nullptr, SkCanvas::kFast_SrcRectConstraint);  // 1
+
+    recorder.clipRect(SkRect::MakeWH(W, H));                          // 2: ends the run
+
+    // Half of this src lies past the image's right edge, so only the left half of dst is drawn.
+    recorder.drawRect(SkRect::MakeLTRB(60, 10, 90, 90), SkPaint());   // 3: kept
+    recorder.drawImageRect(image, SkRect::MakeLTRB(0, 0, 16, 8), dst, SkSamplingOptions(),
+                           nullptr, SkCanvas::kFast_SrcRectConstraint);  // 4
+
+    REPORTER_ASSERT(r, 1 == SkRecordNoopOccludedDraws(&record));
+
+    assert_type<SkRecords::NoOp>(r, record, 0);
+    assert_type<SkRecords::DrawImageRect>(r, record, 1);
+    assert_type<SkRecords::DrawRect>(r, record, 3);
+    assert_type<SkRecords::DrawImageRect>(r, record, 4);
+}
+
+DEF_TEST(RecordOpts_MergeImageRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    sk_sp<SkImage> opaque = make_image(kOpaque_SkAlphaType, SK_ColorGREEN),
+                   premul = make_image(kPremul_SkAlphaType, 0x80000080);
+    const SkRect src = SkRect::MakeWH(8, 8);
+    const SkSamplingOptions linear(SkFilterMode::kLinear);
+
+    SkPaint translucent;
+    translucent.setAlphaf(0.5f);
+    SkPaint aa;
+    aa.setAntiAlias(true);
+
+    // These differ only in image, rects, alpha, and AA, so they become one image set.
+    recorder.drawImageRect(opaque, src, SkRect::MakeXYWH(0, 0, 16, 16), linear, nullptr,
+                           SkCanvas::kFast_SrcRectConstraint);
+    recorder.drawImageRect(premul, src, SkRect::MakeXYWH(8, 8, 16, 16), linear, &translucent,
+                           SkCanvas::kFast_SrcRectConstraint);
+    recorder.drawImageRect(opaque, src, SkRect::MakeXYWH(4, 20, 9, 9), linear, &aa,
+                           SkCanvas::kFast_SrcRectConstraint);
+    // A different constraint starts a new run, and a single draw is left alone.
+    recorder.drawImageRect(premul, src, SkRect::MakeXYWH(20, 0, 10, 10), linear, nullptr,
+                           SkCanvas::kStrict_SrcRectConstraint);
+
+    SkRecord original;
+    SkRecorder originalRecorder(&original, W, H);
+    SkRecordDraw(record, &originalRecorder, nullptr, nullptr, 0, nullptr, nullptr);
+
+    REPORTER_ASSERT(r, 3 == SkRecordMergeImageRects(&record));
+
+    auto set = assert_type<SkRecords::DrawEdgeAAImageSet>(r, record, 0);
+    if (set) {
+        REPORTER_ASSERT(r, set->count == 3);
+        REPORTER_ASSERT(r, !set->paint);
+        REPORTER_ASSERT(r, set->set[0].fAlpha == 1.0f);
+        REPORTER_ASSERT(r, set->set[1].fAlpha == 0.5f);
+        REPORTER_ASSERT(r, set->set[1].fAAFlags == SkCanvas::kNone_QuadAAFlags);
+        REPORTER_ASSERT(r, set->set[2].fAAFlags == SkCanvas::kAll_QuadAAFlags);
+    }
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    assert_type<SkRecords::NoOp>(r, record, 2);
+    assert_type<SkRecords::DrawImageRect>(r, record, 3);
+
+    // The raster backend draws the set exactly as it drew the separate image rects.
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(32, 32);
+    actual.allocN32Pixels(32, 32);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.eraseColor(SK_ColorWHITE);
+    SkCanvas expectedCanvas(expected), actualCanvas(actual);
+    SkRecordDraw(original, &expectedCanvas, nullptr, nullptr, 0, nullptr, nullptr);
+    SkRecordDraw(record, &actualCanvas, nullptr, nullptr, 0, nullptr, nullptr);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.computeByteSize()));
+}
+
+DEF_TEST(RecordOpts_OptimizeStats, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    sk_sp<SkImage> image = make_image(kPremul_SkAlphaType, SK_ColorRED);
+    const SkRect src = SkRect::MakeWH(8, 8);
+
+    recorder.save();
+    recorder.restore();
+    recorder.drawRect(SkRect::MakeWH(100, 100), SkPaint());
+    recorder.drawRect(SkRect::MakeWH(100, 100), SkPaint());
+    recorder.drawImageRect(image, src, SkRect::MakeXYWH(200, 0, 8, 8), SkSamplingOptions(),
+                           nullptr, SkCanvas::kFast_SrcRectConstraint);
+    recorder.drawImageRect(image, src, SkRect::MakeXYWH(208, 0, 8, 8), SkSamplingOptions(),
+                           nullptr, SkCanvas::kFast_SrcRectConstraint);
+
+    SkRecordOptimizeStats stats;
+    SkRecordOptimize2(&record, &stats);
+    REPORTER_ASSERT(r, stats.fNoopSaveRestores == 1);
+    REPORTER_ASSERT(r, stats.fOccludedDraws == 1);
+    REPORTER_ASSERT(r, stats.fMergedImageRects == 2);
+    REPORTER_ASSERT(r, stats.fMultipleSetMatrices == 0);
+    REPORTER_ASSERT(r, record.count() == 2);
+
+    // Stats accumulate, and SkRecordOptimize() leaves image rects alone.
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    SkRecordOptimize(&record, &stats);
+    REPORTER_ASSERT(r, stats.fOccludedDraws == 2);
+    REPORTER_ASSERT(r, stats.fMergedImageRects == 2);
+    REPORTER_ASSERT(r, record.count() == 3);
+}
+
 static bool is_equal(SkSurface* a, SkSurface* b) {
     const SkImageInfo info = SkImageInfo::MakeN32Premul(1, 1);
     SkPMColor ca, cb;
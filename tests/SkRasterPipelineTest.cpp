@@ -68,7 +68,8 @@ DEF_TEST(SkRasterPipeline_ImmediateStoreUnmasked, r) {
 
 DEF_TEST(SkRasterPipeline_LoadStoreUnmasked, r) {
     alignas(64) float val[SkRasterPipeline_kMaxStride_highp] = {};
-    alignas(64) float data[] = {123.0f, 456.0f, 789.0f, -876.0f, -543.0f, -210.0f, 12.0f, -3.0f};
+    alignas(64) float data[] = {123.0f, 456.0f, 789.0f, -876.0f, -543.0f, -210.0f, 12.0f, -3.0f,
+                                 987.0f, 654.0f, 321.0f, -234.0f, -567.0f, -890.0f, 21.0f, -9.0f};
     static_assert(std::size(data) == SkRasterPipeline_kMaxStride_highp);
 
     SkRasterPipeline_<256> p;
@@ -91,9 +92,12 @@ DEF_TEST(SkRasterPipeline_LoadStoreUnmasked, r) {
 
 DEF_TEST(SkRasterPipeline_LoadStoreMasked, r) {
     for (size_t width = 0; width < SkOpts::raster_pipeline_highp_stride; ++width) {
-        alignas(64) float val[] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
-        alignas(64) float data[] = {2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f};
-        alignas(64) const int32_t mask[] = {0, ~0, ~0, ~0, ~0, ~0, 0, ~0};
+        alignas(64) float val[] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+                                   1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+        alignas(64) float data[] = {2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f,
+                                    2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f};
+        alignas(64) const int32_t mask[] = {0, ~0, ~0, ~0, ~0, ~0, 0, ~0,
+                                            ~0, 0, ~0, 0, ~0, ~0, ~0, 0};
         static_assert(std::size(val) == SkRasterPipeline_kMaxStride_highp);
         static_assert(std::size(data) == SkRasterPipeline_kMaxStride_highp);
         static_assert(std::size(mask) == SkRasterPipeline_kMaxStride_highp);
@@ -123,7 +127,8 @@ DEF_TEST(SkRasterPipeline_LoadStoreMasked, r) {
 }
 
 DEF_TEST(SkRasterPipeline_LoadStoreConditionMask, r) {
-    alignas(64) int32_t mask[]  = {~0, 0, ~0,  0, ~0, ~0, ~0,  0};
+    alignas(64) int32_t mask[]  = {~0, 0, ~0,  0, ~0, ~0, ~0,  0,
+                                    0, ~0, 0, ~0, ~0,  0, ~0, ~0};
     alignas(64) int32_t maskCopy[SkRasterPipeline_kMaxStride_highp] = {};
     alignas(64) int32_t dst[4 * SkRasterPipeline_kMaxStride_highp] = {};
 
@@ -166,7 +171,8 @@ DEF_TEST(SkRasterPipeline_LoadStoreConditionMask, r) {
 }
 
 DEF_TEST(SkRasterPipeline_LoadStoreLoopMask, r) {
-    alignas(64) int32_t mask[]  = {~0, 0, ~0,  0, ~0, ~0, ~0,  0};
+    alignas(64) int32_t mask[]  = {~0, 0, ~0,  0, ~0, ~0, ~0,  0,
+                                    0, ~0, 0, ~0, ~0,  0, ~0, ~0};
     alignas(64) int32_t maskCopy[SkRasterPipeline_kMaxStride_highp] = {};
     alignas(64) int32_t dst[4 * SkRasterPipeline_kMaxStride_highp] = {};
 
@@ -209,7 +215,8 @@ DEF_TEST(SkRasterPipeline_LoadStoreLoopMask, r) {
 }
 
 DEF_TEST(SkRasterPipeline_LoadStoreReturnMask, r) {
-    alignas(64) int32_t mask[]  = {~0, 0, ~0,  0, ~0, ~0, ~0,  0};
+    alignas(64) int32_t mask[]  = {~0, 0, ~0,  0, ~0, ~0, ~0,  0,
+                                    0, ~0, 0, ~0, ~0,  0, ~0, ~0};
     alignas(64) int32_t maskCopy[SkRasterPipeline_kMaxStride_highp] = {};
     alignas(64) int32_t dst[4 * SkRasterPipeline_kMaxStride_highp] = {};
 
@@ -252,8 +259,8 @@ DEF_TEST(SkRasterPipeline_LoadStoreReturnMask, r) {
 }
 
 DEF_TEST(SkRasterPipeline_MergeConditionMask, r) {
-    alignas(64) int32_t mask[]  = { 0,  0, ~0, ~0, 0, ~0, 0, ~0,
-                                   ~0, ~0, ~0, ~0, 0,  0, 0,  0};
+    alignas(64) int32_t mask[]  = { 0,  0, ~0, ~0, 0, ~0, 0, ~0,  0, ~0, ~0, 0, ~0,  0, ~0, ~0,
+                                   ~0, ~0, ~0, ~0, 0,  0, 0,  0, ~0,  0, ~0, 0, ~0, ~0, ~0,  0};
     alignas(64) int32_t dst[4 * SkRasterPipeline_kMaxStride_highp] = {};
     static_assert(std::size(mask) == (2 * SkRasterPipeline_kMaxStride_highp));
 
@@ -280,10 +287,15 @@ DEF_TEST(SkRasterPipeline_MergeConditionMask, r) {
 
 DEF_TEST(SkRasterPipeline_MergeLoopMask, r) {
     alignas(64) int32_t initial[]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,  // dr (condition)
+                                      ~0,  0, ~0, ~0, ~0, ~0,  0, ~0,
                                       ~0,  0, ~0,  0, ~0, ~0, ~0, ~0,  // dg (loop)
+                                      ~0, ~0,  0, ~0, ~0,  0, ~0, ~0,
                                       ~0, ~0, ~0, ~0, ~0, ~0,  0, ~0,  // db (return)
-                                      ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0}; // da (combined)
-    alignas(64) int32_t mask[]     = { 0, ~0, ~0,  0, ~0, ~0, ~0, ~0};
+                                       0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,
+                                      ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,  // da (combined)
+                                      ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0};
+    alignas(64) int32_t mask[]     = { 0, ~0, ~0,  0, ~0, ~0, ~0, ~0,
+                                      ~0,  0, ~0, ~0,  0, ~0,  0, ~0};
     alignas(64) int32_t dst[4 * SkRasterPipeline_kMaxStride_highp] = {};
     static_assert(std::size(initial) == (4 * SkRasterPipeline_kMaxStride_highp));
 
@@ -312,10 +324,15 @@ DEF_TEST(SkRasterPipeline_MergeLoopMask, r) {
 
 DEF_TEST(SkRasterPipeline_ReenableLoopMask, r) {
     alignas(64) int32_t initial[]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,  // dr (condition)
+                                      ~0,  0, ~0, ~0, ~0, ~0,  0, ~0,
                                       ~0,  0, ~0,  0, ~0, ~0,  0, ~0,  // dg (loop)
+                                       0, ~0,  0,  0, ~0, ~0,  0, ~0,
                                        0, ~0, ~0, ~0,  0,  0,  0, ~0,  // db (return)
-                                       0,  0, ~0,  0,  0,  0,  0, ~0}; // da (combined)
-    alignas(64) int32_t mask[]     = { 0, ~0,  0,  0,  0,  0, ~0,  0};
+                                      ~0,  0, ~0, ~0,  0, ~0, ~0, ~0,
+                                       0,  0, ~0,  0,  0,  0,  0, ~0,  // da (combined)
+                                       0,  0,  0,  0,  0, ~0,  0, ~0};
+    alignas(64) int32_t mask[]     = { 0, ~0,  0,  0,  0,  0, ~0,  0,
+                                      ~0,  0, ~0,  0,  0, ~0,  0,  0};
     alignas(64) int32_t dst[4 * SkRasterPipeline_kMaxStride_highp] = {};
     static_assert(std::size(initial) == (4 * SkRasterPipeline_kMaxStride_highp));
 
@@ -344,9 +361,13 @@ DEF_TEST(SkRasterPipeline_ReenableLoopMask, r) {
 
 DEF_TEST(SkRasterPipeline_MaskOffLoopMask, r) {
     alignas(64) int32_t initial[]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,  // dr (condition)
+                                      ~0,  0, ~0, ~0, ~0, ~0,  0, ~0,
                                       ~0,  0, ~0, ~0,  0,  0,  0, ~0,  // dg (loop)
+                                       0, ~0, ~0,  0, ~0, ~0,  0, ~0,
                                       ~0, ~0,  0, ~0,  0,  0, ~0, ~0,  // db (return)
-                                      ~0,  0,  0, ~0,  0,  0,  0, ~0}; // da (combined)
+                                      ~0, ~0, ~0,  0,  0, ~0, ~0, ~0,
+                                      ~0,  0,  0, ~0,  0,  0,  0, ~0,  // da (combined)
+                                       0,  0, ~0,  0,  0,  0,  0, ~0};
     alignas(64) int32_t dst[4 * SkRasterPipeline_kMaxStride_highp] = {};
     static_assert(std::size(initial) == (4 * SkRasterPipeline_kMaxStride_highp));
 
@@ -373,9 +394,13 @@ DEF_TEST(SkRasterPipeline_MaskOffLoopMask, r) {
 
 DEF_TEST(SkRasterPipeline_MaskOffReturnMask, r) {
     alignas(64) int32_t initial[]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,  // dr (condition)
+                                      ~0,  0, ~0, ~0, ~0, ~0,  0, ~0,
                                       ~0,  0, ~0, ~0,  0,  0,  0, ~0,  // dg (loop)
+                                       0, ~0, ~0,  0, ~0, ~0,  0, ~0,
                                       ~0, ~0,  0, ~0,  0,  0, ~0, ~0,  // db (return)
-                                      ~0,  0,  0, ~0,  0,  0,  0, ~0}; // da (combined)
+                                      ~0, ~0, ~0,  0,  0, ~0, ~0, ~0,
+                                      ~0,  0,  0, ~0,  0,  0,  0, ~0,  // da (combined)
+                                       0,  0, ~0,  0,  0,  0,  0, ~0};
     alignas(64) int32_t dst[4 * SkRasterPipeline_kMaxStride_highp] = {};
     static_assert(std::size(initial) == (4 * SkRasterPipeline_kMaxStride_highp));
 
@@ -463,11 +488,15 @@ DEF_TEST(SkRasterPipeline_CopySlotsMasked, r) {
         {SkRasterPipeline::Stage::copy_4_slots_masked, 4},
     };
 
-    static_assert(SkRasterPipeline_kMaxStride_highp == 8);
-    alignas(64) const int32_t kMask1[8] = {~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0};
-    alignas(64) const int32_t kMask2[8] = { 0,  0,  0,  0,  0,  0,  0,  0};
-    alignas(64) const int32_t kMask3[8] = {~0,  0, ~0, ~0, ~0, ~0,  0, ~0};
-    alignas(64) const int32_t kMask4[8] = { 0, ~0,  0,  0,  0, ~0, ~0,  0};
+    static_assert(SkRasterPipeline_kMaxStride_highp == 16);
+    alignas(64) const int32_t kMask1[16] = {~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,
+                                            ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0};
+    alignas(64) const int32_t kMask2[16] = { 0,  0,  0,  0,  0,  0,  0,  0,
+                                             0,  0,  0,  0,  0,  0,  0,  0};
+    alignas(64) const int32_t kMask3[16] = {~0,  0, ~0, ~0, ~0, ~0,  0, ~0,
+                                             0, ~0,  0, ~0, ~0,  0, ~0, ~0};
+    alignas(64) const int32_t kMask4[16] = { 0, ~0,  0,  0,  0, ~0, ~0,  0,
+                                            ~0,  0, ~0, ~0,  0,  0, ~0,  0};
 
     const int N = SkOpts::raster_pipeline_highp_stride;
 
@@ -16,19 +16,23 @@
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkSurface.h"
+#include "include/core/SkTraceMemoryDump.h"
 #include "include/core/SkTypes.h"
 #include "src/core/SkBitmapCache.h"
 #include "src/core/SkCachedData.h"
 #include "src/core/SkDiscardableMemory.h"
 #include "src/core/SkMipmap.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/image/SkImage_Base.h"
 #include "src/lazy/SkDiscardableMemoryPool.h"
 #include "tests/Test.h"
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <initializer_list>
 #include <memory>
 
@@ -302,3 +306,91 @@ DEF_TEST(ResourceCache_purge, reporter) {
         }
     }
 }
+
+static bool always_valid(const SkResourceCache::Rec&, void*) { return true; }
+static bool always_stale(const SkResourceCache::Rec&, void*) { return false; }
+
+DEF_TEST(ResourceCache_stats, reporter) {
+    int flags = 0;
+    SkResourceCache cache(4 * 1024);
+
+    REPORTER_ASSERT(reporter, !cache.find(TestKey(1, 0), always_valid, nullptr));
+    for (int i = 0; i < 4; i++) {
+        auto rec = std::make_unique<TestRec>(1, i, &flags);
+        rec->fCanBePurged = true;
+        cache.add(rec.release());
+    }
+    // The fourth 1024-byte rec reached the 4k budget, evicting the first.
+    REPORTER_ASSERT(reporter, cache.stats().fEvictions == 1);
+    REPORTER_ASSERT(reporter, !cache.find(TestKey(1, 0), always_valid, nullptr));
+    REPORTER_ASSERT(reporter, cache.find(TestKey(1, 1), always_valid, nullptr));
+    REPORTER_ASSERT(reporter, !cache.find(TestKey(1, 2), always_stale, nullptr));
+
+    REPORTER_ASSERT(reporter, cache.stats().fHits == 1);
+    REPORTER_ASSERT(reporter, cache.stats().fMisses == 3);
+
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, cache.stats().fEvictions == 3);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == 0);
+}
+
+namespace {
+class StatsTraceMemoryDump : public SkTraceMemoryDump {
+public:
+    void dumpNumericValue(const char* dumpName, const char* valueName, const char*,
+                          uint64_t value) override {
+        if (strstr(dumpName, "/shard_")) {
+            if (!strcmp(valueName, "hits")) {
+                fShards++;
+                fHits += value;
+            }
+        }
+    }
+    void setMemoryBacking(const char*, const char*, const char*) override {}
+    void setDiscardableMemoryBacking(const char*, const SkDiscardableMemory&) override {}
+    LevelOfDetail getRequestedDetails() const override {
+        return SkTraceMemoryDump::kObjectsBreakdowns_LevelOfDetail;
+    }
+
+    int      fShards = 0;
+    uint64_t fHits = 0;
+};
+}  // namespace
+
+DEF_TEST(ResourceCache_shards_threads, reporter) {
+    // A private set of shards, so no one else's recs can interfere. Purge messages still reach
+    // every cache, so use a shared ID no one else does.
+    static constexpr int kSharedID = 0x5eed0007;
+    static constexpr int kThreads = 8, kRecsPerThread = 64;
+    SkResourceCache::ShardsForTesting shards(4 * kThreads * kRecsPerThread * 1024);
+
+    std::atomic<int> found{0};
+    SkTaskGroup().batch(kThreads, [&](int thread) {
+        int flags = 0;
+        for (int i = 0; i < kRecsPerThread; i++) {
+            auto rec = std::make_unique<TestRec>(kSharedID, thread * kRecsPerThread + i, &flags);
+            rec->fCanBePurged = true;
+            shards.add(rec.release());
+        }
+        for (int i = 0; i < kRecsPerThread; i++) {
+            TestKey key(kSharedID, thread * kRecsPerThread + i);
+            if (shards.find(key, always_valid, nullptr)) {
+                found++;
+            }
+        }
+    });
+    // Nothing should have been evicted: these recs use a quarter of the budget.
+    REPORTER_ASSERT(reporter, found == kThreads * kRecsPerThread);
+
+    StatsTraceMemoryDump dump;
+    shards.dumpMemoryStatistics(&dump);
+    REPORTER_ASSERT(reporter, dump.fShards == 16);
+    REPORTER_ASSERT(reporter, dump.fHits == (uint64_t)(kThreads * kRecsPerThread));
+
+    // Purging by shared ID reaches every shard.
+    SkResourceCache::PostPurgeSharedID(kSharedID);
+    shards.checkMessages();
+    for (int i = 0; i < kThreads * kRecsPerThread; i++) {
+        REPORTER_ASSERT(reporter, !shards.find(TestKey(kSharedID, i), always_valid, nullptr));
+    }
+}
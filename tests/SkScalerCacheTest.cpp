@@ -25,11 +25,14 @@
 #include "tests/Test.h"
 #include "tools/ToolUtils.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <functional>
 #include <initializer_list>
 #include <memory>
+#include <set>
+#include <vector>
 
 class Barrier {
 public:
@@ -96,3 +99,83 @@ DEF_TEST(SkScalerCacheMultiThread, Reporter) {
         SkTaskGroup(*executor).batch(kThreadCount, perThread);
     }
 }
+
+DEF_TEST(SkScalerCacheLockFreeLookup, reporter) {
+    sk_sp<SkTypeface> typeface =
+            ToolUtils::create_portable_typeface("serif", SkFontStyle::Italic());
+    static constexpr int kThreadCount = 4;
+
+    SkFont font;
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    font.setSubpixel(true);
+    font.setTypeface(typeface);
+
+    // Enough glyphs, counting sub-pixel positions, to grow the lock-free table several times.
+    std::vector<SkPackedGlyphID> packedIDs;
+    std::set<uint32_t> uniqueIDs;
+    for (int c = ' '; c < 'z'; c++) {
+        for (uint32_t subX = 0; subX < 4; subX++) {
+            packedIDs.emplace_back(font.unicharToGlyph(c), subX, 0u);
+            uniqueIDs.insert(packedIDs.back().value());
+        }
+    }
+    const size_t glyphCount = packedIDs.size();
+
+    SkPaint defaultPaint;
+    SkStrikeSpec strikeSpec = SkStrikeSpec::MakeMask(
+            font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I());
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(kThreadCount);
+    for (int tries = 0; tries < 10; tries++) {
+        SkScalerCache scalerCache{strikeSpec.createScalerContext()};
+
+        // Each thread walks the glyphs from a different starting point, so creation on one
+        // thread races lookups on the others.
+        std::vector<const SkGlyph*> results[kThreadCount];
+        SkTaskGroup(*executor).batch(kThreadCount, [&](int threadIndex) {
+            std::vector<SkPackedGlyphID> local(packedIDs);
+            std::rotate(local.begin(), local.begin() + threadIndex * glyphCount / kThreadCount,
+                        local.end());
+            std::vector<const SkGlyph*> glyphs(glyphCount);
+            for (int i = 0; i < 10; i++) {
+                (void)scalerCache.prepareImages(local, glyphs.data());
+                for (const SkGlyph* glyph : glyphs) {
+                    (void)glyph->image();
+                }
+            }
+            std::rotate(glyphs.begin(),
+                        glyphs.end() - threadIndex * glyphCount / kThreadCount,
+                        glyphs.end());
+            results[threadIndex] = std::move(glyphs);
+        });
+
+        REPORTER_ASSERT(reporter, scalerCache.countCachedGlyphs() == SkToInt(uniqueIDs.size()));
+
+        // Every glyph now has an image, so the lookup must not create anything.
+        std::vector<const SkGlyph*> glyphs(glyphCount);
+        size_t increase = std::get<1>(scalerCache.prepareImages(packedIDs, glyphs.data()));
+        REPORTER_ASSERT(reporter, increase == 0);
+        for (size_t i = 0; i < glyphCount; i++) {
+            REPORTER_ASSERT(reporter, glyphs[i]->getPackedID() == packedIDs[i]);
+            REPORTER_ASSERT(reporter, glyphs[i]->setImageHasBeenCalled());
+            for (const auto& threadResults : results) {
+                REPORTER_ASSERT(reporter, threadResults[i] == glyphs[i]);
+            }
+        }
+
+        // Paths have not been made yet, so this must still create them, and only once.
+        std::vector<SkGlyphID> glyphIDs;
+        for (int c = ' '; c < 'z'; c++) {
+            glyphIDs.push_back(font.unicharToGlyph(c));
+        }
+        std::vector<const SkGlyph*> pathGlyphs(glyphIDs.size());
+        size_t pathIncrease = std::get<1>(scalerCache.preparePaths(glyphIDs, pathGlyphs.data()));
+        REPORTER_ASSERT(reporter, pathIncrease > 0);
+        pathIncrease = std::get<1>(scalerCache.preparePaths(glyphIDs, pathGlyphs.data()));
+        REPORTER_ASSERT(reporter, pathIncrease == 0);
+        for (const SkGlyph* glyph : pathGlyphs) {
+            REPORTER_ASSERT(reporter, glyph->setPathHasBeenCalled());
+        }
+    }
+}
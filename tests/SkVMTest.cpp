@@ -5,17 +5,26 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkBlender.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSpan.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkString.h"
 #include "include/core/SkTypes.h"
+#include "include/effects/SkRuntimeEffect.h"
 #include "include/private/SkFloatingPoint.h"
 #include "include/private/SkSLProgramKind.h"
+#include "src/core/SkArenaAlloc.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkMatrixProvider.h"
 #include "src/core/SkVM.h"
+#include "src/core/SkVMBlitter.h"
 #include "src/sksl/SkSLCompiler.h"
 #include "src/sksl/SkSLProgramSettings.h"
 #include "src/sksl/SkSLUtil.h"
@@ -2902,3 +2911,59 @@ DEF_TEST(SkVM_Visualizer, r) {
                        "<tr class='source'><td class='mask'>&#8617;v9</td>"
                        "<td colspan=2>int main(int x, int y)</td></tr>"));
 }
+
+DEF_TEST(SkVM_ProgramCache, r) {
+#if defined(SKVM_JIT)
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+
+    // A runtime blender no other test uses, so the programs it needs are ours alone.
+    sk_sp<SkRuntimeEffect> effect = SkRuntimeEffect::MakeForBlender(SkString(R"(
+        half4 main(half4 src, half4 dst) { return src.bgra; }
+    )")).effect;
+    REPORTER_ASSERT(r, effect);
+    SkPaint paint;
+    paint.setColor(0xff4080c0);
+    paint.setBlender(effect->makeBlender(/*uniforms=*/nullptr));
+
+    // Returns whether the blitter drew with a program read from a saved cache.
+    auto blit = [&] {
+        SkSTArenaAlloc<2048> alloc;
+        SkVMBlitter* blitter = SkVMBlitter::Make(bitmap.pixmap(), paint,
+                                                 SkMatrixProvider(SkMatrix::I()), &alloc,
+                                                 /*clipShader=*/nullptr);
+        REPORTER_ASSERT(r, blitter);
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        blitter->blitRect(0, 0, 16, 16);
+        REPORTER_ASSERT(r, bitmap.getColor(8, 8) == 0xffc08040);
+        return blitter->usedLoadedProgramForTesting();
+    };
+
+    SkVMBlitter::PurgeProgramCache();
+    REPORTER_ASSERT(r, !blit());
+
+    SkDynamicMemoryWStream stream;
+    REPORTER_ASSERT(r, SkVMBlitter::SaveProgramCache(&stream));
+    sk_sp<SkData> saved = stream.detachAsData();
+
+    // Clear the cache first, or loading would keep the programs already in it.
+    SkVMBlitter::PurgeProgramCache();
+    {
+        SkMemoryStream truncated(saved->data(), saved->size() - 1);
+        REPORTER_ASSERT(r, !SkVMBlitter::LoadProgramCache(&truncated));
+    }
+    {
+        SkMemoryStream empty;
+        REPORTER_ASSERT(r, !SkVMBlitter::LoadProgramCache(&empty));
+    }
+    REPORTER_ASSERT(r, !blit());    // neither bad stream added anything, so this rebuilt it
+
+    SkVMBlitter::PurgeProgramCache();
+    {
+        SkMemoryStream good(saved);
+        REPORTER_ASSERT(r, SkVMBlitter::LoadProgramCache(&good));
+    }
+    // A fresh blitter finds the program it needs without building it.
+    REPORTER_ASSERT(r, blit());
+#endif
+}
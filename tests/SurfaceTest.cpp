@@ -14,6 +14,7 @@
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
@@ -34,6 +35,7 @@
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkColorMatrix.h"
+#include "include/effects/SkGradientShader.h"
 #include "include/gpu/GpuTypes.h"
 #include "include/gpu/GrBackendSurface.h"
 #include "include/gpu/GrDirectContext.h"
@@ -1320,3 +1322,132 @@ DEF_TEST(VMBlitterInfiniteColorShader, r) {
     auto surface = SkSurface::MakeRasterN32Premul(8, 8);
     surface->getCanvas()->drawPaint(paint);
 }
+
+static void draw_threaded_raster_scene(SkCanvas* canvas) {
+    canvas->clear(SK_ColorWHITE);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    const SkPoint pts[] = {{0, 0}, {600, 400}};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkTileMode::kClamp));
+    canvas->drawRect(SkRect::MakeLTRB(10, 10, 590, 390), paint);
+    paint.setShader(nullptr);
+
+    // Geometry that straddles tile boundaries, under a rotated anti-aliased clip.
+    canvas->save();
+    canvas->rotate(17, 300, 200);
+    canvas->clipRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(40, 30, 560, 370), 40, 40), true);
+    for (int i = 0; i < 20; ++i) {
+        paint.setColor(SkColorSetARGB(0x80, i * 12, 255 - i * 12, 128));
+        canvas->drawCircle(30.5f * i, 13.3f * i + 20, 7.0f + 3 * i, paint);
+    }
+    SkPath star;
+    star.moveTo(300, 40);
+    for (int i = 1; i < 5; ++i) {
+        SkScalar angle = SK_ScalarPI * 0.8f * i;
+        star.lineTo(300 + 150 * sk_float_sin(angle), 190 - 150 * sk_float_cos(angle));
+    }
+    star.close();
+    paint.setColor(SK_ColorGREEN);
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(5);
+    canvas->drawPath(star, paint);
+    canvas->restore();
+
+    // Text and images.
+    paint.setStyle(SkPaint::kFill_Style);
+    paint.setColor(SK_ColorBLACK);
+    canvas->drawString("Threaded raster", 255.5f, 258.f, SkFont(nullptr, 24), paint);
+
+    SkBitmap bm;
+    bm.allocN32Pixels(16, 16);
+    bm.eraseColor(SK_ColorYELLOW);
+    bm.erase(SK_ColorMAGENTA, SkIRect::MakeWH(8, 8));
+    canvas->drawImageRect(bm.asImage(), SkRect::MakeXYWH(230, 300, 100, 60),
+                          SkSamplingOptions(SkFilterMode::kLinear));
+
+    // Layers flush the pending draws and composite on the calling thread.
+    canvas->saveLayerAlphaf(nullptr, 0.5f);
+    paint.setColor(SK_ColorCYAN);
+    canvas->drawRect(SkRect::MakeLTRB(200, 100, 400, 300), paint);
+    canvas->restore();
+
+    const SkPoint points[] = {{5, 5}, {250, 390}, {595, 5}};
+    paint.setStrokeWidth(3);
+    canvas->drawPoints(SkCanvas::kPolygon_PointMode, std::size(points), points, paint);
+}
+
+DEF_TEST(SurfaceRasterThreaded, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(600, 400);
+
+    sk_sp<SkSurface> serial = SkSurface::MakeRaster(info);
+    sk_sp<SkSurface> threaded = SkSurface::MakeRasterThreaded(info, executor.get());
+    REPORTER_ASSERT(reporter, serial && threaded);
+
+    draw_threaded_raster_scene(serial->getCanvas());
+    draw_threaded_raster_scene(threaded->getCanvas());
+
+    SkBitmap expected, actual;
+    expected.allocPixels(info);
+    actual.allocPixels(info);
+    REPORTER_ASSERT(reporter, serial->readPixels(expected, 0, 0));
+    REPORTER_ASSERT(reporter, threaded->readPixels(actual, 0, 0));
+    REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected, actual));
+
+    // A snapshot must not see draws made after it was taken.
+    sk_sp<SkImage> snapshot = threaded->makeImageSnapshot();
+    threaded->getCanvas()->drawPaint(SkPaint());
+    REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected.asImage().get(), snapshot.get()));
+
+    SkPixmap pixmap;
+    REPORTER_ASSERT(reporter, threaded->peekPixels(&pixmap));
+    REPORTER_ASSERT(reporter, *pixmap.addr32(300, 200) == SK_ColorBLACK);
+}
+
+// Anti-aliased paths and text laid right across the seams of the 256 pixel tiles must rasterize
+// exactly as they would on a plain raster surface.
+DEF_TEST(SurfaceRasterThreaded_TileSeams, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(512, 512);
+
+    auto draw = [](SkCanvas* canvas) {
+        canvas->clear(SK_ColorWHITE);
+
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 8; ++i) {
+            SkPath path;
+            path.moveTo(256.3f - 9 * i, 200.7f + 4 * i);
+            path.cubicTo(300.1f, 230.f - 3 * i, 210.4f + 5 * i, 281.9f, 257.6f + 7 * i, 310.2f);
+            path.lineTo(190.5f + 11 * i, 256.4f);
+            path.close();
+            paint.setColor(SkColorSetARGB(0xA0, 30 * i, 255 - 30 * i, 90));
+            canvas->drawPath(path, paint);
+        }
+
+        paint.setColor(SK_ColorBLACK);
+        SkFont font(nullptr, 40);
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        canvas->drawString("Seams", 205.3f, 270.6f, font, paint);
+        canvas->save();
+        canvas->rotate(30, 256, 256);
+        canvas->drawString("Seams", 180.8f, 262.1f, font, paint);
+        canvas->restore();
+    };
+
+    sk_sp<SkSurface> serial = SkSurface::MakeRaster(info);
+    sk_sp<SkSurface> threaded = SkSurface::MakeRasterThreaded(info, executor.get());
+    REPORTER_ASSERT(reporter, serial && threaded);
+
+    draw(serial->getCanvas());
+    draw(threaded->getCanvas());
+
+    SkBitmap expected, actual;
+    expected.allocPixels(info);
+    actual.allocPixels(info);
+    REPORTER_ASSERT(reporter, serial->readPixels(expected, 0, 0));
+    REPORTER_ASSERT(reporter, threaded->readPixels(actual, 0, 0));
+    REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected, actual));
+}
@@ -10,6 +10,9 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkSwizzle.h"
+#include "src/codec/SkCodecPriv.h"
+#include "src/codec/SkMaskSwizzler.h"
+#include "src/codec/SkMasks.h"
 #include "src/codec/SkSampler.h"
 #include "src/core/SkOpts.h"
 #include "tests/Test.h"
@@ -151,6 +154,98 @@ DEF_TEST(SwizzleOpts, r) {
     REPORTER_ASSERT(r, dst == 0xFA04ADCA);
 }
 
+DEF_TEST(SwizzleOpts_16bit_index_bitfields, r) {
+    // Enough pixels for the vector loops and a tail.
+    constexpr int kCount = 37;
+    uint8_t src[8*kCount];
+    for (int i = 0; i < (int)sizeof(src); i++) {
+        src[i] = (uint8_t)(i * 37 + 11);
+    }
+    uint32_t dst[kCount];
+
+    // 16-bit components are big-endian, so the first byte of each is kept.
+    SkOpts::RGBA16_to_RGBA(dst, src, kCount);
+    for (int i = 0; i < kCount; i++) {
+        const uint8_t* p = src + 8*i;
+        REPORTER_ASSERT(r, dst[i] == (uint32_t)(p[0] | p[2] << 8 | p[4] << 16 | p[6] << 24));
+    }
+    SkOpts::RGBA16_to_BGRA(dst, src, kCount);
+    for (int i = 0; i < kCount; i++) {
+        const uint8_t* p = src + 8*i;
+        REPORTER_ASSERT(r, dst[i] == (uint32_t)(p[4] | p[2] << 8 | p[0] << 16 | p[6] << 24));
+    }
+    SkOpts::RGB16_to_RGB1(dst, src, kCount);
+    for (int i = 0; i < kCount; i++) {
+        const uint8_t* p = src + 6*i;
+        REPORTER_ASSERT(r, dst[i] == (p[0] | p[2] << 8 | p[4] << 16 | 0xFF000000));
+    }
+    SkOpts::RGB16_to_BGR1(dst, src, kCount);
+    for (int i = 0; i < kCount; i++) {
+        const uint8_t* p = src + 6*i;
+        REPORTER_ASSERT(r, dst[i] == (p[4] | p[2] << 8 | p[0] << 16 | 0xFF000000));
+    }
+
+    uint32_t ctable[256];
+    for (int i = 0; i < 256; i++) {
+        ctable[i] = 0x01010101 * (uint32_t)(255 - i);
+    }
+    SkOpts::index_to_8888(dst, src, kCount, ctable);
+    for (int i = 0; i < kCount; i++) {
+        REPORTER_ASSERT(r, dst[i] == ctable[src[i]]);
+    }
+
+    // Every n-bit component rounds to the nearest 8-bit value, as SkMasks does.
+    auto to_8 = [](uint32_t c, int bits) { return (c * 255 * 2 + (1u << bits) - 1)
+                                                / (2 * ((1u << bits) - 1)); };
+    const uint32_t masks565[4] = { 0x001F, 0x07E0, 0xF800, 0 };
+    SkOpts::bitfields16_to_8888(dst, src, kCount, masks565, 0xFF000000);
+    for (int i = 0; i < kCount; i++) {
+        const uint32_t p = src[2*i] | src[2*i + 1] << 8;
+        REPORTER_ASSERT(r, dst[i] == (to_8(p & 31, 5) | to_8((p >> 5) & 63, 6) << 8 |
+                                      to_8(p >> 11, 5) << 16 | 0xFF000000));
+    }
+    const uint32_t masks32[4] = { 0x00FF0000, 0x0000FF00, 0x000000FF, 0x7C000000 };
+    SkOpts::bitfields32_to_8888(dst, src, kCount, masks32, 0);
+    for (int i = 0; i < kCount; i++) {
+        uint32_t p;
+        memcpy(&p, src + 4*i, 4);
+        REPORTER_ASSERT(r, dst[i] == (((p >> 16) & 0xFF) | (p & 0xFF00) | (p & 0xFF) << 16 |
+                                      to_8((p >> 26) & 31, 5) << 24));
+    }
+}
+
+// Rows the mask swizzler unpacks with SkOpts must match SkMasks, even when a mask has holes in it.
+DEF_TEST(MaskSwizzlerMatchesMasks, r) {
+    constexpr int kWidth = 19;  // past the vector width, with a scalar tail
+    uint16_t src[kWidth];
+    for (int i = 0; i < kWidth; i++) {
+        src[i] = (uint16_t)(0x9E37 * (i + 1));
+    }
+
+    const SkMasks::InputMasks inputs[] = {
+        { 0xF800, 0x07E0, 0x001F, 0 },  // 565
+        { 0x0101, 0x00F0, 0x000E, 0 },  // red is split, and wider than 8 bits
+        { 0x0A00, 0x00F0, 0x000F, 0 },  // red is split
+    };
+    for (const SkMasks::InputMasks& input : inputs) {
+        std::unique_ptr<SkMasks> masks(SkMasks::CreateMasks(input, 2));
+        REPORTER_ASSERT(r, masks);
+        std::unique_ptr<SkMaskSwizzler> swizzler(SkMaskSwizzler::CreateMaskSwizzler(
+                SkImageInfo::Make(kWidth, 1, kRGBA_8888_SkColorType, kOpaque_SkAlphaType),
+                /*srcIsOpaque=*/true, masks.get(), 16, SkCodec::Options()));
+        REPORTER_ASSERT(r, swizzler);
+
+        uint32_t dst[kWidth];
+        swizzler->swizzle(dst, reinterpret_cast<const uint8_t*>(src));
+        for (int i = 0; i < kWidth; i++) {
+            REPORTER_ASSERT(r, dst[i] == SkPackARGB_as_RGBA(0xFF, masks->getRed(src[i]),
+                                                            masks->getGreen(src[i]),
+                                                            masks->getBlue(src[i])),
+                            "pixel %d of masks %x %x %x", i, input.red, input.green, input.blue);
+        }
+    }
+}
+
 DEF_TEST(PublicSwizzleOpts, r) {
     uint32_t dst, src;
 
@@ -137,6 +137,34 @@ DEF_TEST(Jpeg_YUV_Codec, r) {
     codec_yuv(r, "images/arrow.png", nullptr);
 }
 
+DEF_TEST(Webp_YUV_Codec, r) {
+    auto setExpectations = [](SkISize dims, SkYUVAInfo::PlaneConfig planeConfig) {
+        return SkYUVAInfo(dims,
+                          planeConfig,
+                          SkYUVAInfo::Subsampling::k420,
+                          kRec601_Limited_SkYUVColorSpace,
+                          kTopLeft_SkEncodedOrigin,
+                          SkYUVAInfo::Siting::kCentered,
+                          SkYUVAInfo::Siting::kCentered);
+    };
+
+    // Lossy
+    SkYUVAInfo expectations = setExpectations({800, 800}, SkYUVAInfo::PlaneConfig::kY_U_V);
+    codec_yuv(r, "images/webp-color-profile-lossy.webp", &expectations);
+
+    // Lossy with alpha, including odd dimensions
+    expectations = setExpectations({400, 301}, SkYUVAInfo::PlaneConfig::kY_U_V_A);
+    codec_yuv(r, "images/yellow_rose.webp", &expectations);
+    expectations = setExpectations({320, 240}, SkYUVAInfo::PlaneConfig::kY_U_V_A);
+    codec_yuv(r, "images/webp-color-profile-lossy-alpha.webp", &expectations);
+
+    // Lossless images should fail.
+    codec_yuv(r, "images/color_wheel.webp", nullptr);
+    codec_yuv(r, "images/webp-color-profile-lossless.webp", nullptr);
+    // Animated images should fail, even when their frames are lossy.
+    codec_yuv(r, "images/blendBG.webp", nullptr);
+}
+
 // Be sure that the two matrices are inverses of each other
 // (i.e. rgb2yuv and yuv2rgb
 DEF_TEST(YUVMath, reporter) {
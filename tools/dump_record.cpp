@@ -165,11 +165,12 @@ int main(int argc, char** argv) {
         SkRecorder rec(&record, w, h);
         src->playback(&rec);
 
+        SkRecordOptimizeStats stats;
         if (FLAGS_optimize) {
-            SkRecordOptimize(&record);
+            SkRecordOptimize(&record, &stats);
         }
         if (FLAGS_optimize2) {
-            SkRecordOptimize2(&record);
+            SkRecordOptimize2(&record, &stats);
         }
 
         SkBitmap bitmap;
@@ -179,6 +180,13 @@ int main(int argc, char** argv) {
                                        SkIntToScalar(FLAGS_tile)));
 
         printf("%s %s\n", FLAGS_optimize ? "optimized" : "not-optimized", FLAGS_skps[i]);
+        if (FLAGS_optimize || FLAGS_optimize2) {
+            printf("removed %d save/restores, %d layers, %d occluded draws, %d matrices; "
+                   "merged %d SVG layers, %d image rects\n",
+                   stats.fNoopSaveRestores, stats.fNoopSaveLayerDrawRestores,
+                   stats.fOccludedDraws, stats.fMultipleSetMatrices,
+                   stats.fMergedSvgOpacityLayers, stats.fMergedImageRects);
+        }
 
         Dumper dumper(&canvas, record.count());
         for (int j = 0; j < record.count(); j++) {
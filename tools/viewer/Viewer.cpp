@@ -2706,8 +2706,9 @@ void Viewer::drawImGui() {
                 // First, go through the cache and restore the original program if we were hovering
                 if (!fHoveredProgram.empty()) {
                     auto restoreHoveredProgram = [this](const SkVMBlitter::Key* key,
-                                                        skvm::Program* program) {
+                                                        sk_sp<SkVMBlitter::CachedProgram>* cached) {
                         if (*key == fHoveredKey) {
+                            skvm::Program* program = (*cached)->program();
                             *program = std::move(fHoveredProgram);
                             fHoveredProgram = {};
                         }
@@ -2717,7 +2718,9 @@ void Viewer::drawImGui() {
 
                 // Now iterate again, and dump any expanded program. If any program is hovered,
                 // patch it, and remember the original (so it can be restored next frame).
-                auto showVMEntry = [this](const SkVMBlitter::Key* key, skvm::Program* program) {
+                auto showVMEntry = [this](const SkVMBlitter::Key* key,
+                                          sk_sp<SkVMBlitter::CachedProgram>* cached) {
+                    skvm::Program* program = (*cached)->program();
                     SkString keyString = SkVMBlitter::DebugName(*key);
                     bool inTreeNode = ImGui::TreeNode(keyString.c_str());
                     bool hovered = ImGui::IsItemHovered();